@@ -185,3 +185,98 @@ target_compile_definitions (apostellein PRIVATE
 	"-DGLM_FORCE_XYZW_ONLY"
 	"-DIMGUI_IMPL_OPENGL_LOADER_CUSTOM"
 )
+
+# Field compiler
+if (APOSTELLEIN_FIELD_COMPILER)
+	if (WIN32)
+		target_compile_definitions (apostellein-fieldc PRIVATE
+			"-D_CRT_SECURE_NO_WARNINGS"
+			"-DNOMINMAX"
+		)
+	endif ()
+	if (EXISTS "${CMAKE_BINARY_DIR}/conanbuildinfo.cmake")
+		target_compile_definitions (apostellein-fieldc PRIVATE ${CONAN_DEFINES})
+		target_include_directories (apostellein-fieldc PRIVATE ${CONAN_INCLUDE_DIRS})
+		target_link_directories (apostellein-fieldc PRIVATE ${CONAN_LIB_DIRS})
+		target_link_libraries (apostellein-fieldc PRIVATE ${CONAN_LIBS})
+	else ()
+		target_link_libraries (apostellein-fieldc PRIVATE
+			fmt::fmt-header-only
+			spdlog::spdlog_header_only
+			glm::glm
+			EnTT::EnTT
+		)
+	endif ()
+	target_include_directories (apostellein-fieldc PRIVATE "${PROJECT_SOURCE_DIR}/lib/inc")
+	target_compile_definitions (apostellein-fieldc PRIVATE "-DGLM_FORCE_XYZW_ONLY")
+endif ()
+
+# Animation compiler
+if (APOSTELLEIN_ANIMATION_COMPILER)
+	if (WIN32)
+		target_compile_definitions (apostellein-animc PRIVATE
+			"-D_CRT_SECURE_NO_WARNINGS"
+			"-DNOMINMAX"
+		)
+	endif ()
+	if (EXISTS "${CMAKE_BINARY_DIR}/conanbuildinfo.cmake")
+		target_compile_definitions (apostellein-animc PRIVATE ${CONAN_DEFINES})
+		target_include_directories (apostellein-animc PRIVATE ${CONAN_INCLUDE_DIRS})
+		target_link_directories (apostellein-animc PRIVATE ${CONAN_LIB_DIRS})
+		target_link_libraries (apostellein-animc PRIVATE ${CONAN_LIBS})
+	else ()
+		target_link_libraries (apostellein-animc PRIVATE
+			fmt::fmt-header-only
+			spdlog::spdlog_header_only
+			glm::glm
+			nlohmann_json::nlohmann_json
+			EnTT::EnTT
+		)
+	endif ()
+	target_include_directories (apostellein-animc PRIVATE "${PROJECT_SOURCE_DIR}/lib/inc")
+	target_compile_definitions (apostellein-animc PRIVATE "-DGLM_FORCE_XYZW_ONLY")
+endif ()
+
+# Script compiler
+if (APOSTELLEIN_SCRIPT_COMPILER)
+	if (WIN32)
+		target_compile_definitions (apostellein-luac PRIVATE
+			"-D_CRT_SECURE_NO_WARNINGS"
+			"-DNOMINMAX"
+		)
+	elseif (NOT APPLE)
+		target_link_libraries (apostellein-luac PRIVATE "${CMAKE_DL_LIBS}" m)
+	endif ()
+	if (EXISTS "${CMAKE_BINARY_DIR}/conanbuildinfo.cmake")
+		target_compile_definitions (apostellein-luac PRIVATE ${CONAN_DEFINES})
+		target_include_directories (apostellein-luac PRIVATE ${CONAN_INCLUDE_DIRS})
+		target_link_directories (apostellein-luac PRIVATE ${CONAN_LIB_DIRS})
+		target_link_libraries (apostellein-luac PRIVATE ${CONAN_LIBS})
+	else ()
+		target_link_libraries (apostellein-luac PRIVATE
+			fmt::fmt-header-only
+			spdlog::spdlog_header_only
+			"${LUA_LIBRARIES}"
+		)
+		target_include_directories (apostellein-luac PRIVATE "${LUA_INCLUDE_DIR}")
+	endif ()
+	target_include_directories (apostellein-luac PRIVATE "${PROJECT_SOURCE_DIR}/lib/inc")
+endif ()
+
+# Benchmark suite
+if (APOSTELLEIN_BENCHMARK_SUITE)
+	# builds the same sources as the game, so it takes on all of its settings
+	foreach (PROPERTY_NAME COMPILE_DEFINITIONS COMPILE_OPTIONS INCLUDE_DIRECTORIES LINK_DIRECTORIES LINK_LIBRARIES)
+		get_target_property (PROPERTY_VALUE apostellein ${PROPERTY_NAME})
+		if (PROPERTY_VALUE)
+			set_property (TARGET apostellein-bench PROPERTY ${PROPERTY_NAME} ${PROPERTY_VALUE})
+		endif ()
+	endforeach ()
+	# except for the windows subsystem, since this is a console program
+	if (NOT MSVC)
+		get_target_property (PROPERTY_VALUE apostellein LINK_OPTIONS)
+		if (PROPERTY_VALUE)
+			set_property (TARGET apostellein-bench PROPERTY LINK_OPTIONS ${PROPERTY_VALUE})
+		endif ()
+	endif ()
+endif ()
@@ -40,20 +40,6 @@ namespace konst {
 		return static_cast<r32>(value * konst::TILE<i32>());
 	}
 
-	// interpolate
-	template<typename T>
-	inline glm::vec<2, T, glm::packed_highp> INTERPOLATE(
-		const glm::vec<2, T, glm::packed_highp>& back,
-		const glm::vec<2, T, glm::packed_highp>& front,
-		const T& ratio
-	) {
-		static_assert(std::is_floating_point<T>::value);
-		if (back == front or glm::distance(back, front) >= TILE<T>()) {
-			return front;
-		}
-		return glm::mix(back, front, ratio);
-	}
-
 	// seconds
 	template<typename T>
 	constexpr T ZERO() noexcept { return static_cast<T>(0); }
@@ -87,12 +87,12 @@ static void fire_ctor(entt::entity s, environment& env) {
 APOSTELLEIN_THINKER_TABLE(common) {
 	APOSTELLEIN_THINKER_ENTRY(ai::null, null_ctor);
 	APOSTELLEIN_THINKER_ENTRY(ai::hv_trigger, hv_trigger_ctor);
-	APOSTELLEIN_THINKER_ENTRY(ai::full_chest, full_chest_ctor);
-	APOSTELLEIN_THINKER_ENTRY(ai::empty_chest, empty_chest_ctor);
-	APOSTELLEIN_THINKER_ENTRY(ai::door, door_ctor);
-	APOSTELLEIN_THINKER_ENTRY(ai::spikes, spikes_ctor);
-	APOSTELLEIN_THINKER_ENTRY(ai::bed, bed_ctor);
-	APOSTELLEIN_THINKER_ENTRY(ai::ammo_station, ammo_station_ctor);
-	APOSTELLEIN_THINKER_ENTRY(ai::computer, computer_ctor);
-	APOSTELLEIN_THINKER_ENTRY(ai::fire, fire_ctor);
+	APOSTELLEIN_THINKER_SPRITE(ai::full_chest, full_chest_ctor, anim::Chest);
+	APOSTELLEIN_THINKER_SPRITE(ai::empty_chest, empty_chest_ctor, anim::Chest);
+	APOSTELLEIN_THINKER_SPRITE(ai::door, door_ctor, anim::Door);
+	APOSTELLEIN_THINKER_SPRITE(ai::spikes, spikes_ctor, anim::Death);
+	APOSTELLEIN_THINKER_SPRITE(ai::bed, bed_ctor, anim::Helpful);
+	APOSTELLEIN_THINKER_SPRITE(ai::ammo_station, ammo_station_ctor, anim::Helpful);
+	APOSTELLEIN_THINKER_SPRITE(ai::computer, computer_ctor, anim::Computer);
+	APOSTELLEIN_THINKER_SPRITE(ai::fire, fire_ctor, anim::Fireplace);
 }
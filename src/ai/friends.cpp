@@ -38,11 +38,6 @@ namespace {
 	};
 }
 
-struct shoshi_state {
-	bool augment {};
-	bool facing_left {};
-};
-
 static bool test_shoshi_sprite_mirroring(mirror_type mirroring, bool facing_left) {
 	return (
 		(!mirroring and !facing_left) or
@@ -220,7 +215,7 @@ static void accompanied_shoshi_ctor(entt::entity s, environment& env) {
 // Tables
 
 APOSTELLEIN_THINKER_TABLE(shoshi) {
-	APOSTELLEIN_THINKER_ENTRY(ai::shoshi, shoshi_ctor);
-	APOSTELLEIN_THINKER_ENTRY(ai::carried_shoshi, carried_shoshi_ctor);
-	APOSTELLEIN_THINKER_ENTRY(ai::accompanied_shoshi, accompanied_shoshi_ctor);
+	APOSTELLEIN_THINKER_SPRITE(ai::shoshi, shoshi_ctor, anim::Shoshi);
+	APOSTELLEIN_THINKER_SPRITE(ai::carried_shoshi, carried_shoshi_ctor, anim::Shoshi);
+	APOSTELLEIN_THINKER_SPRITE(ai::accompanied_shoshi, accompanied_shoshi_ctor, anim::Shoshi);
 }
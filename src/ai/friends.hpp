@@ -12,3 +12,9 @@ namespace ai {
 	constexpr entt::hashed_string carried_shoshi = "carried-shoshi";
 	constexpr entt::hashed_string accompanied_shoshi = "accompanied-shoshi";
 }
+
+// shared so environment snapshots can carry it
+struct shoshi_state {
+	bool augment {};
+	bool facing_left {};
+};
@@ -29,5 +29,5 @@ static void ghost_ctor(entt::entity s, environment& env) {
 // Tables
 
 APOSTELLEIN_THINKER_TABLE(ghost) {
-	APOSTELLEIN_THINKER_ENTRY(ai::ghost, ghost_ctor);
+	APOSTELLEIN_THINKER_SPRITE(ai::ghost, ghost_ctor, anim::Ghost);
 }
@@ -106,6 +106,6 @@ static void arm_ctor(entt::entity s, environment& env) {
 }
 
 APOSTELLEIN_THINKER_TABLE(weapon) {
-	APOSTELLEIN_THINKER_ENTRY(ai::hand, hand_ctor);
-	APOSTELLEIN_THINKER_ENTRY(ai::arm, arm_ctor);
+	APOSTELLEIN_THINKER_SPRITE(ai::hand, hand_ctor, anim::ArmHand);
+	APOSTELLEIN_THINKER_SPRITE(ai::arm, arm_ctor, anim::ArmHand);
 }
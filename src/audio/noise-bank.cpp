@@ -0,0 +1,42 @@
+#include <vector>
+#include <SDL2/SDL_audio.h>
+#include <apostellein/cast.hpp>
+
+#include "./noise-bank.hpp"
+#include "./noise-buffer.hpp"
+#include "./openal.hpp"
+#include "../hw/audio.hpp"
+#include "../util/bank-file.hpp"
+
+udx noise_bank::upload(const bank_file& bank, tracked_unordered_map<entt::id_type, noise_buffer, memory_tag::noises>& noises) {
+	auto& entries = bank.entries();
+	if (entries.empty()) {
+		return 0;
+	}
+	// Generate every handle at once, then copy straight out of the blob
+	std::vector<u32> handles(entries.size(), 0);
+	const bool mixing = audio::mixer() != nullptr;
+	if (!mixing) {
+		alCheck(alGenBuffers(as<i32>(handles.size()), handles.data()));
+	}
+	udx result = 0;
+	for (udx idx = 0; idx < entries.size(); ++idx) {
+		auto& entry = entries[idx];
+		auto& ref = noises[entry.id];
+		if (ref.valid()) {
+			if (!mixing) {
+				alCheck(alDeleteBuffers(1, &handles[idx]));
+			}
+			continue;
+		}
+		ref.destroy();
+		// baked pcm is either unsigned 8-bit or little-endian 16-bit, like the wave it came from
+		SDL_AudioSpec spec {};
+		spec.format = entry.bits == 8 ? AUDIO_U8 : AUDIO_S16LSB;
+		spec.channels = as<byte>(entry.channels);
+		spec.freq = entry.frequency;
+		ref.adopt_(handles[idx], bank.pcm(entry), entry.length, spec);
+		++result;
+	}
+	return result;
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <entt/core/fwd.hpp>
+#include <apostellein/def.hpp>
+
+#include "../util/memory-tracker.hpp"
+
+struct bank_file;
+struct noise_buffer;
+
+// Hands every noise in a bank to its buffer in one batch
+struct noise_bank {
+public:
+	static udx upload(const bank_file& bank, tracked_unordered_map<entt::id_type, noise_buffer, memory_tag::noises>& noises);
+};
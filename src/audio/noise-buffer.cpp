@@ -1,11 +1,18 @@
+#include <glm/common.hpp>
 #include <spdlog/spdlog.h>
 #include <SDL2/SDL_audio.h>
+#include <apostellein/cast.hpp>
 
 #include "./noise-buffer.hpp"
 #include "./openal.hpp"
 #include "./speaker.hpp"
+#include "./software-mixer.hpp"
+#include "../hw/audio.hpp"
+#include "../util/memory-tracker.hpp"
 
 namespace {
+	constexpr udx ENVELOPE_WINDOW = 512;
+
 	i32 format_from_spec_(const SDL_AudioSpec* spec) {
 		if (spec->channels == 1) {
 			if (spec->format == AUDIO_U8 or spec->format == AUDIO_S8) {
@@ -21,6 +28,55 @@ namespace {
 			}
 		}
 	}
+
+	// Peaks are cheap to take once at load time, and let voice stealing
+	// compare what's audible instead of what was requested
+	std::vector<r32> envelope_from_spec_(const byte* data, u32 length, const SDL_AudioSpec& spec) {
+		const udx width = SDL_AUDIO_BITSIZE(spec.format) / 8;
+		const udx channels = glm::max<udx>(spec.channels, 1);
+		if (width != 1 and width != 2) {
+			return {};
+		}
+		const udx frames = length / (width * channels);
+		std::vector<r32> result((frames + ENVELOPE_WINDOW - 1) / ENVELOPE_WINDOW);
+		for (udx frame = 0; frame < frames; ++frame) {
+			auto& peak = result[frame / ENVELOPE_WINDOW];
+			for (udx channel = 0; channel < channels; ++channel) {
+				const byte* sample = data + (frame * channels + channel) * width;
+				r32 value = 0.0f;
+				if (width == 2) {
+					value = as<r32>(as<i16>(sample[0] | (sample[1] << 8))) / 32768.0f;
+				} else if (spec.format == AUDIO_U8) {
+					value = (as<r32>(sample[0]) - 128.0f) / 128.0f;
+				} else {
+					value = as<r32>(static_cast<signed char>(sample[0])) / 128.0f;
+				}
+				peak = glm::max(peak, glm::abs(value));
+			}
+		}
+		return result;
+	}
+
+	std::vector<r32> envelope_from_samples_(const std::vector<i16>& samples) {
+		constexpr udx CHANNELS = software_mixer::CHANNELS;
+		const udx frames = samples.size() / CHANNELS;
+		std::vector<r32> result((frames + ENVELOPE_WINDOW - 1) / ENVELOPE_WINDOW);
+		for (udx idx = 0; idx < frames * CHANNELS; ++idx) {
+			auto& peak = result[idx / CHANNELS / ENVELOPE_WINDOW];
+			peak = glm::max(peak, glm::abs(as<r32>(samples[idx]) / 32768.0f));
+		}
+		return result;
+	}
+}
+
+r32 noise_buffer::level(udx frame) const {
+	if (envelope_.empty()) {
+		return 1.0f;
+	}
+	if (const udx index = frame / ENVELOPE_WINDOW; index < envelope_.size()) {
+		return envelope_[index];
+	}
+	return 0.0f;
 }
 
 void noise_buffer::load(const std::string& path) {
@@ -28,7 +84,7 @@ void noise_buffer::load(const std::string& path) {
 		spdlog::critical("Noise buffer was almost overwritten by {}!", path);
 		return;
 	}
-	if (!handle_) {
+	if (!handle_ and !audio::mixer()) {
 		alCheck(alGenBuffers(1, &handle_));
 	}
 	byte* data = nullptr;
@@ -38,6 +94,22 @@ void noise_buffer::load(const std::string& path) {
 		spdlog::error("Failed to load noise from \"{}\"! SDL Error: {}", path, SDL_GetError());
 		return;
 	}
+	this->adopt_(handle_, data, length, spec);
+	SDL_FreeWAV(data);
+}
+
+void noise_buffer::adopt_(u32 handle, const byte* data, u32 length, const SDL_AudioSpec& spec) {
+	if (auto mixer = audio::mixer(); mixer) {
+		// software mixer keeps pcm resident in its output format
+		samples_ = mixer->convert(data, length, spec);
+		// voice cursors count converted frames, so measure those
+		envelope_ = envelope_from_samples_(samples_);
+		memory_tracker::acquire(memory_tag::noises, samples_.size() * sizeof(i16));
+		ready_ = !samples_.empty();
+		return;
+	}
+	handle_ = handle;
+	envelope_ = envelope_from_spec_(data, length, spec);
 	alCheck(alBufferData(
 		handle_,
 		format_from_spec_(&spec),
@@ -45,12 +117,23 @@ void noise_buffer::load(const std::string& path) {
 		length,
 		spec.freq
 	));
-	SDL_FreeWAV(data);
+	// the driver's copy isn't visible to us, so this is only an estimate
+	resident_ = length;
+	memory_tracker::acquire(memory_tag::sounds, resident_);
 	ready_ = true;
 }
 
 void noise_buffer::destroy() {
 	ready_ = false;
+	envelope_.clear();
+	if (!samples_.empty()) {
+		memory_tracker::release(memory_tag::noises, samples_.size() * sizeof(i16));
+		samples_.clear();
+	}
+	if (resident_ > 0) {
+		memory_tracker::release(memory_tag::sounds, resident_);
+		resident_ = 0;
+	}
 	if (handle_ != 0) {
 		// There should no longer be any bound speakers
 		alCheck(alDeleteBuffers(1, &handle_));
@@ -1,9 +1,12 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include <apostellein/struct.hpp>
 
+struct SDL_AudioSpec;
 struct speaker;
+struct noise_bank;
 
 struct noise_buffer : public not_copyable {
 	noise_buffer() noexcept = default;
@@ -16,6 +19,12 @@ struct noise_buffer : public not_copyable {
 			that.ready_ = false;
 			handle_ = that.handle_;
 			that.handle_ = 0;
+			resident_ = that.resident_;
+			that.resident_ = 0;
+			samples_ = std::move(that.samples_);
+			that.samples_.clear();
+			envelope_ = std::move(that.envelope_);
+			that.envelope_.clear();
 		}
 		return *this;
 	}
@@ -24,8 +33,15 @@ public:
 	void load(const std::string& path);
 	void destroy();
 	bool valid() const { return ready_; }
+	// peak amplitude around a frame, from zero to one
+	r32 level(udx frame) const;
 private:
 	friend struct speaker;
+	friend struct noise_bank;
+	void adopt_(u32 handle, const byte* data, u32 length, const SDL_AudioSpec& spec);
 	bool ready_ {};
 	u32 handle_ {};
+	udx resident_ {};
+	std::vector<i16> samples_ {};
+	std::vector<r32> envelope_ {};
 };
@@ -0,0 +1,308 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <spdlog/spdlog.h>
+#include <SDL2/SDL.h>
+#include <glm/common.hpp>
+#include <apostellein/cast.hpp>
+
+#include "./software-mixer.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define APOSTELLEIN_MIXER_SSE2
+#endif
+
+namespace {
+	constexpr udx DEVICE_FRAMES = 1024;
+	constexpr r64 STREAM_SECONDS = 3.0;
+	constexpr r32 MINIMUM_SAMPLE = -32768.0f;
+	constexpr r32 MAXIMUM_SAMPLE = 32767.0f;
+	constexpr udx WAVE_HEADER_SIZE = 44;
+
+	void device_callback_(void* user, Uint8* stream, i32 length) {
+		auto mixer = reinterpret_cast<software_mixer*>(user);
+		const auto frames = as<udx>(length) / (sizeof(i16) * software_mixer::CHANNELS);
+		mixer->mix(reinterpret_cast<i16*>(stream), frames);
+	}
+
+	void write_wave_header_(std::ofstream& file, i32 sampling_rate, udx bytes) {
+		auto put = [&file](auto value) {
+			file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+		};
+		const u16 block = as<u16>(software_mixer::CHANNELS * sizeof(i16));
+		file.seekp(0);
+		file.write("RIFF", 4);
+		put(as<u32>(bytes + WAVE_HEADER_SIZE - 8));
+		file.write("WAVEfmt ", 8);
+		put(u32{ 16 });
+		put(u16{ 1 });
+		put(as<u16>(software_mixer::CHANNELS));
+		put(as<u32>(sampling_rate));
+		put(as<u32>(sampling_rate) * block);
+		put(block);
+		put(as<u16>(sizeof(i16) * 8));
+		file.write("data", 4);
+		put(as<u32>(bytes));
+	}
+}
+
+bool software_mixer::create(mixer_sink sink, i32 sampling_rate, const std::string& path) {
+	this->destroy();
+	sink_ = sink;
+	sampling_rate_ = sampling_rate;
+	voices_.assign(MAXIMUM_VOICES, mixer_voice{});
+	accumulator_.resize(DEVICE_FRAMES * CHANNELS);
+	stream_.assign(as<udx>(as<r64>(sampling_rate_) * STREAM_SECONDS) * CHANNELS, 0);
+	stream_first_ = 0;
+	stream_count_ = 0;
+
+	switch (sink_) {
+	case mixer_sink::device: {
+		if (SDL_InitSubSystem(SDL_INIT_AUDIO) < 0) {
+			spdlog::critical("SDL audio initialization failed! SDL Error: {}", SDL_GetError());
+			return false;
+		}
+		SDL_AudioSpec desired {};
+		desired.freq = sampling_rate_;
+		desired.format = AUDIO_S16SYS;
+		desired.channels = as<u8>(CHANNELS);
+		desired.samples = as<u16>(DEVICE_FRAMES);
+		desired.callback = device_callback_;
+		desired.userdata = this;
+		SDL_AudioSpec obtained {};
+		if (device_ = SDL_OpenAudioDevice(nullptr, 0, &desired, &obtained, 0); device_ == 0) {
+			spdlog::critical("Mixer device creation failed! SDL Error: {}", SDL_GetError());
+			SDL_QuitSubSystem(SDL_INIT_AUDIO);
+			return false;
+		}
+		running_ = true;
+		SDL_PauseAudioDevice(device_, 0);
+		break;
+	}
+	case mixer_sink::file:
+		file_.open(path, std::ios::binary | std::ios::trunc);
+		if (!file_.is_open()) {
+			spdlog::critical("Mixer capture file \"{}\" couldn't be opened!", path);
+			return false;
+		}
+		write_wave_header_(file_, sampling_rate_, 0);
+		written_ = 0;
+		[[fallthrough]];
+	case mixer_sink::null:
+		running_ = true;
+		thread_ = std::thread(&software_mixer::pump_, this);
+		break;
+	}
+	return true;
+}
+
+void software_mixer::destroy() {
+	if (device_ != 0) {
+		SDL_CloseAudioDevice(device_);
+		SDL_QuitSubSystem(SDL_INIT_AUDIO);
+		device_ = 0;
+	}
+	running_ = false;
+	if (thread_.joinable()) {
+		thread_.join();
+	}
+	if (file_.is_open()) {
+		write_wave_header_(file_, sampling_rate_, written_);
+		file_.close();
+		written_ = 0;
+	}
+	voices_.clear();
+	accumulator_.clear();
+	stream_.clear();
+}
+
+udx software_mixer::acquire() {
+	const auto guard = this->lock();
+	for (udx idx = 0; idx < voices_.size(); ++idx) {
+		if (!voices_[idx].acquired) {
+			voices_[idx] = {};
+			voices_[idx].acquired = true;
+			return idx + 1;
+		}
+	}
+	spdlog::error("Software mixer ran out of voices!");
+	return 0;
+}
+
+void software_mixer::release(udx index) {
+	const auto guard = this->lock();
+	if (index > 0 and index <= voices_.size()) {
+		voices_[index - 1] = {};
+	}
+}
+
+mixer_voice* software_mixer::voice(udx index) {
+	if (index > 0 and index <= voices_.size()) {
+		return &voices_[index - 1];
+	}
+	return nullptr;
+}
+
+std::vector<i16> software_mixer::convert(const byte* data, u32 length, const SDL_AudioSpec& spec) const {
+	SDL_AudioCVT cvt {};
+	const i32 status = SDL_BuildAudioCVT(
+		&cvt,
+		spec.format, spec.channels, spec.freq,
+		AUDIO_S16SYS, as<u8>(CHANNELS), sampling_rate_
+	);
+	if (status < 0) {
+		spdlog::error("Noise conversion failed! SDL Error: {}", SDL_GetError());
+		return {};
+	}
+	std::vector<byte> buffer(as<udx>(length) * as<udx>(glm::max(cvt.len_mult, 1)));
+	std::memcpy(buffer.data(), data, length);
+	cvt.buf = buffer.data();
+	cvt.len = as<i32>(length);
+	if (status > 0 and SDL_ConvertAudio(&cvt) < 0) {
+		spdlog::error("Noise conversion failed! SDL Error: {}", SDL_GetError());
+		return {};
+	}
+	const auto bytes = status > 0 ? as<udx>(cvt.len_cvt) : as<udx>(length);
+	std::vector<i16> result(bytes / sizeof(i16));
+	std::memcpy(result.data(), buffer.data(), result.size() * sizeof(i16));
+	return result;
+}
+
+udx software_mixer::streamed() {
+	const auto guard = this->lock();
+	return stream_count_;
+}
+
+void software_mixer::stream(const i16* samples, udx frames) {
+	const auto guard = this->lock();
+	const udx capacity = stream_.size() / CHANNELS;
+	frames = glm::min(frames, capacity - stream_count_);
+	for (udx it = 0; it < frames; ++it) {
+		const udx slot = (stream_first_ + stream_count_ + it) % capacity;
+		stream_[slot * CHANNELS] = samples[it * CHANNELS];
+		stream_[slot * CHANNELS + 1] = samples[it * CHANNELS + 1];
+	}
+	stream_count_ += frames;
+}
+
+void software_mixer::discard() {
+	const auto guard = this->lock();
+	stream_first_ = 0;
+	stream_count_ = 0;
+}
+
+void software_mixer::mix(i16* output, udx frames) {
+	const auto guard = this->lock();
+	while (frames > 0) {
+		const udx count = glm::min(frames, DEVICE_FRAMES);
+		this->mix_(output, count);
+		output += count * CHANNELS;
+		frames -= count;
+	}
+}
+
+void software_mixer::accumulate(const i16* input, r32 left, r32 right, r32* output, udx frames) {
+	const udx total = frames * CHANNELS;
+	udx idx = 0;
+#if defined(APOSTELLEIN_MIXER_SSE2)
+	const __m128 gains = _mm_setr_ps(left, right, left, right);
+	for (; idx + 8 <= total; idx += 8) {
+		const __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + idx));
+		// sign-extend int16 -> int32 by duplicating & shifting back down
+		const __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(packed, packed), 16);
+		const __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(packed, packed), 16);
+		const __m128 first = _mm_add_ps(
+			_mm_loadu_ps(output + idx),
+			_mm_mul_ps(_mm_cvtepi32_ps(low), gains)
+		);
+		const __m128 second = _mm_add_ps(
+			_mm_loadu_ps(output + idx + 4),
+			_mm_mul_ps(_mm_cvtepi32_ps(high), gains)
+		);
+		_mm_storeu_ps(output + idx, first);
+		_mm_storeu_ps(output + idx + 4, second);
+	}
+#endif
+	for (; idx < total; idx += CHANNELS) {
+		output[idx] += as<r32>(input[idx]) * left;
+		output[idx + 1] += as<r32>(input[idx + 1]) * right;
+	}
+}
+
+void software_mixer::resolve(const r32* input, i16* output, udx frames) {
+	const udx total = frames * CHANNELS;
+	udx idx = 0;
+#if defined(APOSTELLEIN_MIXER_SSE2)
+	const __m128 minimum = _mm_set1_ps(MINIMUM_SAMPLE);
+	const __m128 maximum = _mm_set1_ps(MAXIMUM_SAMPLE);
+	for (; idx + 8 <= total; idx += 8) {
+		const __m128 first = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(input + idx), minimum), maximum);
+		const __m128 second = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(input + idx + 4), minimum), maximum);
+		const __m128i packed = _mm_packs_epi32(_mm_cvtps_epi32(first), _mm_cvtps_epi32(second));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(output + idx), packed);
+	}
+#endif
+	// lrint rounds to nearest like _mm_cvtps_epi32 does, so the tail matches the batch
+	for (; idx < total; ++idx) {
+		output[idx] = as<i16>(std::lrint(glm::clamp(input[idx], MINIMUM_SAMPLE, MAXIMUM_SAMPLE)));
+	}
+}
+
+void software_mixer::mix_(i16* output, udx frames) {
+	std::fill_n(accumulator_.data(), frames * CHANNELS, 0.0f);
+	for (auto&& voice : voices_) {
+		if (!voice.playing or voice.paused or !voice.samples) {
+			continue;
+		}
+		const udx count = glm::min(frames, voice.frames - voice.cursor);
+		software_mixer::accumulate(
+			voice.samples + voice.cursor * CHANNELS,
+			voice.gain, voice.gain,
+			accumulator_.data(),
+			count
+		);
+		if (voice.cursor += count; voice.cursor >= voice.frames) {
+			voice.cursor = 0;
+			voice.playing = false;
+		}
+	}
+	// music stream wraps around the ring, so it's mixed in two pieces at most
+	const udx capacity = stream_.size() / CHANNELS;
+	udx remaining = glm::min(frames, stream_count_);
+	udx offset = 0;
+	while (remaining > 0) {
+		const udx count = glm::min(remaining, capacity - stream_first_);
+		software_mixer::accumulate(
+			stream_.data() + stream_first_ * CHANNELS,
+			1.0f, 1.0f,
+			accumulator_.data() + offset * CHANNELS,
+			count
+		);
+		stream_first_ = (stream_first_ + count) % capacity;
+		stream_count_ -= count;
+		offset += count;
+		remaining -= count;
+	}
+	software_mixer::resolve(accumulator_.data(), output, frames);
+}
+
+void software_mixer::pump_() {
+	// null & file sinks pace themselves like a device would
+	std::vector<i16> buffer(DEVICE_FRAMES * CHANNELS);
+	const std::chrono::nanoseconds period {
+		as<i64>(1.0e9 * as<r64>(DEVICE_FRAMES) / as<r64>(sampling_rate_))
+	};
+	auto deadline = std::chrono::steady_clock::now();
+	while (running_) {
+		this->mix(buffer.data(), DEVICE_FRAMES);
+		if (file_.is_open()) {
+			const auto bytes = buffer.size() * sizeof(i16);
+			file_.write(reinterpret_cast<const char*>(buffer.data()), as<std::streamsize>(bytes));
+			written_ += bytes;
+		}
+		deadline += period;
+		std::this_thread::sleep_until(deadline);
+	}
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <fstream>
+#include <apostellein/struct.hpp>
+
+struct SDL_AudioSpec;
+
+enum class mixer_sink {
+	device,
+	file,
+	null
+};
+
+struct mixer_voice {
+	const i16* samples {};
+	udx frames {};
+	udx cursor {};
+	r32 gain { 1.0f };
+	bool acquired {};
+	bool playing {};
+	bool paused {};
+};
+
+struct software_mixer : public not_copyable {
+	software_mixer() noexcept = default;
+	~software_mixer() { this->destroy(); }
+public:
+	static constexpr i32 CHANNELS = 2;
+	static constexpr udx MAXIMUM_VOICES = 64;
+	bool create(mixer_sink sink, i32 sampling_rate, const std::string& path);
+	void destroy();
+	udx acquire();
+	void release(udx index);
+	mixer_voice* voice(udx index);
+	std::unique_lock<std::mutex> lock() { return std::unique_lock<std::mutex>{ mutex_ }; }
+	std::vector<i16> convert(const byte* data, u32 length, const SDL_AudioSpec& spec) const;
+	udx streamed();
+	void stream(const i16* samples, udx frames);
+	void discard();
+	void mix(i16* output, udx frames);
+	i32 sampling_rate() const { return sampling_rate_; }
+	bool valid() const { return running_; }
+	// interleaved stereo kernels
+	static void accumulate(const i16* input, r32 left, r32 right, r32* output, udx frames);
+	static void resolve(const r32* input, i16* output, udx frames);
+private:
+	void mix_(i16* output, udx frames);
+	void pump_();
+	mixer_sink sink_ {};
+	std::mutex mutex_ {};
+	std::thread thread_ {};
+	std::atomic<bool> running_ {};
+	std::vector<mixer_voice> voices_ {};
+	std::vector<r32> accumulator_ {};
+	std::vector<i16> stream_ {};
+	udx stream_first_ {};
+	udx stream_count_ {};
+	std::ofstream file_ {};
+	udx written_ {};
+	u32 device_ {};
+	i32 sampling_rate_ {};
+};
@@ -1,20 +1,32 @@
+#include <glm/common.hpp>
 #include <spdlog/spdlog.h>
+#include <apostellein/cast.hpp>
 
 #include "./speaker.hpp"
 #include "./noise-buffer.hpp"
 #include "./openal.hpp"
+#include "./software-mixer.hpp"
+#include "../hw/audio.hpp"
 
 void speaker::create() {
 	this->destroy();
 	if (!handle_) {
-		alCheck(alGenSources(1, &handle_));
+		if (auto mixer = audio::mixer(); mixer) {
+			handle_ = as<u32>(mixer->acquire());
+		} else {
+			alCheck(alGenSources(1, &handle_));
+		}
 	}
 }
 
 void speaker::destroy() {
 	this->unbind();
 	if (handle_ != 0) {
-		alCheck(alDeleteSources(1, &handle_));
+		if (auto mixer = audio::mixer(); mixer) {
+			mixer->release(handle_);
+		} else {
+			alCheck(alDeleteSources(1, &handle_));
+		}
 		handle_ = 0;
 	}
 }
@@ -25,10 +37,28 @@ bool speaker::bind(const noise_buffer* noise) {
 	}
 	if (!ready_ or current_ != noise) {
 		this->stop();
+	}
+	return this->attach(noise);
+}
+
+bool speaker::attach(const noise_buffer* noise) {
+	// source must already be stopped
+	if (!handle_) {
+		return false;
+	}
+	if (!ready_ or current_ != noise) {
 		if (noise and noise->ready_) {
 			ready_ = true;
 			current_ = noise;
-			alCheck(alSourcei(handle_, AL_BUFFER, noise->handle_));
+			if (auto mixer = audio::mixer(); mixer) {
+				const auto guard = mixer->lock();
+				auto voice = mixer->voice(handle_);
+				voice->samples = noise->samples_.data();
+				voice->frames = noise->samples_.size() / software_mixer::CHANNELS;
+				voice->cursor = 0;
+			} else {
+				alCheck(alSourcei(handle_, AL_BUFFER, noise->handle_));
+			}
 		} else {
 			ready_ = false;
 		}
@@ -41,27 +71,64 @@ void speaker::unbind() {
 		this->stop();
 		ready_ = false;
 		current_ = nullptr;
-		alCheck(alSourcei(handle_, AL_BUFFER, 0));
+		if (auto mixer = audio::mixer(); mixer) {
+			const auto guard = mixer->lock();
+			auto voice = mixer->voice(handle_);
+			voice->samples = nullptr;
+			voice->frames = 0;
+		} else {
+			alCheck(alSourcei(handle_, AL_BUFFER, 0));
+		}
 	}
 }
 
 void speaker::volume(r32 value) {
 	if (handle_ != 0) {
-		alCheck(alSourcef(handle_, AL_GAIN, value));
+		if (auto mixer = audio::mixer(); mixer) {
+			const auto guard = mixer->lock();
+			mixer->voice(handle_)->gain = value;
+		} else {
+			alCheck(alSourcef(handle_, AL_GAIN, value));
+		}
 	}
 }
 
 r32 speaker::volume() const {
 	r32 result = 0.0f;
 	if (handle_) {
-		alCheck(alGetSourcef(handle_, AL_GAIN, &result));
+		if (auto mixer = audio::mixer(); mixer) {
+			const auto guard = mixer->lock();
+			result = mixer->voice(handle_)->gain;
+		} else {
+			alCheck(alGetSourcef(handle_, AL_GAIN, &result));
+		}
+	}
+	return result;
+}
+
+udx speaker::offset() const {
+	udx result = 0;
+	if (handle_) {
+		if (auto mixer = audio::mixer(); mixer) {
+			const auto guard = mixer->lock();
+			result = mixer->voice(handle_)->cursor;
+		} else {
+			i32 frame = 0;
+			alCheck(alGetSourcei(handle_, AL_SAMPLE_OFFSET, &frame));
+			result = as<udx>(glm::max(frame, 0));
+		}
 	}
 	return result;
 }
 
 void speaker::play() {
 	if (ready_) {
-		alCheck(alSourcePlay(handle_));
+		if (auto mixer = audio::mixer(); mixer) {
+			const auto guard = mixer->lock();
+			this->start_(*mixer);
+		} else {
+			alCheck(alSourcePlay(handle_));
+		}
 	}
 }
 
@@ -71,7 +138,12 @@ bool speaker::playing() const {
 
 void speaker::stop() {
 	if (ready_) {
-		alCheck(alSourceStop(handle_));
+		if (auto mixer = audio::mixer(); mixer) {
+			const auto guard = mixer->lock();
+			this->halt_(*mixer);
+		} else {
+			alCheck(alSourceStop(handle_));
+		}
 	}
 }
 
@@ -81,7 +153,12 @@ bool speaker::stopped() const {
 
 void speaker::pause() {
 	if (ready_) {
-		alCheck(alSourceStop(handle_));
+		if (auto mixer = audio::mixer(); mixer) {
+			const auto guard = mixer->lock();
+			this->halt_(*mixer);
+		} else {
+			alCheck(alSourceStop(handle_));
+		}
 	}
 }
 
@@ -89,10 +166,83 @@ bool speaker::paused() const {
 	return this->matches_state_(AL_PAUSED);
 }
 
+void speaker::stop(const std::vector<speaker*>& list) {
+	if (list.empty()) {
+		return;
+	}
+	if (auto mixer = audio::mixer(); mixer) {
+		const auto guard = mixer->lock();
+		for (auto&& speak : list) {
+			speak->halt_(*mixer);
+		}
+	} else {
+		std::vector<u32> handles {};
+		handles.reserve(list.size());
+		for (auto&& speak : list) {
+			if (speak->handle_ != 0) {
+				handles.push_back(speak->handle_);
+			}
+		}
+		alCheck(alSourceStopv(as<i32>(handles.size()), handles.data()));
+	}
+}
+
+void speaker::play(const std::vector<speaker*>& list) {
+	if (list.empty()) {
+		return;
+	}
+	if (auto mixer = audio::mixer(); mixer) {
+		const auto guard = mixer->lock();
+		for (auto&& speak : list) {
+			if (speak->ready_) {
+				speak->start_(*mixer);
+			}
+		}
+	} else {
+		std::vector<u32> handles {};
+		handles.reserve(list.size());
+		for (auto&& speak : list) {
+			if (speak->ready_) {
+				handles.push_back(speak->handle_);
+			}
+		}
+		alCheck(alSourcePlayv(as<i32>(handles.size()), handles.data()));
+	}
+}
+
+void speaker::start_(software_mixer& mixer) {
+	// mirrors alSourcePlay: paused voices resume, anything else restarts
+	if (auto voice = mixer.voice(handle_); voice) {
+		if (!voice->paused) {
+			voice->cursor = 0;
+		}
+		voice->paused = false;
+		voice->playing = true;
+	}
+}
+
+void speaker::halt_(software_mixer& mixer) {
+	if (auto voice = mixer.voice(handle_); voice) {
+		voice->cursor = 0;
+		voice->paused = false;
+		voice->playing = false;
+	}
+}
+
 bool speaker::matches_state_(i32 name) const {
 	if (handle_ != 0 and ready_) {
 		i32 state = 0;
-		alCheck(alGetSourcei(handle_, AL_SOURCE_STATE, &state));
+		if (auto mixer = audio::mixer(); mixer) {
+			const auto guard = mixer->lock();
+			const auto voice = mixer->voice(handle_);
+			if (voice->playing) {
+				state = voice->paused ? AL_PAUSED : AL_PLAYING;
+			} else {
+				state = AL_STOPPED;
+			}
+		} else {
+			alCheck(alGetSourcei(handle_, AL_SOURCE_STATE, &state));
+		}
 		return state == name;
 	}
 	return false;
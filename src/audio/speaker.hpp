@@ -1,8 +1,10 @@
 #pragma once
 
+#include <vector>
 #include <apostellein/struct.hpp>
 
 struct noise_buffer;
+struct software_mixer;
 
 struct speaker : public not_copyable {
 	speaker() noexcept = default;
@@ -25,16 +27,24 @@ public:
 	void create();
 	void destroy();
 	bool bind(const noise_buffer* noise);
+	bool attach(const noise_buffer* noise);
 	void unbind();
 	r32 volume() const;
 	void volume(r32 value);
+	udx offset() const;
 	void play();
 	bool playing() const;
 	void stop();
 	bool stopped() const;
 	void pause();
 	bool paused() const;
+	u32 handle() const { return handle_; }
+	const noise_buffer* current() const { return current_; }
+	static void stop(const std::vector<speaker*>& list);
+	static void play(const std::vector<speaker*>& list);
 private:
+	void start_(software_mixer& mixer);
+	void halt_(software_mixer& mixer);
 	bool matches_state_(i32 name) const;
 	bool ready_ {};
 	u32 handle_ {};
@@ -2,12 +2,12 @@
 
 #include <string>
 #include <vector>
-#include <nlohmann/json_fwd.hpp>
 #include <apostellein/struct.hpp>
 
 #include "../util/item-slot.hpp"
 
 struct buttons;
+struct save_file;
 
 struct controller {
 public:
@@ -28,6 +28,7 @@ public:
 		bitfield_index<u32, 7> transfering;
 		bitfield_index<u32, 8> importing;
 		bitfield_index<u32, 9> language;
+		bitfield_index<u32, 10> retrying;
 	};
 	void build();
 	void clear() {
@@ -52,8 +53,8 @@ public:
 		field_ = field;
 	}
 	void handle();
-	void read(const nlohmann::json& data);
-	void write(nlohmann::json& data) const;
+	void read(const save_file& data);
+	void write(save_file& data) const;
 	void quit() {
 		state_.quitting = true;
 	}
@@ -69,7 +70,7 @@ public:
 		state_.frozen = true;
 	}
 	void unlock() {
-		if (!state_.transfering and !state_.booting and !state_.loading) {
+		if (!state_.transfering and !state_.booting and !state_.loading and !state_.retrying) {
 			state_.locked = false;
 			state_.frozen = false;
 		}
@@ -77,6 +78,12 @@ public:
 	void load() {
 		state_.loading = true;
 		state_.saving = false;
+		state_.retrying = false;
+	}
+	void retry() {
+		state_.retrying = true;
+		state_.saving = false;
+		state_.loading = false;
 	}
 	void save() {
 		state_.saving = true;
@@ -121,6 +128,7 @@ public:
 		state_.booting = false;
 		state_.saving = false;
 		state_.loading = false;
+		state_.retrying = false;
 		id_ = 0;
 	}
 	void profile(udx value) {
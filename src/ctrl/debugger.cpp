@@ -1,5 +1,10 @@
 #if defined(APOSTELLEIN_IMGUI_DEBUGGER)
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <string_view>
+#include <thread>
 #include <SDL2/SDL.h>
 #include <spdlog/spdlog.h>
 #include <imgui/imgui.h>
@@ -12,11 +17,14 @@
 #include "./runtime.hpp"
 #include "../ecs/aktor.hpp"
 #include "../ecs/kinematics.hpp"
+#include "../hw/audio.hpp"
 #include "../hw/video.hpp"
 #include "../hw/input.hpp"
 #include "../hw/vfs.hpp"
 #include "../util/buttons.hpp"
 #include "../util/config-file.hpp"
+#include "../util/memory-tracker.hpp"
+#include "../util/profiler.hpp"
 #include "../x2d/pipeline-source.hpp"
 #include "../x2d/renderer.hpp"
 
@@ -29,11 +37,32 @@ namespace {
 	const ImVec2 EVENT_DIMENSIONS() { return { 240.0f, 280.0f }; }
 	const ImVec2 FLAGS_POSITION() { return { 100.0f, 80.0f }; }
 	const ImVec2 FLAGS_DIMENSIONS() { return { 240.0f, 280.0f }; }
+	const ImVec2 PROFILER_POSITION() { return { 40.0f, 340.0f }; }
+	const ImVec2 PROFILER_DIMENSIONS() { return { 600.0f, 240.0f }; }
+	const ImVec2 RENDERING_POSITION() { return { 440.0f, 20.0f }; }
+	const ImVec2 RENDERING_DIMENSIONS() { return { 420.0f, 300.0f }; }
+	const ImVec2 MEMORY_POSITION() { return { 440.0f, 340.0f }; }
+	const ImVec2 MEMORY_DIMENSIONS() { return { 360.0f, 320.0f }; }
 
 	constexpr i32 DEFAULT_LIST_LENGTH = 10;
 	constexpr i64 DEFAULT_FRAME_DELAY = konst::SECONDS_TO_NANOSECONDS(0.1);
 	constexpr i64 DEFAULT_FADING_TIME = konst::SECONDS_TO_NANOSECONDS(0.5);
 	constexpr r32 DEFAULT_INTERPOLATION = 0.5f;
+	constexpr r32 ZONE_HEIGHT = 18.0f;
+	constexpr r32 LANE_SPACING = 6.0f;
+	constexpr r32 ZONE_PADDING = 2.0f;
+	constexpr r64 NANOSECONDS_PER_MILLISECOND = 1000000.0;
+	constexpr i32 SHORT_STALL = 100;
+	constexpr i32 LONG_STALL = 500;
+	constexpr i32 MAXIMUM_LOAD = 100;
+	constexpr char TRACE_NAME[] = "trace";
+	constexpr char STATS_NAME[] = "rendering";
+	constexpr char MEMORY_NAME[] = "memory";
+	constexpr char STATS_HEADER[] = "frame,field,priority,blending,pipeline,quads,bytes,gpu_ms\n";
+	constexpr r64 BYTES_PER_KILOBYTE = 1024.0;
+	constexpr std::array<const char*, 2> PRIORITY_NAMES { "automatic", "deferred" };
+	constexpr std::array<const char*, 3> BLENDING_NAMES { "alpha", "add", "multiply" };
+	constexpr std::array<const char*, 4> PIPELINE_NAMES { "blank", "sprite", "glyph", "light" };
 }
 
 debugger::~debugger() {
@@ -44,7 +73,7 @@ debugger::~debugger() {
 	}
 }
 
-bool debugger::build(const config_file& cfg, const renderer& rdr) {
+bool debugger::build(const config_file& cfg, renderer& rdr) {
 	if (cfg.debugger()) {
 		IMGUI_CHECKVERSION();
 		ImGui::CreateContext();
@@ -115,6 +144,9 @@ void debugger::ui_(runtime& state) {
 	static bool events_visible = false;
 	static bool flags_visible = false;
 	static bool aktors_visible = false;
+	static bool profiler_visible = false;
+	static bool rendering_visible = false;
+	static bool memory_visible = false;
 
 	// debugger
 	ImGui::SetNextWindowCollapsed(false, ImGuiCond_FirstUseEver);
@@ -134,6 +166,23 @@ void debugger::ui_(runtime& state) {
 			);
 			ImGui::TextUnformatted(text.c_str());
 		}
+		{
+			auto& stats = video::stats();
+			const std::string text = fmt::format(
+				"Frame Time: {:.3f} ms Average, {:.4f} Variance\n"
+				"Frame Pacing: {:.3f} ms Predicted, {:.3f} ms Slept, {} Missed",
+				stats.average, stats.variance,
+				stats.predicted, stats.slept, stats.missed
+			);
+			ImGui::TextUnformatted(text.c_str());
+		}
+		{
+			const std::string text = fmt::format(
+				"Catch-up Ticks: {}",
+				state.catch_up_
+			);
+			ImGui::TextUnformatted(text.c_str());
+		}
 		{
 			const std::string text = fmt::format(
 				"Lua Memory: {} KB",
@@ -141,6 +190,28 @@ void debugger::ui_(runtime& state) {
 			);
 			ImGui::TextUnformatted(text.c_str());
 		}
+		{
+			auto& heap = state.knl_.heap();
+			const std::string text = fmt::format(
+				"Lua Heap: {} KB, {} KB Peak, {} KB Reserved\n"
+				"Lua Allocations: {} ({} Pooled), {} Freed",
+				heap.bytes / 1024, heap.peak / 1024, heap.reserved / 1024,
+				heap.allocations, heap.pooled, heap.frees
+			);
+			ImGui::TextUnformatted(text.c_str());
+		}
+		{
+			auto& stats = state.knl_.stats();
+			const std::string text = fmt::format(
+				"Lua Collection: {:.3f} ms, {:.3f} ms Longest\n"
+				"Lua Collection: {} Steps, {} Cycles\n"
+				"Routines: {} Active, {} Sleeping, {} Resumed",
+				stats.collection, stats.longest,
+				stats.steps, stats.cycles,
+				stats.active, stats.sleeping, stats.resumed
+			);
+			ImGui::TextUnformatted(text.c_str());
+		}
 		{
 			const std::string text = fmt::format(
 				"Aktors: {}",
@@ -164,6 +235,18 @@ void debugger::ui_(runtime& state) {
 			);
 			ImGui::TextUnformatted(text.c_str());
 		}
+		{
+			auto& stats = audio::stats();
+			const std::string text = fmt::format(
+				"Voices: {}/{}\n"
+				"Voice Requests: {} Played, {} Coalesced\n"
+				"Voice Pressure: {} Limited, {} Stolen, {} Dropped",
+				stats.active, stats.voices,
+				stats.played, stats.coalesced,
+				stats.limited, stats.stolen, stats.dropped
+			);
+			ImGui::TextUnformatted(text.c_str());
+		}
 
 		// buttons
 		ImGui::Separator();
@@ -182,6 +265,34 @@ void debugger::ui_(runtime& state) {
 		if (ImGui::Button("Aktors")) {
 			aktors_visible = !aktors_visible;
 		}
+		ImGui::SameLine();
+		if (ImGui::Button("Profiler")) {
+			profiler_visible = !profiler_visible;
+		}
+		ImGui::SameLine();
+		if (ImGui::Button("Rendering")) {
+			rendering_visible = !rendering_visible;
+		}
+		ImGui::SameLine();
+		if (ImGui::Button("Memory")) {
+			memory_visible = !memory_visible;
+		}
+
+		// synthetic stalls, so catch-up ticks can be exercised on demand
+		ImGui::Separator();
+		if (ImGui::Button("Short Stall")) {
+			stall_ = SHORT_STALL;
+		}
+		ImGui::SameLine();
+		if (ImGui::Button("Long Stall")) {
+			stall_ = LONG_STALL;
+		}
+		ImGui::SameLine();
+		ImGui::SliderInt("Load (ms)", &load_, 0, MAXIMUM_LOAD);
+		if (const i32 duration = stall_ + load_; duration > 0) {
+			stall_ = 0;
+			std::this_thread::sleep_for(std::chrono::milliseconds{ duration });
+		}
 		if (state.ctl_.state().frozen) {
 			fields_visible = false;
 			events_visible = false;
@@ -287,6 +398,241 @@ void debugger::ui_(runtime& state) {
 		ImGui::End();
 	}
 
+	// profiler
+	if (profiler_visible) {
+		ImGui::SetNextWindowCollapsed(false, ImGuiCond_Appearing);
+		ImGui::SetNextWindowPos(PROFILER_POSITION(), ImGuiCond_Appearing);
+		ImGui::SetNextWindowSize(PROFILER_DIMENSIONS(), ImGuiCond_Appearing);
+		if (ImGui::Begin("Profiler")) {
+			const bool paused = profiler::paused();
+			if (ImGui::Button(paused ? "Resume" : "Pause")) {
+				profiler::pause(!paused);
+			}
+			ImGui::SameLine();
+			if (ImGui::Button("Export")) {
+				if (
+					const std::string path = vfs::trace_path(TRACE_NAME);
+					!path.empty() and vfs::dump_json(profiler::trace(), path)
+				) {
+					spdlog::info("Exported trace to {}.", path);
+				}
+			}
+			auto& frame = profiler::latest();
+			const r64 span = as<r64>(std::max(frame.end - frame.begin, i64{ 1 }));
+			{
+				const std::string text = fmt::format(
+					"Frame: {:.3f} ms, {} Zones, {} Dropped",
+					span / NANOSECONDS_PER_MILLISECOND,
+					frame.events.size(),
+					profiler::dropped()
+				);
+				ImGui::TextUnformatted(text.c_str());
+			}
+			ImGui::Separator();
+
+			// one lane per thread, one row per nesting level
+			const udx threads = profiler::threads();
+			std::vector<u32> depths(threads, 0);
+			for (auto&& e : frame.events) {
+				if (e.thread < threads) {
+					depths[e.thread] = std::max(depths[e.thread], e.depth + 1);
+				}
+			}
+			auto list = ImGui::GetWindowDrawList();
+			const ImVec2 origin = ImGui::GetCursorScreenPos();
+			const r32 width = std::max(ImGui::GetContentRegionAvail().x, 1.0f);
+			std::vector<r32> lanes(threads, 0.0f);
+			r32 bottom = origin.y;
+			for (udx idx = 0; idx < threads; ++idx) {
+				if (depths[idx] > 0) {
+					list->AddText({ origin.x, bottom }, IM_COL32_WHITE, profiler::thread_name(as<u32>(idx)));
+					lanes[idx] = bottom + ImGui::GetTextLineHeight();
+					bottom = lanes[idx] + as<r32>(depths[idx]) * ZONE_HEIGHT + LANE_SPACING;
+				}
+			}
+			for (auto&& e : frame.events) {
+				if (e.thread >= threads) {
+					continue;
+				}
+				const auto position = [&frame, span, width, &origin](i64 time) {
+					const r64 ratio = std::clamp(as<r64>(time - frame.begin) / span, 0.0, 1.0);
+					return origin.x + width * as<r32>(ratio);
+				};
+				const ImVec2 minimum {
+					position(e.begin),
+					lanes[e.thread] + as<r32>(e.depth) * ZONE_HEIGHT
+				};
+				const ImVec2 maximum {
+					std::max(position(e.end), minimum.x + 1.0f),
+					minimum.y + ZONE_HEIGHT - 1.0f
+				};
+				const udx hash = std::hash<std::string_view>{}(e.name);
+				list->AddRectFilled(
+					minimum, maximum,
+					ImColor::HSV(as<r32>(hash % 360) / 360.0f, 0.5f, 0.7f)
+				);
+				const ImVec4 clipping { minimum.x, minimum.y, maximum.x - ZONE_PADDING, maximum.y };
+				list->AddText(
+					nullptr, 0.0f,
+					{ minimum.x + ZONE_PADDING, minimum.y + ZONE_PADDING },
+					IM_COL32_WHITE, e.name, nullptr,
+					0.0f, &clipping
+				);
+				if (ImGui::IsMouseHoveringRect(minimum, maximum)) {
+					const std::string text = fmt::format(
+						"{}: {:.3f} ms",
+						e.name,
+						as<r64>(e.end - e.begin) / NANOSECONDS_PER_MILLISECOND
+					);
+					ImGui::SetTooltip("%s", text.c_str());
+				}
+			}
+			ImGui::Dummy({ width, bottom - origin.y });
+		}
+		ImGui::End();
+	}
+
+	// rendering
+	{
+		// keeps recording while this window is closed
+		static std::string records {};
+		static udx frame = 0;
+		static bool recording = false;
+		if (recording) {
+			for (auto&& list : rdr_->lists()) {
+				if (list.visible()) {
+					auto& stats = list.stats();
+					records += fmt::format(
+						"{},{},{},{},{},{},{},{:.4f}\n",
+						frame, state.ctl_.field(),
+						PRIORITY_NAMES[as<udx>(list.priority())],
+						BLENDING_NAMES[as<udx>(list.blending())],
+						PIPELINE_NAMES[as<udx>(list.pipeline())],
+						stats.quads, stats.bytes,
+						as<r64>(stats.elapsed) / NANOSECONDS_PER_MILLISECOND
+					);
+				}
+			}
+			++frame;
+		}
+		if (rendering_visible) {
+			ImGui::SetNextWindowCollapsed(false, ImGuiCond_Appearing);
+			ImGui::SetNextWindowPos(RENDERING_POSITION(), ImGuiCond_Appearing);
+			ImGui::SetNextWindowSize(RENDERING_DIMENSIONS(), ImGuiCond_Appearing);
+			if (ImGui::Begin("Rendering")) {
+				if (bool timing = rdr_->measuring(); ImGui::Checkbox("GPU Timing", &timing)) {
+					rdr_->measure(timing);
+				}
+				ImGui::SameLine();
+				if (!recording and ImGui::Button("Record")) {
+					records = STATS_HEADER;
+					frame = 0;
+					recording = true;
+				} else if (recording and ImGui::Button("Stop")) {
+					recording = false;
+					if (
+						const std::string path = vfs::stats_path(STATS_NAME);
+						!path.empty() and vfs::dump_string(records, path)
+					) {
+						spdlog::info("Dumped rendering stats to {}.", path);
+					}
+					records.clear();
+				}
+				{
+					auto& stats = rdr_->stats();
+					const std::string text = fmt::format(
+						"Draws: {}, Quads: {}, Blend Changes: {}\n"
+						"Uploaded: {:.2f} KB, GPU: {:.3f} ms",
+						stats.draws, stats.quads, stats.blends,
+						as<r64>(stats.bytes) / BYTES_PER_KILOBYTE,
+						as<r64>(stats.elapsed) / NANOSECONDS_PER_MILLISECOND
+					);
+					ImGui::TextUnformatted(text.c_str());
+				}
+				ImGui::Separator();
+				if (ImGui::BeginTable("Lists", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+					ImGui::TableSetupColumn("Priority");
+					ImGui::TableSetupColumn("Blending");
+					ImGui::TableSetupColumn("Pipeline");
+					ImGui::TableSetupColumn("Quads");
+					ImGui::TableSetupColumn("KB");
+					ImGui::TableSetupColumn("GPU ms");
+					ImGui::TableHeadersRow();
+					for (auto&& list : rdr_->lists()) {
+						if (!list.visible()) {
+							continue;
+						}
+						auto& stats = list.stats();
+						ImGui::TableNextRow();
+						ImGui::TableNextColumn();
+						ImGui::TextUnformatted(PRIORITY_NAMES[as<udx>(list.priority())]);
+						ImGui::TableNextColumn();
+						ImGui::TextUnformatted(BLENDING_NAMES[as<udx>(list.blending())]);
+						ImGui::TableNextColumn();
+						ImGui::TextUnformatted(PIPELINE_NAMES[as<udx>(list.pipeline())]);
+						ImGui::TableNextColumn();
+						ImGui::TextUnformatted(fmt::format("{}", stats.quads).c_str());
+						ImGui::TableNextColumn();
+						ImGui::TextUnformatted(fmt::format("{:.2f}", as<r64>(stats.bytes) / BYTES_PER_KILOBYTE).c_str());
+						ImGui::TableNextColumn();
+						ImGui::TextUnformatted(fmt::format("{:.3f}", as<r64>(stats.elapsed) / NANOSECONDS_PER_MILLISECOND).c_str());
+					}
+					ImGui::EndTable();
+				}
+			}
+			ImGui::End();
+		}
+	}
+
+	// memory
+	if (memory_visible) {
+		ImGui::SetNextWindowCollapsed(false, ImGuiCond_Appearing);
+		ImGui::SetNextWindowPos(MEMORY_POSITION(), ImGuiCond_Appearing);
+		ImGui::SetNextWindowSize(MEMORY_DIMENSIONS(), ImGuiCond_Appearing);
+		if (ImGui::Begin("Memory")) {
+			if (ImGui::Button("Dump")) {
+				if (
+					const std::string path = vfs::stats_path(MEMORY_NAME);
+					!path.empty() and vfs::dump_string(memory_tracker::report(), path)
+				) {
+					spdlog::info("Dumped memory report to {}.", path);
+				}
+			}
+			ImGui::Separator();
+			if (ImGui::BeginTable("Subsystems", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+				ImGui::TableSetupColumn("Subsystem");
+				ImGui::TableSetupColumn("KB");
+				ImGui::TableSetupColumn("Peak KB");
+				ImGui::TableSetupColumn("Allocations");
+				ImGui::TableHeadersRow();
+				memory_tracker::stats_type total {};
+				const auto row = [](const char* name, const memory_tracker::stats_type& info) {
+					ImGui::TableNextRow();
+					ImGui::TableNextColumn();
+					ImGui::TextUnformatted(name);
+					ImGui::TableNextColumn();
+					ImGui::TextUnformatted(fmt::format("{:.2f}", as<r64>(info.bytes) / BYTES_PER_KILOBYTE).c_str());
+					ImGui::TableNextColumn();
+					ImGui::TextUnformatted(fmt::format("{:.2f}", as<r64>(info.peak) / BYTES_PER_KILOBYTE).c_str());
+					ImGui::TableNextColumn();
+					ImGui::TextUnformatted(fmt::format("{}", info.allocations).c_str());
+				};
+				for (udx idx = 0; idx < static_cast<udx>(memory_tag::total_); ++idx) {
+					const auto tag = static_cast<memory_tag>(idx);
+					const auto info = memory_tracker::stats(tag);
+					row(memory_tracker::name(tag), info);
+					total.bytes += info.bytes;
+					total.peak += info.peak;
+					total.allocations += info.allocations;
+				}
+				// peaks don't line up in time, so their sum is only an upper bound
+				row("Total", total);
+				ImGui::EndTable();
+			}
+		}
+		ImGui::End();
+	}
+
 	// flags
 	if (flags_visible) {
 		ImGui::SetNextWindowCollapsed(false, ImGuiCond_Appearing);
@@ -13,17 +13,19 @@ struct runtime;
 struct debugger {
 	~debugger();
 public:
-	bool build(const config_file& cfg, const renderer& rdr);
+	bool build(const config_file& cfg, renderer& rdr);
 	void handle(const buttons& bts, runtime& state);
 	void update(i64 delta);
 	void flush() const;
 private:
 	void ui_(runtime& state);
 	void* window_ {};
-	const renderer* rdr_ {};
+	renderer* rdr_ {};
 	i64 timer_ {};
 	i64 fading_ {};
 	i64 frames_ {};
+	i32 stall_ {};
+	i32 load_ {};
 	bool visible_ {};
 };
 
@@ -31,7 +33,7 @@ private:
 
 struct debugger {
 public:
-	bool build(const config_file&, const renderer&) const { return true; }
+	bool build(const config_file&, renderer&) const { return true; }
 	void handle(const buttons&, const runtime&) const {}
 	void update(i64) const {}
 	void flush() const {}
@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <chrono>
+#include <utility>
 #include <spdlog/spdlog.h>
 #include <apostellein/konst.hpp>
 
@@ -10,11 +13,16 @@
 #include "../field/environment.hpp"
 #include "../field/player.hpp"
 #include "../field/camera.hpp"
+#include "../ecs/aktor.hpp"
+#include "../ecs/kinematics.hpp"
+#include "../ecs/sprite.hpp"
 #include "../hw/audio.hpp"
 #include "../hw/music.hpp"
 #include "../hw/vfs.hpp"
 #include "../hw/rng.hpp"
 #include "../util/buttons.hpp"
+#include "../util/config-file.hpp"
+#include "../util/lua-bytecode.hpp"
 #include "../video/material.hpp"
 
 namespace {
@@ -23,9 +31,69 @@ namespace {
 	constexpr char MAIN_SYMBOL[] = "main";
 	constexpr char DEATH_SYMBOL[] = "death";
 	constexpr char INVENTORY_SYMBOL[] = "inventory";
+	// columns of the batch table handed to scripted thinkers
+	enum column_ : int {
+		ENTITY_COLUMN = 1,
+		X_COLUMN,
+		Y_COLUMN,
+		VX_COLUMN,
+		VY_COLUMN,
+		STATE_COLUMN,
+		ANIMATION_COLUMN,
+		VARIATION_COLUMN,
+		MIRROR_COLUMN
+	};
+	constexpr const char* BATCH_COLUMNS[] = {
+		"entity",
+		"x",
+		"y",
+		"vx",
+		"vy",
+		"state",
+		"animation",
+		"variation",
+		"mirror"
+	};
+	constexpr i32 STEP_KILOBYTES = 16;
+	constexpr udx COLLECTION_PAUSE = 150;
+	constexpr u32 HANDLE_SHIFT = 16;
+	constexpr u32 HANDLE_MASK = (1U << HANDLE_SHIFT) - 1U;
+
+	const char* status_to_chars_(const sol::call_status& s) {
+		switch (s) {
+		case sol::call_status::runtime: return "runtime";
+		case sol::call_status::syntax: return "syntax";
+		case sol::call_status::memory: return "memory";
+		case sol::call_status::gc: return "garbage collection";
+		case sol::call_status::handler: return "handler";
+		case sol::call_status::file: return "file";
+		default: break;
+		}
+		return "unknown";
+	}
+}
+
+bool kernel::build(
+	const config_file& cfg,
+	controller& ctl,
+	overlay& ovl,
+	headsup& hud,
+	dialogue& dlg,
+	camera& cam,
+	player& plr,
+	environment& env
+) {
+	const std::string source = vfs::buffer_string(vfs::global_script_path(INIT_MODULE));
+	return this->build_(
+		source, vfs::global_bytecode_path(INIT_MODULE),
+		cfg, ctl, ovl, hud, dlg,
+		cam, plr, env
+	);
 }
 
 bool kernel::build(
+	const std::string& source,
+	const config_file& cfg,
 	controller& ctl,
 	overlay& ovl,
 	headsup& hud,
@@ -34,20 +102,51 @@ bool kernel::build(
 	player& plr,
 	environment& env
 ) {
+	// there's no file to cache bytecode next to
+	return this->build_(
+		source, {},
+		cfg, ctl, ovl, hud, dlg,
+		cam, plr, env
+	);
+}
+
+bool kernel::build_(
+	const std::string& source,
+	const std::string& path,
+	const config_file& cfg,
+	controller& ctl,
+	overlay& ovl,
+	headsup& hud,
+	dialogue& dlg,
+	camera& cam,
+	player& plr,
+	environment& env
+) {
+	// routines resume through references into this pool, so it can never reallocate
+	routines_.reserve(MAXIMUM_ROUTINES);
+
 	// initialize modules
 	engine_.open_libraries(
 		sol::lib::base,
 		sol::lib::package,
 		sol::lib::coroutine
 	);
+	interned_ = engine_.create_table();
 	this->setup_api_(
 		ctl, ovl, hud, dlg,
 		cam, plr, env
 	);
 
+	// collection is stepped from runtime::update unless the budget is zero
+	budget_ = std::chrono::nanoseconds{
+		std::chrono::microseconds{ std::max(cfg.collection_budget(), 0) }
+	}.count();
+	if (budget_ > 0) {
+		lua_gc(engine_.lua_state(), LUA_GCSTOP, 0);
+	}
+
 	// load global module
-	const std::string source = vfs::buffer_string(vfs::global_script_path(INIT_MODULE));
-	if (!engine_.require_script(INIT_MODULE, source).valid()) {
+	if (!this->require_(INIT_MODULE, source, path)) {
 		spdlog::critical("Loading global module failed!");
 		return false;
 	}
@@ -55,6 +154,17 @@ bool kernel::build(
 }
 
 void kernel::clear() {
+	// background routines belong to the field that spawned them
+	for (udx idx = 0; idx < routines_.size(); ++idx) {
+		if (routines_[idx].active) {
+			this->release_(idx, false);
+		}
+	}
+	for (auto&& queue : ready_) {
+		queue.clear();
+	}
+	alarms_ = {};
+	stats_ = {};
 	param_ = sol::nullopt;
 	events_.clear();
 	module_.clear();
@@ -72,7 +182,12 @@ void kernel::handle(
 	dialogue& dlg,
 	const inventory& ivt
 ) {
-	if (running_ and !faulted_) {
+	if (faulted_) {
+		return;
+	}
+	this->wake_();
+	this->dispatch_(routine_priority::high);
+	if (running_) {
 		if (!hud.fader_moving() and !dlg.has_question()) {
 			if (stalling_) {
 				if (!dlg.writing() and bts.pressed.confirm) {
@@ -81,10 +196,13 @@ void kernel::handle(
 					stalling_ = false;
 				}
 			} else if (!waiting_) {
+				// the event is never a routine, whatever was dispatched last
+				const udx previous = std::exchange(current_, MAXIMUM_ROUTINES);
 				const auto result = param_.take().map_or_else(
 					[this](u32 param) { return this->resume_(param); },
 					[this] { return this->resume_(); }
 				);
+				current_ = previous;
 				switch (const auto status = result.status()) {
 					case sol::call_status::ok: {
 						if (ovl.empty() and !ivt.active()) {
@@ -103,23 +221,11 @@ void kernel::handle(
 						break;
 					}
 					default: {
-						auto as_chars = [](const sol::call_status& s) {
-							switch (s) {
-							case sol::call_status::runtime: return "runtime";
-							case sol::call_status::syntax: return "syntax";
-							case sol::call_status::memory: return "memory";
-							case sol::call_status::gc: return "garbage collection";
-							case sol::call_status::handler: return "handler";
-							case sol::call_status::file: return "file";
-							default: break;
-							}
-							return "unknown";
-						};
 						{
 							const sol::error error = result;
 							spdlog::critical(
 								"Event aborted due to {} error! Lua Exception: {}",
-								as_chars(status),
+								status_to_chars_(status),
 								error.what()
 							);
 						}
@@ -127,17 +233,160 @@ void kernel::handle(
 							ctl.freeze();
 						}
 						faulted_ = true;
-						break;
+						return;
 					}
 				}
 			}
 		}
 	}
+	this->dispatch_(routine_priority::normal);
+	if (!running_) {
+		this->dispatch_(routine_priority::idle);
+	}
+}
+
+void kernel::collect() {
+	if (budget_ <= 0) {
+		return;
+	}
+	// like lua's own pause, don't start another cycle until the heap grows
+	auto state = engine_.lua_state();
+	const udx bytes = allocator_.stats().bytes;
+	if (bytes * 100 < settled_ * COLLECTION_PAUSE) {
+		return;
+	}
+	const auto start = std::chrono::steady_clock::now();
+	const auto deadline = start + std::chrono::nanoseconds{ budget_ };
+	do {
+		++stats_.steps;
+		if (lua_gc(state, LUA_GCSTEP, STEP_KILOBYTES) != 0) {
+			++stats_.cycles;
+			settled_ = allocator_.stats().bytes;
+			break;
+		}
+	} while (std::chrono::steady_clock::now() < deadline);
+
+	const std::chrono::duration<r64, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	stats_.collection = elapsed.count();
+	stats_.longest = std::max(stats_.longest, elapsed.count());
+}
+
+void kernel::think(environment& env) {
+	if (scripts_.empty() or faulted_) {
+		return;
+	}
+	for (auto&& type : scripts_) {
+		type.members.clear();
+	}
+	env.slice<ecs::script_thinker>().each(
+	[this](entt::entity e, const ecs::script_thinker& thk) {
+		if (thk.type < scripts_.size()) {
+			scripts_[thk.type].members.push_back(e);
+		}
+	});
+	auto state = engine_.lua_state();
+	// ticks can register more types, so don't hold onto references across calls
+	for (udx index = 0; index < scripts_.size(); ++index) {
+		if (scripts_[index].members.empty() or !scripts_[index].tick.valid()) {
+			continue;
+		}
+		const sol::protected_function tick = scripts_[index].tick;
+		const sol::table batch = scripts_[index].batch;
+		auto& members = batching_;
+		std::swap(members, scripts_[index].members);
+		// pack every member into reused arrays so lua sees one call per type
+		batch.push(state);
+		const int base = lua_gettop(state);
+		for (auto&& column : BATCH_COLUMNS) {
+			lua_getfield(state, base, column);
+		}
+		for (udx idx = 0; idx < members.size(); ++idx) {
+			const auto e = members[idx];
+			const auto key = as<lua_Integer>(idx + 1);
+			auto& loc = env.get<ecs::location>(e);
+			const glm::vec2 velocity = env.has<ecs::kinematics>(e) ?
+				env.get<ecs::kinematics>(e).velocity :
+				glm::vec2{};
+			lua_pushinteger(state, as<lua_Integer>(entt::to_integral(e)));
+			lua_rawseti(state, base + ENTITY_COLUMN, key);
+			lua_pushnumber(state, loc.position.x);
+			lua_rawseti(state, base + X_COLUMN, key);
+			lua_pushnumber(state, loc.position.y);
+			lua_rawseti(state, base + Y_COLUMN, key);
+			lua_pushnumber(state, velocity.x);
+			lua_rawseti(state, base + VX_COLUMN, key);
+			lua_pushnumber(state, velocity.y);
+			lua_rawseti(state, base + VY_COLUMN, key);
+			lua_pushinteger(state, as<lua_Integer>(env.get<ecs::script_thinker>(e).state) + 1);
+			lua_rawseti(state, base + STATE_COLUMN, key);
+			if (env.has<ecs::sprite>(e)) {
+				auto& spt = env.get<ecs::sprite>(e);
+				lua_pushinteger(state, as<lua_Integer>(spt.state()) + 1);
+				lua_rawseti(state, base + ANIMATION_COLUMN, key);
+				lua_pushinteger(state, as<lua_Integer>(spt.variation) + 1);
+				lua_rawseti(state, base + VARIATION_COLUMN, key);
+				lua_pushboolean(state, spt.mirror.horizontally);
+				lua_rawseti(state, base + MIRROR_COLUMN, key);
+			} else {
+				// the rows are reused, so don't leave another entity's sprite behind
+				for (auto column : { ANIMATION_COLUMN, VARIATION_COLUMN, MIRROR_COLUMN }) {
+					lua_pushnil(state);
+					lua_rawseti(state, base + column, key);
+				}
+			}
+		}
+		lua_settop(state, base - 1);
+
+		const auto result = tick(members.size(), batch);
+		if (!result.valid()) {
+			const sol::error error = result;
+			spdlog::error("Thinker \"{}\" aborted! Lua Exception: {}", scripts_[index].name, error.what());
+			scripts_[index].tick = sol::lua_nil;
+			std::swap(members, scripts_[index].members);
+			continue;
+		}
+
+		// the tick may have killed members, so only write back to survivors
+		batch.push(state);
+		for (auto&& column : BATCH_COLUMNS) {
+			lua_getfield(state, base, column);
+		}
+		auto read = [state, base](int column, lua_Integer key) {
+			lua_rawgeti(state, base + column, key);
+			const lua_Number result = lua_tonumber(state, -1);
+			lua_pop(state, 1);
+			return result;
+		};
+		for (udx idx = 0; idx < members.size(); ++idx) {
+			const auto e = members[idx];
+			const auto key = as<lua_Integer>(idx + 1);
+			if (!env.valid(e) or !env.has<ecs::script_thinker>(e)) {
+				continue;
+			}
+			if (env.has<ecs::kinematics>(e)) {
+				auto& kin = env.get<ecs::kinematics>(e);
+				kin.velocity.x = as<r32>(read(VX_COLUMN, key));
+				kin.velocity.y = as<r32>(read(VY_COLUMN, key));
+			}
+			auto& thk = env.get<ecs::script_thinker>(e);
+			thk.state = as<u32>(std::max(read(STATE_COLUMN, key), 1.0) - 1.0);
+			if (env.has<ecs::sprite>(e)) {
+				auto& spt = env.get<ecs::sprite>(e);
+				spt.state(as<udx>(std::max(read(ANIMATION_COLUMN, key), 1.0) - 1.0));
+				spt.variation = as<udx>(std::max(read(VARIATION_COLUMN, key), 1.0) - 1.0);
+				lua_rawgeti(state, base + MIRROR_COLUMN, key);
+				spt.mirror.horizontally = lua_toboolean(state, -1);
+				lua_pop(state, 1);
+			}
+		}
+		lua_settop(state, base - 1);
+		std::swap(members, scripts_[index].members);
+	}
 }
 
 bool kernel::load(const std::string& name) {
 	const std::string source = vfs::buffer_string(vfs::local_script_path(name));
-	if (!engine_.require_script(name, source).valid()) {
+	if (!this->require_(name, source, vfs::local_bytecode_path(name))) {
 		spdlog::error("Loading module \"{}\" failed!", name);
 		return false;
 	}
@@ -290,6 +539,118 @@ std::vector<std::string> kernel::symbols() const {
 	return result;
 }
 
+bool kernel::require_(const std::string& name, const std::string& source, const std::string& path) {
+	// same contract as require_script: loaded modules are never re-run
+	if (const sol::object loaded = engine_["package"]["loaded"][name]; loaded.valid() and loaded != sol::lua_nil) {
+		engine_[name] = loaded;
+		return true;
+	}
+	if (source.empty()) {
+		return false;
+	}
+	const auto start = std::chrono::steady_clock::now();
+	auto state = engine_.lua_state();
+	const u64 hash = lua_bytecode::hash(source);
+	bool cached = false;
+	if (!path.empty() and vfs::file_exists(path)) {
+		cached = lua_bytecode::load(state, vfs::buffer_bytes(path), hash, name);
+	}
+	if (!cached) {
+		if (luaL_loadbufferx(state, source.data(), source.size(), name.c_str(), "t") != LUA_OK) {
+			spdlog::error("Module \"{}\" has syntax errors: {}", name, lua_tostring(state, -1));
+			lua_pop(state, 1);
+			return false;
+		}
+		if (!path.empty()) {
+			if (const auto buffer = lua_bytecode::dump(state, hash); !buffer.empty()) {
+				vfs::dump_bytes(buffer, path);
+			}
+		}
+	}
+	auto chunk = sol::stack::pop<sol::protected_function>(state);
+	const sol::protected_function_result result = chunk(name);
+	if (!result.valid()) {
+		const sol::error error = result;
+		spdlog::error("Module \"{}\" failed to run: {}", name, error.what());
+		return false;
+	}
+	sol::object exports = sol::make_object(state, true);
+	if (result.return_count() > 0) {
+		if (sol::object value = result.get<sol::object>(); value != sol::lua_nil) {
+			exports = std::move(value);
+		}
+	}
+	engine_["package"]["loaded"][name] = exports;
+	engine_[name] = exports;
+
+	const std::chrono::duration<r64, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	spdlog::info(
+		"Module \"{}\" loaded from {} in {:.3f} ms.",
+		name, cached ? "bytecode" : "source",
+		elapsed.count()
+	);
+	return true;
+}
+
+sol::optional<u32> kernel::spawn(const sol::function& routine, routine_priority level) {
+	if (!routine.valid()) {
+		spdlog::error("Can't spawn a routine without a function!");
+		return sol::nullopt;
+	}
+	udx index = MAXIMUM_ROUTINES;
+	if (!vacant_.empty()) {
+		index = vacant_.back();
+		vacant_.pop_back();
+	} else if (routines_.size() < MAXIMUM_ROUTINES) {
+		index = routines_.size();
+		routines_.emplace_back();
+	} else {
+		// evict the least important routine, but never the one that's running
+		for (udx idx = 0; idx < routines_.size(); ++idx) {
+			if (idx != current_ and routines_[idx].level < level) {
+				if (index == MAXIMUM_ROUTINES or routines_[idx].level < routines_[index].level) {
+					index = idx;
+				}
+			}
+		}
+		if (index == MAXIMUM_ROUTINES) {
+			spdlog::error("Routine pool is exhausted!");
+			return sol::nullopt;
+		}
+		spdlog::warn("Routine pool is exhausted! Evicting routine {}...", index);
+		this->release_(index, false);
+		vacant_.pop_back();
+	}
+	auto& rt = routines_[index];
+	if (!rt.thread.valid()) {
+		rt.thread = sol::thread::create(engine_.lua_state());
+	}
+	rt.resume = sol::coroutine{ rt.thread.thread_state(), routine };
+	rt.level = level;
+	rt.active = true;
+	rt.sleeping = false;
+	ready_[as<udx>(level)].push_back({ index, rt.generation });
+	++stats_.active;
+	return as<u32>(index) | ((rt.generation & HANDLE_MASK) << HANDLE_SHIFT);
+}
+
+bool kernel::cancel(u32 handle) {
+	const udx index = as<udx>(handle & HANDLE_MASK);
+	if (
+		index >= routines_.size() or
+		!routines_[index].active or
+		(routines_[index].generation & HANDLE_MASK) != (handle >> HANDLE_SHIFT)
+	) {
+		return false;
+	}
+	if (index == current_) {
+		spdlog::warn("Routines can't cancel themselves! Return from them instead!");
+		return false;
+	}
+	this->release_(index, false);
+	return true;
+}
+
 void kernel::execute_(const sol::function& event) {
 	if (!resume_) {
 		resume_ = event;
@@ -302,6 +663,146 @@ void kernel::execute_(const sol::function& event) {
 	}
 }
 
+void kernel::wake_() {
+	while (!alarms_.empty() and alarms_.top().time <= clock_) {
+		const alarm top = alarms_.top();
+		alarms_.pop();
+		// alarms of cancelled routines are left in the heap and skipped here
+		if (auto& rt = routines_[top.target.index]; rt.active and rt.sleeping and rt.generation == top.target.generation) {
+			rt.sleeping = false;
+			ready_[as<udx>(rt.level)].push_back(top.target);
+			--stats_.sleeping;
+		}
+	}
+}
+
+void kernel::dispatch_(routine_priority level) {
+	auto& queue = ready_[as<udx>(level)];
+	if (queue.empty()) {
+		return;
+	}
+	// anything that yields during this pass is resumed next tick
+	std::swap(queue, pending_);
+	for (auto&& [index, generation] : pending_) {
+		if (!routines_[index].active or routines_[index].generation != generation) {
+			continue;
+		}
+		current_ = index;
+		const auto result = routines_[index].resume();
+		current_ = MAXIMUM_ROUTINES;
+		++stats_.resumed;
+		switch (const auto status = result.status()) {
+			case sol::call_status::ok: {
+				this->release_(index, true);
+				break;
+			}
+			case sol::call_status::yielded: {
+				if (!routines_[index].sleeping) {
+					queue.push_back({ index, generation });
+				}
+				break;
+			}
+			default: {
+				const sol::error error = result;
+				spdlog::error(
+					"Routine aborted due to {} error! Lua Exception: {}",
+					status_to_chars_(status),
+					error.what()
+				);
+				this->release_(index, false);
+				break;
+			}
+		}
+	}
+	pending_.clear();
+}
+
+udx kernel::caller_(lua_State* state) const {
+	// only the routine's own thread counts, not whatever it happens to be running
+	if (current_ < routines_.size() and routines_[current_].thread.thread_state() == state) {
+		return current_;
+	}
+	return MAXIMUM_ROUTINES;
+}
+
+void kernel::sleep_(udx index, i64 delay) {
+	auto& rt = routines_[index];
+	rt.sleeping = true;
+	alarms_.push({ clock_ + delay, { index, rt.generation } });
+	++stats_.sleeping;
+}
+
+void kernel::release_(udx index, bool reusable) {
+	auto& rt = routines_[index];
+	if (rt.sleeping) {
+		--stats_.sleeping;
+	}
+	rt.resume = {};
+	// suspended or errored threads can't host another function
+	if (!reusable) {
+		rt.thread = {};
+	}
+	rt.active = false;
+	rt.sleeping = false;
+	++rt.generation;
+	vacant_.push_back(index);
+	--stats_.active;
+}
+
+const entt::hashed_string& kernel::intern_(std::string_view name) {
+	// symbols are never dropped, so anything holding onto the entry stays valid
+	const auto value = entt::hashed_string::value(name.data(), name.size());
+	auto iter = symbols_.find(value);
+	if (iter == symbols_.end()) {
+		iter = symbols_.emplace(value, symbol{}).first;
+		auto& recent = iter->second;
+		recent.name = name;
+		recent.entry = entt::hashed_string{ recent.name.c_str(), recent.name.size() };
+	}
+	return iter->second.entry;
+}
+
+const entt::hashed_string& kernel::intern_(const sol::stack_object& name) {
+	// lua strings are interned by the state, so a hit is keyed on the string
+	// itself and neither copies nor hashes it again
+	lua_State* state = name.lua_state();
+	const int index = name.stack_index();
+	interned_.push(state);
+	lua_pushvalue(state, index);
+	lua_rawget(state, -2);
+	if (const auto ptr = lua_touserdata(state, -1)) {
+		lua_pop(state, 2);
+		return *static_cast<const entt::hashed_string*>(ptr);
+	}
+	lua_pop(state, 1);
+	udx length = 0;
+	const char* data = luaL_checklstring(state, index, &length);
+	const auto& result = this->intern_(std::string_view{ data, length });
+	lua_pushvalue(state, index);
+	lua_pushlightuserdata(state, const_cast<entt::hashed_string*>(&result));
+	lua_rawset(state, -3);
+	lua_pop(state, 1);
+	return result;
+}
+
+u32 kernel::register_(const std::string& name, const sol::protected_function& tick) {
+	// re-registering (e.g. after reloading) swaps the tick but keeps the index
+	for (udx idx = 0; idx < scripts_.size(); ++idx) {
+		if (scripts_[idx].name == name) {
+			scripts_[idx].tick = tick;
+			return as<u32>(idx);
+		}
+	}
+	auto& recent = scripts_.emplace_back();
+	recent.name = name;
+	recent.tick = tick;
+	recent.batch = engine_.create_table();
+	for (auto&& column : BATCH_COLUMNS) {
+		recent.batch[column] = engine_.create_table();
+	}
+	return as<u32>(scripts_.size() - 1);
+}
+
 void kernel::setup_api_(
 	controller& ctl,
 	overlay& ovl,
@@ -314,21 +815,37 @@ void kernel::setup_api_(
 	{
 		auto tbl = engine_["sys"].get_or_create<sol::table>();
 
-		tbl.set_function("log", [](std::string string) {
+		tbl.set_function("log", [](std::string_view string) {
 			spdlog::info(string);
 		});
-		tbl.set_function("stall", sol::yielding([this] {
+		tbl.set_function("stall", sol::yielding([this](sol::this_state state) {
+			if (this->caller_(state) != MAXIMUM_ROUTINES) {
+				spdlog::warn("Routines can't stall! Yielding until next tick instead...");
+				return;
+			}
 			this->running_ = true;
 			this->waiting_ = false;
 			this->stalling_ = true;
 			this->timer_ = 0;
 		}));
-		tbl.set_function("wait", sol::yielding([this](r64 seconds) {
+		tbl.set_function("wait", sol::yielding([this](r64 seconds, sol::this_state state) {
+			if (const udx index = this->caller_(state); index != MAXIMUM_ROUTINES) {
+				this->sleep_(index, konst::SECONDS_TO_NANOSECONDS(seconds));
+				return;
+			}
 			this->running_ = true;
 			this->waiting_ = true;
 			this->stalling_ = false;
 			this->timer_ = konst::SECONDS_TO_NANOSECONDS(seconds);
 		}));
+		tbl.set_function("spawn", [this](sol::function routine, sol::optional<u32> level) {
+			// priorities are 1-based like every other lua-facing index
+			const u32 priority = std::clamp(level.value_or(2U), 1U, 3U) - 1U;
+			return this->spawn(routine, static_cast<routine_priority>(priority));
+		});
+		tbl.set_function("cancel", [this](u32 handle) {
+			return this->cancel(handle);
+		});
 		tbl.set_function("link", [this](std::string field, std::string event) -> sol::object {
 			if (!this->load(field)) {
 				return sol::make_object(this->engine_.lua_state(), sol::lua_nil);
@@ -369,6 +886,9 @@ void kernel::setup_api_(
 		tbl.set_function("load", [&ctl] {
 			ctl.load();
 		});
+		tbl.set_function("retry", [&ctl] {
+			ctl.retry();
+		});
 		tbl.set_function("save", [&ctl] {
 			ctl.save();
 		});
@@ -405,14 +925,14 @@ void kernel::setup_api_(
 		tbl.set_function("weaponize_item", [&ctl](i32 type, bool weapon) {
 			return ctl.weaponize_item(type, weapon);
 		});
-		tbl.set_function("i18n", [](std::string segment, udx index) {
-			return vfs::i18n_at(segment, index - 1);
+		tbl.set_function("i18n", [this](sol::stack_object segment, udx index) -> const std::string& {
+			return vfs::i18n_at(this->intern_(segment), index - 1);
 		});
-		tbl.set_function("i18n_size", [](std::string segment) {
-			return vfs::i18n_size(segment);
+		tbl.set_function("i18n_size", [this](sol::stack_object segment) {
+			return vfs::i18n_size(this->intern_(segment));
 		});
-		tbl.set_function("material", [](std::string name) {
-			auto ptr = vfs::find_material(name);
+		tbl.set_function("material", [this](sol::stack_object name) {
+			auto ptr = vfs::find_material(this->intern_(name));
 			if (ptr) {
 				return ptr->valid();
 			}
@@ -511,8 +1031,10 @@ void kernel::setup_api_(
 	{
 		auto tbl = engine_["sfx"].get_or_create<sol::table>();
 
-		tbl.set_function("sound", [](std::string id) {
-			audio::play(id);
+		tbl.set_function("sound", [this](sol::stack_object id, sol::optional<u32> level) {
+			// same 1-based levels as sys.spawn, so background chatter can pass 1
+			const u32 priority = std::clamp(level.value_or(2U), 1U, 3U) - 1U;
+			audio::play(this->intern_(id), static_cast<audio::priority>(priority));
 		});
 		tbl.set_function("clear", [] {
 			music::clear();
@@ -523,6 +1045,9 @@ void kernel::setup_api_(
 		tbl.set_function("play", [](r32 start, r32 fade) {
 			return music::play(start, fade);
 		});
+		tbl.set_function("crossfade", [](std::string title, r32 start, r32 fade) {
+			return music::crossfade(title, start, fade);
+		});
 		tbl.set_function("pause", [] {
 			music::pause();
 		});
@@ -541,12 +1066,15 @@ void kernel::setup_api_(
 		tbl.set_function("looping", [] {
 			return music::looping();
 		});
+		tbl.set_function("crossfading", [] {
+			return music::crossfading();
+		});
 	}
 	{
 		auto tbl = engine_["env"].get_or_create<sol::table>();
 
-		tbl.set_function("spawn", [&env](std::string name, r32 x, r32 y, i32 id) {
-			return env.try_spawn(name, x, y, id);
+		tbl.set_function("spawn", [this, &env](sol::stack_object name, r32 x, r32 y, i32 id) {
+			return env.try_spawn(this->intern_(name), x, y, id);
 		});
 		tbl.set_function("kill", [&env](i32 id) {
 			env.kill(id);
@@ -567,6 +1095,18 @@ void kernel::setup_api_(
 				this->events_[id] = event;
 			}
 		});
+		tbl.set_function("thinker", [this](std::string name, sol::protected_function tick) {
+			this->register_(name, tick);
+		});
+		tbl.set_function("script", [this, &env](i32 id, std::string name) {
+			for (udx idx = 0; idx < this->scripts_.size(); ++idx) {
+				if (this->scripts_[idx].name == name) {
+					return env.script(id, as<u32>(idx));
+				}
+			}
+			spdlog::error("There are no thinkers called \"{}\"!", name);
+			return false;
+		});
 		tbl.set_function("still", [&env](i32 id) {
 			return env.still(id);
 		});
@@ -1,10 +1,21 @@
 #pragma once
 
+#include <array>
+#include <functional>
 #include <string>
 #include <map>
+#include <queue>
+#include <vector>
+#include <string_view>
+#include <unordered_map>
 #include <sol/sol.hpp>
+#include <entt/entity/fwd.hpp>
+#include <entt/core/hashed_string.hpp>
 #include <apostellein/def.hpp>
 
+#include "../util/lua-allocator.hpp"
+
+struct config_file;
 struct buttons;
 struct overlay;
 struct headsup;
@@ -15,9 +26,43 @@ struct player;
 struct camera;
 struct controller;
 
+enum class routine_priority : u32 {
+	idle,
+	normal,
+	high
+};
+
 struct kernel {
 public:
+	static constexpr udx MAXIMUM_ROUTINES = 1024;
+	struct stats_type {
+		udx active {};
+		udx sleeping {};
+		udx resumed {};
+		udx steps {};
+		udx cycles {};
+		r64 collection {};
+		r64 longest {};
+	};
+	// coroutines can't be captured, so only event bindings survive a rewind
+	struct checkpoint_type {
+		std::map<i32, sol::function> events {};
+		std::string module {};
+	};
 	bool build(
+		const config_file& cfg,
+		controller& ctl,
+		overlay& ovl,
+		headsup& hud,
+		dialogue& dlg,
+		camera& cam,
+		player& plr,
+		environment& env
+	);
+	// runs source as the global module instead of reading it from the data directory
+	bool build(
+		const std::string& source,
+		const config_file& cfg,
 		controller& ctl,
 		overlay& ovl,
 		headsup& hud,
@@ -27,6 +72,12 @@ public:
 		environment& env
 	);
 	void clear();
+	checkpoint_type checkpoint() const { return { events_, module_ }; }
+	void restore(const checkpoint_type& data) {
+		this->clear();
+		events_ = data.events;
+		module_ = data.module;
+	}
 	void handle(
 		const buttons& bts,
 		controller& ctl,
@@ -36,6 +87,7 @@ public:
 		const inventory& ivt
 	);
 	void update(i64 delta) {
+		clock_ += delta;
 		if (waiting_) {
 			if (timer_ -= delta; timer_ <= 0) {
 				timer_ = 0;
@@ -45,6 +97,8 @@ public:
 			}
 		}
 	}
+	void collect();
+	void think(environment& env);
 	bool load(const std::string& name);
 	void reload();
 	void push(i32 id, const std::string& name);
@@ -53,6 +107,8 @@ public:
 	bool run_event(i32 id);
 	bool run_symbol(const std::string& symbol);
 	bool run_transfer(const controller& ctl);
+	sol::optional<u32> spawn(const sol::function& routine, routine_priority level);
+	bool cancel(u32 handle);
 	bool running() const { return running_; }
 	bool changed() {
 		bool result = changed_;
@@ -61,8 +117,58 @@ public:
 	}
 	udx kilobytes() const { return engine_.memory_used() / 1024; }
 	std::vector<std::string> symbols() const;
+	const stats_type& stats() const { return stats_; }
+	const lua_allocator::stats_type& heap() const { return allocator_.stats(); }
 private:
+	struct routine {
+		sol::thread thread {};
+		sol::coroutine resume {};
+		routine_priority level {};
+		u32 generation {};
+		bool active {};
+		bool sleeping {};
+	};
+	struct symbol {
+		std::string name {};
+		entt::hashed_string entry {};
+	};
+	struct script_type {
+		std::string name {};
+		sol::protected_function tick {};
+		sol::table batch {};
+		std::vector<entt::entity> members {};
+	};
+	struct ticket {
+		udx index {};
+		u32 generation {};
+	};
+	struct alarm {
+		i64 time {};
+		ticket target {};
+		bool operator>(const alarm& that) const { return time > that.time; }
+	};
+	bool build_(
+		const std::string& source,
+		const std::string& path,
+		const config_file& cfg,
+		controller& ctl,
+		overlay& ovl,
+		headsup& hud,
+		dialogue& dlg,
+		camera& cam,
+		player& plr,
+		environment& env
+	);
+	bool require_(const std::string& name, const std::string& source, const std::string& path);
 	void execute_(const sol::function& event);
+	void wake_();
+	void dispatch_(routine_priority level);
+	udx caller_(lua_State* state) const;
+	void sleep_(udx index, i64 delay);
+	void release_(udx index, bool reusable);
+	u32 register_(const std::string& name, const sol::protected_function& tick);
+	const entt::hashed_string& intern_(std::string_view name);
+	const entt::hashed_string& intern_(const sol::stack_object& name);
 	void setup_api_(
 		controller& ctl,
 		overlay& ovl,
@@ -72,11 +178,28 @@ private:
 		player& plr,
 		environment& env
 	);
-	sol::state engine_ {};
+	// the allocator has to outlive the state
+	lua_allocator allocator_ {};
+	sol::state engine_ { sol::default_at_panic, &lua_allocator::allocate, &allocator_ };
 	sol::coroutine resume_ {};
+	// lua string -> symbol, so repeated names skip hashing entirely
+	sol::table interned_ {};
 	sol::optional<u32> param_ {};
 	std::map<i32, sol::function> events_ {};
 	std::string module_ {};
+	std::unordered_map<entt::id_type, symbol> symbols_ {};
+	std::vector<script_type> scripts_ {};
+	std::vector<entt::entity> batching_ {};
+	std::vector<routine> routines_ {};
+	std::vector<udx> vacant_ {};
+	std::array<std::vector<ticket>, 3> ready_ {};
+	std::vector<ticket> pending_ {};
+	std::priority_queue<alarm, std::vector<alarm>, std::greater<alarm>> alarms_ {};
+	udx current_ { MAXIMUM_ROUTINES };
+	stats_type stats_ {};
+	i64 clock_ {};
+	i64 budget_ {};
+	udx settled_ {};
 	i64 timer_ {};
 	bool running_ {};
 	bool waiting_ {};
@@ -1,10 +1,8 @@
+#include <chrono>
 #include <nlohmann/json.hpp>
-#include <tmxlite/Map.hpp>
-#include <tmxlite/TileLayer.hpp>
-#include <tmxlite/ImageLayer.hpp>
-#include <tmxlite/ObjectGroup.hpp>
 #include <spdlog/spdlog.h>
 #include <apostellein/konst.hpp>
+#include <apostellein/cast.hpp>
 
 #include "./runtime.hpp"
 #include "../ecs/aktor.hpp"
@@ -14,19 +12,24 @@
 #include "../hw/video.hpp"
 #include "../hw/vfs.hpp"
 #include "../util/buttons.hpp"
+#include "../util/id-table.hpp"
+#include "../util/profiler.hpp"
+#include "../util/save-file.hpp"
 #include "../video/material.hpp"
 #include "../x2d/renderer.hpp"
 
 namespace {
 	constexpr char PROFILE_NAME[] = "profile-";
+	constexpr r64 STABLE_FRAME_TICKS = 1.5;
 }
 
-bool runtime::build(const config_file& cfg, const renderer& rdr) {
+bool runtime::build(const config_file& cfg, renderer& rdr) {
 	if (!dbr_.build(cfg, rdr)) {
 		return false;
 	}
 	ctl_.build();
-	if (!knl_.build(ctl_, ovl_, hud_, dlg_, cam_, plr_, env_)) {
+	export_ = cfg.export_saves();
+	if (!knl_.build(cfg, ctl_, ovl_, hud_, dlg_, cam_, plr_, env_)) {
 		return false;
 	}
 	ovl_.reset();
@@ -44,7 +47,8 @@ bool runtime::build(const config_file& cfg, const renderer& rdr) {
 	return true;
 }
 
-void runtime::handle(udx ticks, activity_type& aty, buttons& bts) {
+void runtime::handle(udx ticks, u32 start, activity_type& aty, buttons& bts) {
+	APOSTELLEIN_ZONE("runtime::handle");
 	// debugger
 	dbr_.handle(bts, *this);
 	// before handling
@@ -52,8 +56,22 @@ void runtime::handle(udx ticks, activity_type& aty, buttons& bts) {
 	cam_.prepare();
 	env_.prepare();
 	map_.prepare();
-	// handle accumulated ticks
-	for (; ticks > 0; --ticks) {
+	// saves are written in the background, so a failure only shows up a frame or so later
+	if (!vfs::poll()) {
+		this->unsaved_();
+	}
+	// every tick but the last is a catch-up tick, which only simulates
+	catch_up_ += ticks - 1;
+	for (udx tick = 1; ticks > 0; --ticks, ++tick) {
+		// presses land in the tick they happened during, the last one takes the rest
+		if (ticks > 1) {
+			input::consume(
+				start + as<u32>(konst::NANOSECONDS_TO_MILLISECONDS(konst::NANOSECONDS_PER_TICK() * as<i64>(tick))),
+				bts
+			);
+		} else {
+			input::consume(bts);
+		}
 		auto& state = ctl_.state();
 		if (hud_.fader_finished()) {
 			if (state.language) {
@@ -67,6 +85,9 @@ void runtime::handle(udx ticks, activity_type& aty, buttons& bts) {
 			if (state.booting) {
 				this->boot_();
 			}
+			if (state.retrying) {
+				this->restore_();
+			}
 			if (state.loading) {
 				this->load_();
 			}
@@ -90,10 +111,14 @@ void runtime::handle(udx ticks, activity_type& aty, buttons& bts) {
 			cam_.handle(plr_, env_);
 			plr_.handle(bts, ctl_, knl_, hud_, env_, map_);
 			env_.handle(knl_, hud_, cam_, plr_, map_);
-			map_.handle(cam_.view());
 		}
 		bts.clear();
 	}
+	// visuals only need to be rebuilt for the tick that gets rendered
+	if (!ctl_.state().frozen) {
+		env_.settle();
+		map_.handle(cam_.view());
+	}
 	// recalibrate virtual texture
 	if (material::recalibrate()) {
 		ovl_.fix();
@@ -105,7 +130,19 @@ void runtime::handle(udx ticks, activity_type& aty, buttons& bts) {
 }
 
 void runtime::update(i64 delta) {
+	APOSTELLEIN_ZONE("runtime::update");
+	if (
+		settling_ and
+		!hud_.fader_visible() and
+		as<r64>(delta) <= STABLE_FRAME_TICKS * as<r64>(konst::NANOSECONDS_PER_TICK())
+	) {
+		// the first frame after the fader that doesn't hitch
+		settling_ = false;
+		const std::chrono::duration<r64, std::milli> elapsed = std::chrono::steady_clock::now() - transferred_;
+		spdlog::info("Field \"{}\" stable after {:.3f} ms.", ctl_.field(), elapsed.count());
+	}
 	knl_.update(delta);
+	knl_.collect();
 	ovl_.update(delta);
 	hud_.update(delta);
 	dlg_.update(delta);
@@ -116,6 +153,7 @@ void runtime::update(i64 delta) {
 }
 
 void runtime::render(r32 ratio, renderer& rdr) const {
+	APOSTELLEIN_ZONE("runtime::render");
 	ovl_.render(rdr);
 	hud_.render(ratio, rdr, ctl_);
 	dlg_.render(rdr);
@@ -138,6 +176,7 @@ void runtime::boot_() {
 	dlg_.clear();
 	ivt_.clear();
 	plr_.clear(env_);
+	checkpoint_.valid = false;
 	knl_.run_transfer(ctl_);
 }
 
@@ -157,33 +196,35 @@ bool runtime::transfer_() {
 		ctl_.finish();
 		return false;
 	}
-	const std::string path = vfs::field_path(field);
-	tmx::Map desc {};
-	if (!desc.load(path)) {
+	const auto start = std::chrono::steady_clock::now();
+	if (fld_ = vfs::buffer_field(field); !fld_.valid()) {
 		spdlog::critical("Couldn't load next field's description!");
 		ctl_.finish();
 		return false;
 	}
-	const rect bounds = tmx_convert::rect_to_rect(desc);
-	cam_.limit(bounds);
-	map_.load_properties(desc, bounds);
-	for (auto&& layer : desc.getLayers()) {
-		switch (layer->getType()) {
-		case tmx::Layer::Type::Tile:
-			map_.load_tiles(layer->getLayerAs<tmx::TileLayer>());
-			break;
-		case tmx::Layer::Type::Object:
-			env_.load(layer->getLayerAs<tmx::ObjectGroup>(), ctl_, knl_);
-			break;
-		case tmx::Layer::Type::Image:
-			map_.load_parallax(layer->getLayerAs<tmx::ImageLayer>());
-			break;
-		default:
-			break;
-		}
+	// everything the field could ask for gets loaded while the screen is dark,
+	// so nothing touches the disk or uploads textures mid-tick
+	const auto manifest = vfs::buffer_manifest(field, fld_);
+	const udx animations = vfs::preload_animations(env_.animations(manifest.aktors()));
+	const udx materials = vfs::preload_materials(manifest.materials());
+	std::vector<std::string> noises = manifest.noises();
+	for (auto&& id : sfx::Global) {
+		noises.emplace_back(id.data());
 	}
+	vfs::preload_noises(field, noises);
+	cam_.limit(fld_.bounds());
+	map_.load(fld_);
+	env_.load(fld_, ctl_, knl_);
+	const std::chrono::duration<r64, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	spdlog::info(
+		"Field \"{}\" transferred in {:.3f} ms ({} animations, {} materials prewarmed).",
+		field, elapsed.count(), animations, materials
+	);
 	plr_.transfer(ctl_.id(), cam_, env_);
 	ctl_.finish();
+	this->snapshot_();
+	transferred_ = start;
+	settling_ = true;
 	return true;
 }
 
@@ -194,27 +235,57 @@ bool runtime::save_() {
 		ctl_.close();
 		return false;
 	}
-	auto file = nlohmann::json::object();
+	const auto start = std::chrono::steady_clock::now();
+	save_file file {};
 	plr_.write(file, env_);
 	ctl_.write(file);
-	if (!vfs::dump_json(file, path)) {
-		ctl_.close();
-		spdlog::error("Couldn't save current state!");
-		return false;
+	// the disk write itself happens off the main thread
+	vfs::dump_bytes_async(file.dump(), path);
+	const std::chrono::duration<r64, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	spdlog::info("Save serialized in {:.3f} ms.", elapsed.count());
+	if (export_) {
+		auto data = nlohmann::json::object();
+		file.write(data);
+		vfs::dump_json(data, vfs::export_path(PROFILE_NAME, ctl_.profile()));
 	}
-	spdlog::info("Save successful.");
 	ctl_.close();
 	return true;
 }
 
+void runtime::unsaved_() {
+	const std::string message = fmt::format(
+		"Couldn't write save file for profile {}! Progress since the last save will be lost.",
+		ctl_.profile()
+	);
+	spdlog::error(message);
+	// shown over the field, since a modal box would stall the frame it's raised in
+	hud_.display_title(message);
+}
+
 bool runtime::load_() {
-	const std::string path = vfs::save_path(PROFILE_NAME, ctl_.profile());
-	const auto file = vfs::buffer_json(path);
-	if (file.empty()) {
-		spdlog::error("Couldn't load current state!");
-		ctl_.close();
-		ctl_.boot();
-		return false;
+	// a save still in flight has to land before reading it back
+	if (!vfs::flush()) {
+		this->unsaved_();
+	}
+	const auto start = std::chrono::steady_clock::now();
+	save_file file {};
+	if (const std::string path = vfs::save_path(PROFILE_NAME, ctl_.profile()); vfs::file_exists(path)) {
+		if (!file.load(vfs::buffer_bytes(path))) {
+			spdlog::error("Couldn't load current state!");
+			ctl_.close();
+			ctl_.boot();
+			return false;
+		}
+	} else {
+		// fall back to saves written before the binary format
+		const auto data = vfs::buffer_json(vfs::export_path(PROFILE_NAME, ctl_.profile()));
+		if (data.empty()) {
+			spdlog::error("Couldn't load current state!");
+			ctl_.close();
+			ctl_.boot();
+			return false;
+		}
+		file.read(data);
 	}
 	plr_.read(file, env_);
 	ctl_.read(file);
@@ -223,7 +294,55 @@ bool runtime::load_() {
 	hud_.clear();
 	dlg_.clear();
 	ivt_.clear();
-	spdlog::info("Load successful.");
+	const std::chrono::duration<r64, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	spdlog::info("Load successful in {:.3f} ms.", elapsed.count());
+	ctl_.close();
+	return true;
+}
+
+void runtime::snapshot_() {
+	const auto start = std::chrono::steady_clock::now();
+	env_.snapshot(checkpoint_.registry);
+	checkpoint_.progress.clear();
+	ctl_.write(checkpoint_.progress);
+	// the field is already loaded, so restoring shouldn't transfer again
+	checkpoint_.progress.field.clear();
+	checkpoint_.events = knl_.checkpoint();
+	checkpoint_.hero = plr_;
+	checkpoint_.view = cam_;
+	checkpoint_.valid = true;
+	const std::chrono::duration<r64, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	spdlog::info(
+		"Snapshot taken in {:.3f} ms ({} bytes).",
+		elapsed.count(), checkpoint_.registry.size()
+	);
+}
+
+bool runtime::restore_() {
+	if (!checkpoint_.valid) {
+		// nothing to rewind to, so take the long way around
+		ctl_.load();
+		return false;
+	}
+	const auto start = std::chrono::steady_clock::now();
+	if (!env_.restore(checkpoint_.registry)) {
+		checkpoint_.valid = false;
+		ctl_.load();
+		return false;
+	}
+	ctl_.lock();
+	ctl_.read(checkpoint_.progress);
+	knl_.restore(checkpoint_.events);
+	plr_ = checkpoint_.hero;
+	cam_ = checkpoint_.view;
+	ovl_.clear();
+	hud_.clear();
+	dlg_.clear();
+	ivt_.clear();
+	map_.handle(cam_.view(), true);
+	knl_.run_transfer(ctl_);
+	const std::chrono::duration<r64, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	spdlog::info("Snapshot restored in {:.3f} ms.", elapsed.count());
 	ctl_.close();
 	return true;
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <chrono>
+
 #include "./debugger.hpp"
 #include "./controller.hpp"
 #include "./kernel.hpp"
@@ -11,20 +13,34 @@
 #include "../field/player.hpp"
 #include "../field/environment.hpp"
 #include "../x2d/tile-map.hpp"
+#include "../util/field-file.hpp"
+#include "../util/save-file.hpp"
 
 enum class activity_type;
 
 struct runtime {
 public:
-	bool build(const config_file& cfg, const renderer& rdr);
-	void handle(udx ticks, activity_type& aty, buttons& bts);
+	bool build(const config_file& cfg, renderer& rdr);
+	void handle(udx ticks, u32 start, activity_type& aty, buttons& bts);
 	void update(i64 delta);
 	void render(r32 ratio, renderer& rdr) const;
 private:
 	void boot_();
 	bool save_();
+	void unsaved_();
 	bool load_();
 	bool transfer_();
+	void snapshot_();
+	bool restore_();
+	// field state right after the last transfer, for instant retries
+	struct checkpoint_type {
+		bool valid {};
+		std::vector<byte> registry {};
+		save_file progress {};
+		kernel::checkpoint_type events {};
+		player hero {};
+		camera view {};
+	};
 	controller ctl_ {};
 	kernel knl_ {};
 	overlay ovl_ {};
@@ -35,6 +51,12 @@ private:
 	player plr_ {};
 	environment env_ {};
 	tile_map map_ {};
+	field_file fld_ {};
 	debugger dbr_ {};
+	checkpoint_type checkpoint_ {};
+	std::chrono::steady_clock::time_point transferred_ {};
+	bool settling_ {};
+	bool export_ {};
+	udx catch_up_ {};
 	friend struct debugger;
 };
@@ -1,11 +1,10 @@
-#include <apostellein/konst.hpp>
-
 #include "./sprite.hpp"
 #include "./aktor.hpp"
 #include "../field/environment.hpp"
 #include "../hw/vfs.hpp"
 #include "../hw/rng.hpp"
 #include "../x2d/animation-group.hpp"
+#include "../util/byte-stream.hpp"
 
 namespace {
 	constexpr r32 SHAKING_AMOUNT = 0.01f;
@@ -16,8 +15,7 @@ namespace {
 
 ecs::sprite::sprite(const entt::hashed_string& data) {
 	file_ = vfs::find_animation(data);
-	previous_ = {};
-	current_ = {};
+	history_ = {};
 }
 
 bool ecs::sprite::finished() const {
@@ -34,16 +32,50 @@ glm::vec2 ecs::sprite::action_point(udx state, const glm::vec2& position) const
 	return position;
 }
 
+void ecs::sprite::dump(byte_writer& stream) const {
+	// snapshots never leave the process, so the animation pointer stays valid
+	stream.put(file_);
+	stream.put(state_);
+	stream.put(history_);
+	stream.put(timer);
+	stream.put(variation);
+	stream.put(frame);
+	stream.put(color);
+	stream.put(layer);
+	stream.put(mirror);
+	stream.put(scale);
+	stream.put(pivot);
+	stream.put(angle);
+	stream.put(shake);
+}
+
+bool ecs::sprite::load(byte_reader& stream) {
+	return
+		stream.get(file_) and
+		stream.get(state_) and
+		stream.get(history_) and
+		stream.get(timer) and
+		stream.get(variation) and
+		stream.get(frame) and
+		stream.get(color) and
+		stream.get(layer) and
+		stream.get(mirror) and
+		stream.get(scale) and
+		stream.get(pivot) and
+		stream.get(angle) and
+		stream.get(shake);
+}
+
 void ecs::sprite::prepare(environment& env) {
 	env.slice<ecs::sprite>().each([](entt::entity, ecs::sprite& spt) {
-		spt.previous_ = spt.current_;
+		spt.history_.prepare();
 	});
 }
 
 void ecs::sprite::handle(environment& env) {
 	env.slice<ecs::location, ecs::sprite>().each(
 	[&env](entt::entity e, const ecs::location& loc, ecs::sprite& spt) {
-		spt.current_ = loc.position;
+		spt.history_.push(loc.position);
 		if (spt.shake != 0.0f) {
 			spt.shake = -spt.shake;
 			spt.shake = spt.shake > 0.0f ?
@@ -85,11 +117,7 @@ void ecs::sprite::render(r32 ratio, const rect& view, renderer& rdr, const envir
 	env.slice<ecs::sprite>().each(
 	[&ratio, &view, &rdr, &env](entt::entity, const ecs::sprite& spt) {
 		if (spt.file_ and spt.color.a > 0x00U) {
-			const glm::vec2 position = konst::INTERPOLATE(
-				spt.previous_,
-				spt.current_,
-				ratio
-			);
+			const glm::vec2 position = spt.history_.at(ratio);
 			if (spt.angle != 0.0f) {
 				spt.file_->render(
 					spt.state_,
@@ -126,11 +154,7 @@ udx ecs::sprite::visible(r32 ratio, const rect& view, const environment& env) {
 	env.slice<ecs::sprite>().each(
 	[&ratio, &count, &view, &env](entt::entity, const ecs::sprite& spt) {
 		if (spt.file_ and spt.color.a > 0x00U) {
-			const glm::vec2 position = konst::INTERPOLATE(
-				spt.previous_,
-				spt.current_,
-				ratio
-			);
+			const glm::vec2 position = spt.history_.at(ratio);
 			if (spt.angle != 0.0f) {
 				if (spt.file_->visible(
 					spt.state_,
@@ -5,11 +5,14 @@
 #include <apostellein/struct.hpp>
 
 #include "../x2d/mirror-type.hpp"
+#include "../x2d/transform-history.hpp"
 
 struct rect;
 struct renderer;
 struct animation_group;
 struct environment;
+struct byte_writer;
+struct byte_reader;
 
 namespace ecs {
 	struct sprite : public not_copyable {
@@ -24,10 +27,8 @@ namespace ecs {
 				that.file_ = nullptr;
 				state_ = that.state_;
 				that.state_ = 0;
-				previous_ = that.previous_;
-				that.previous_ = {};
-				current_ = that.current_;
-				that.current_ = {};
+				history_ = that.history_;
+				that.history_ = {};
 				timer = that.timer;
 				that.timer = 0;
 				variation = that.variation;
@@ -54,7 +55,7 @@ namespace ecs {
 	public:
 		void clear() {
 			state_ = 0;
-			current_ = {};
+			history_ = {};
 			timer = 0;
 			variation = 0;
 			frame = 0;
@@ -67,8 +68,7 @@ namespace ecs {
 			shake = 0.0f;
 		}
 		void prepare(const glm::vec2& position) {
-			previous_ = position;
-			current_ = position;
+			history_.reset(position);
 		}
 		void state(udx value) {
 			if (state_ != value) {
@@ -80,6 +80,8 @@ namespace ecs {
 		udx state() const { return state_; }
 		bool finished() const;
 		glm::vec2 action_point(udx state, const glm::vec2& position) const;
+		void dump(byte_writer& stream) const;
+		bool load(byte_reader& stream);
 		static void prepare(environment& env);
 		static void handle(environment& env);
 		static void update(i64 delta, environment& env);
@@ -89,8 +91,7 @@ namespace ecs {
 		// weirdly specific layout, I know
 		const animation_group* file_ {};
 		udx state_ {};
-		glm::vec2 previous_ {};
-		glm::vec2 current_ {};
+		transform_history history_ {};
 	public:
 		i64 timer {};
 		udx variation {};
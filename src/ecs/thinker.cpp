@@ -1,5 +1,6 @@
 #include "./thinker.hpp"
 #include "../field/environment.hpp"
+#include "../ctrl/kernel.hpp"
 
 void ecs::thinker::handle(kernel& knl, camera& cam, player& plr, environment& env) {
 	env.slice<ecs::thinker>().each(
@@ -8,4 +9,6 @@ void ecs::thinker::handle(kernel& knl, camera& cam, player& plr, environment& en
 			thk.func(s, knl, cam, plr, env);
 		}
 	});
+	// scripted thinkers are batched into one call per type
+	knl.think(env);
 }
@@ -3,6 +3,7 @@
 #include <vector>
 #include <unordered_map>
 #include <entt/entity/fwd.hpp>
+#include <entt/core/hashed_string.hpp>
 #include <apostellein/struct.hpp>
 
 struct kernel;
@@ -23,8 +24,24 @@ namespace ecs {
 		static void handle(kernel& knl, camera& cam, player& plr, environment& env);
 	};
 
+	struct script_thinker {
+		script_thinker() noexcept = default;
+		script_thinker(u32 _type) noexcept :
+			type{ _type } {}
+
+		u32 type {};
+		u32 state {};
+	};
+
 	using thinker_ctor = void(*)(entt::entity, environment&);
-	using thinker_ctor_table = std::unordered_map<entt::id_type, thinker_ctor>;
+	// animations are listed so fields can load them before the first spawn,
+	// and the type keeps its literal name so spawns never hash it again
+	struct thinker_entry {
+		thinker_ctor ctor {};
+		std::vector<entt::hashed_string> animations {};
+		entt::hashed_string type {};
+	};
+	using thinker_ctor_table = std::unordered_map<entt::id_type, thinker_entry>;
 	using thinker_ctor_table_callback = void(*)(thinker_ctor_table&);
 
 	struct thinker_ctor_table_builder : public not_moveable {
@@ -55,4 +72,5 @@ namespace ecs {
 	static const ecs::thinker_ctor_table_builder SYMBOL##_ctor_table_builder { SYMBOL##_build_ctor_table }; \
 	static void SYMBOL##_build_ctor_table(ecs::thinker_ctor_table& table) \
 
-#define APOSTELLEIN_THINKER_ENTRY(AKTOR, ENTRY) table[AKTOR] = ENTRY
+#define APOSTELLEIN_THINKER_ENTRY(AKTOR, ENTRY) table[AKTOR] = ecs::thinker_entry{ ENTRY, {}, AKTOR }
+#define APOSTELLEIN_THINKER_SPRITE(AKTOR, ENTRY, ...) table[AKTOR] = ecs::thinker_entry{ ENTRY, { __VA_ARGS__ }, AKTOR }
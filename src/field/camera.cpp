@@ -40,7 +40,7 @@ void camera::clear() {
 		TOP_LEFT_CORNER,
 		konst::WINDOW_DIMENSIONS<r32>()
 	};
-	current_ = DEFAULT_POSITION;
+	history_.reset(DEFAULT_POSITION);
 	dimensions_ = konst::WINDOW_DIMENSIONS<r32>();
 	offsets_ = {};
 	power_ = 0.0f;
@@ -48,7 +48,7 @@ void camera::clear() {
 }
 
 void camera::prepare() {
-	previous_ = current_;
+	history_.prepare();
 }
 
 void camera::handle(const player& plr, const environment& env) {
@@ -62,8 +62,11 @@ void camera::handle(const player& plr, const environment& env) {
 	} else {
 		point = plr.viewpoint(env);
 	}
-	current_ = glm::mix(current_, point, DEFAULT_WEIGHT);
-	current_ = clamp_position_(current_, dimensions_, limit_);
+	history_.push(clamp_position_(
+		glm::mix(history_.current(), point, DEFAULT_WEIGHT),
+		dimensions_,
+		limit_
+	));
 	if (power_ != 0.0f) {
 		if (cycling_) {
 			cycling_ = false;
@@ -96,12 +99,13 @@ void camera::limit(const rect& bounds) {
 		TOP_LEFT_CORNER,
 		bounds.dimensions() - TOP_LEFT_CORNER * 2.0f
 	};
-	current_ = DEFAULT_POSITION;
+	history_.reset(DEFAULT_POSITION);
 	dimensions_ = konst::WINDOW_DIMENSIONS<r32>();
 }
 
 void camera::focus_on(const glm::vec2& point) {
-	current_ = clamp_position_(point, dimensions_, limit_);
+	// a cut, so don't sweep across the field from wherever the camera was
+	history_.reset(clamp_position_(point, dimensions_, limit_));
 }
 
 void camera::quake(r32 power, i32 ticks) {
@@ -132,11 +136,7 @@ void camera::quake(r32 power) {
 }
 
 rect camera::view(r32 ratio) const {
-	const glm::vec2 position = konst::INTERPOLATE(
-		previous_,
-		current_,
-		ratio
-	);
+	const glm::vec2 position = history_.at(ratio);
 	return {
 		position - (dimensions_ / 2.0f),
 		dimensions_
@@ -156,11 +156,7 @@ glm::mat4 camera::matrix(r32 ratio) const {
 	if (tilt_ != 0.0f) {
 		result = glm::rotate(result, tilt_, DEFAULT_AXIS);
 	}
-	const glm::vec2 position = konst::INTERPOLATE(
-		previous_,
-		current_,
-		ratio
-	);
+	const glm::vec2 position = history_.at(ratio);
 	return glm::translate(
 		result,
 		-glm::vec3 {
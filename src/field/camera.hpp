@@ -3,6 +3,8 @@
 #include <glm/mat4x4.hpp>
 #include <apostellein/rect.hpp>
 
+#include "../x2d/transform-history.hpp"
+
 struct environment;
 struct player;
 
@@ -20,7 +22,7 @@ public:
 	void quake(r32 power);
 	rect view() const {
 		return {
-			current_ - (dimensions_ / 2.0f),
+			history_.current() - (dimensions_ / 2.0f),
 			dimensions_
 		};
 	}
@@ -32,8 +34,7 @@ private:
 	i32 id_ {};
 	i32 ticks_ {};
 	rect limit_ {};
-	glm::vec2 previous_ {};
-	glm::vec2 current_ {};
+	transform_history history_ {};
 	glm::vec2 dimensions_ {};
 	glm::vec2 offsets_ {};
 	r32 power_ {};
@@ -1,10 +1,11 @@
 #include <algorithm>
 #include <spdlog/spdlog.h>
-#include <tmxlite/ObjectGroup.hpp>
+#include <entt/entity/snapshot.hpp>
 
 #include "./environment.hpp"
 #include "./player.hpp"
 #include "../ai/particles.hpp"
+#include "../ai/friends.hpp"
 #include "../ecs/aktor.hpp"
 #include "../ecs/sprite.hpp"
 #include "../ecs/kinematics.hpp"
@@ -12,37 +13,48 @@
 #include "../ecs/liquid.hpp"
 #include "../ctrl/kernel.hpp"
 #include "../ctrl/controller.hpp"
+#include "../util/field-file.hpp"
+#include "../util/byte-stream.hpp"
 
 namespace {
-	constexpr char AKTOR_TYPE[] = "aktor";
-	constexpr char WATER_TYPE[] = "water";
-	constexpr char DETER_PROPERTY[] = "deter";
-	constexpr char EVENT_PROPERTY[] = "event";
-	constexpr char FLAGS_PROPERTY[] = "flags";
-	constexpr char ID_PROPERTY[] = "id";
-
-	void props_to_aktor_(
-		const std::vector<tmx::Property>& properties,
-		udx& deter,
-		std::string& event,
-		u32& flags,
-		i32& id
-	) {
-		for (auto&& prop : properties) {
-			auto& name = prop.getName();
-			if (name == DETER_PROPERTY) {
-				deter = tmx_convert::prop_to_udx(prop);
-			}
-			if (name == EVENT_PROPERTY) {
-				event = tmx_convert::prop_to_string(prop);
-			}
-			if (name == FLAGS_PROPERTY) {
-				flags = tmx_convert::prop_to_uint(prop);
-			}
-			if (name == ID_PROPERTY) {
-				id = tmx_convert::prop_to_int(prop);
-			}
-		}
+	struct output_archive_ {
+		byte_writer& stream;
+	public:
+		template<typename T>
+		void operator()(const T& value) { stream.put(value); }
+		void operator()(const ecs::sprite& value) { value.dump(stream); }
+	};
+
+	struct input_archive_ {
+		byte_reader& stream;
+		bool result { true };
+	public:
+		// failed reads leave zeroes behind, which also ends entt's loops
+		template<typename T>
+		void operator()(T& value) { result = stream.get(value) and result; }
+		void operator()(ecs::sprite& value) { result = value.load(stream) and result; }
+	};
+
+	// both directions have to agree on this order
+	template<typename Snapshot, typename Archive>
+	void archive_(Snapshot&& snapshot, Archive& archive) {
+		snapshot
+			.template get<entt::entity>(archive)
+			.template get<ecs::aktor>(archive)
+			.template get<ecs::location>(archive)
+			.template get<ecs::direction>(archive)
+			.template get<ecs::trigger>(archive)
+			.template get<ecs::chroniker>(archive)
+			.template get<ecs::health>(archive)
+			.template get<ecs::kinematics>(archive)
+			.template get<ecs::anchor>(archive)
+			.template get<ecs::submersible>(archive)
+			.template get<ecs::liquid>(archive)
+			.template get<ecs::sprite>(archive)
+			.template get<ecs::blinker>(archive)
+			.template get<ecs::thinker>(archive)
+			.template get<ecs::script_thinker>(archive)
+			.template get<shoshi_state>(archive);
 	}
 }
 
@@ -68,6 +80,9 @@ void environment::handle(kernel& knl, headsup& hud, camera& cam, player& plr, co
 		}
 		spawns_.clear();
 	}
+}
+
+void environment::settle() {
 	if (redraw_) {
 		redraw_ = false;
 		registry_.sort<ecs::sprite>(
@@ -122,36 +137,82 @@ entt::entity environment::search(i32 id) const {
 	return entt::null;
 }
 
-void environment::load(const tmx::ObjectGroup& data, const controller& ctl, kernel& knl) {
-	auto& objects = data.getObjects();
-	for (auto&& obj : objects) {
-		if (auto& type = obj.getType(); type == AKTOR_TYPE) {
-			udx deter = 0;
-			std::string event {};
-			u32 flags = 0;
-			i32 id = 0;
-			props_to_aktor_(
-				obj.getProperties(),
-				deter, event,
-				flags, id
-			);
-			if (ctl.flag_at(deter) != ecs::trigger::will_deter(flags)) {
-				continue;
-			}
-			auto& name = obj.getName();
-			const glm::vec2 position = tmx_convert::vec2_to_vec2(obj.getPosition());
-			if (!this->create_(name, position, flags, id)) {
-				continue;
-			}
-			if (!event.empty()) {
-				knl.push(id, event);
-			}
-		} else if (type == WATER_TYPE) {
-			const rect hitbox = tmx_convert::rect_to_rect(obj.getAABB());
+void environment::load(const field_file& data, const controller& ctl, kernel& knl) {
+	++generation_;
+	// liquids go in between aktors, in the order the description lists them
+	auto& liquids = data.liquids();
+	udx next = 0;
+	auto flow = [this, &liquids, &next](udx order) {
+		for (; next < liquids.size() and liquids[next].order <= order; ++next) {
 			auto e = this->allocate();
-			this->emplace<ecs::liquid>(e, hitbox);
+			this->emplace<ecs::liquid>(e, liquids[next].hitbox);
+		}
+	};
+	auto& aktors = data.aktors();
+	for (udx idx = 0; idx < aktors.size(); ++idx) {
+		flow(idx);
+		auto& aktor = aktors[idx];
+		if (ctl.flag_at(aktor.deter) != ecs::trigger::will_deter(aktor.flags)) {
+			continue;
+		}
+		if (!this->create_(aktor)) {
+			continue;
+		}
+		if (!aktor.event.empty()) {
+			knl.push(aktor.id, aktor.event);
 		}
 	}
+	flow(aktors.size());
+}
+
+std::vector<std::string> environment::animations(const std::vector<std::string>& aktors) const {
+	std::vector<std::string> result {};
+	for (auto&& name : aktors) {
+		const entt::hashed_string type { name.c_str() };
+		if (const auto iter = ctors_.find(type.value()); iter != ctors_.end()) {
+			for (auto&& animation : iter->second.animations) {
+				result.emplace_back(animation.data());
+			}
+		}
+	}
+	return result;
+}
+
+void environment::snapshot(std::vector<byte>& buffer) const {
+	byte_writer stream {};
+	// keep the previous allocation around
+	stream.buffer = std::move(buffer);
+	stream.buffer.clear();
+	// names, thinkers and animations are archived as the pointers they hold,
+	// which only stay valid until the next transfer
+	stream.put(generation_);
+	output_archive_ archive { stream };
+	archive_(entt::basic_snapshot<registry_type>{ registry_ }, archive);
+	buffer = std::move(stream.buffer);
+}
+
+bool environment::restore(const std::vector<byte>& buffer) {
+	// snapshots only load into an empty registry, and a bad one shouldn't
+	// cost the current state
+	registry_type registry {};
+	byte_reader stream { buffer };
+	u64 generation = 0;
+	if (!stream.get(generation) or generation != generation_) {
+		spdlog::error("Environment snapshot was taken before the last transfer!");
+		return false;
+	}
+	input_archive_ archive { stream };
+	archive_(entt::basic_snapshot_loader<registry_type>{ registry }, archive);
+	if (!archive.result or stream.cursor != buffer.size()) {
+		spdlog::error("Environment snapshot is malformed!");
+		return false;
+	}
+	registry_ = std::move(registry);
+	registry_.on_construct<ecs::sprite>()
+		.connect<&environment::redraw>(*this);
+	spawns_.clear();
+	redraw_ = true;
+	return true;
 }
 
 udx environment::length() const {
@@ -221,7 +282,27 @@ void environment::think(i32 id, u32 state) {
 			auto& thk = this->get<ecs::thinker>(e);
 			thk.state = state;
 		}
+		if (trg.id == id and this->has<ecs::script_thinker>(e)) {
+			auto& thk = this->get<ecs::script_thinker>(e);
+			thk.state = state;
+		}
+	});
+}
+
+bool environment::script(i32 id, u32 type) {
+	bool result = false;
+	this->slice<ecs::trigger>().each(
+	[this, id, type, &result](const entt::entity e, ecs::trigger& trg) {
+		if (trg.id == id) {
+			// scripts replace whatever native behavior the aktor had
+			this->remove<ecs::thinker>(e);
+			auto& thk = this->emplace<ecs::script_thinker>(e);
+			thk.type = type;
+			thk.state = 0;
+			result = true;
+		}
 	});
+	return result;
 }
 
 bool environment::fight(i32 id) {
@@ -261,7 +342,7 @@ void environment::shoot(const entt::hashed_string& type, const glm::vec2& positi
 		registry_.emplace<ecs::aktor>(e, type);
 		registry_.emplace<ecs::location>(e, position);
 		registry_.emplace<ecs::direction>(e, dir);
-		iter->second(e, *this);
+		iter->second.ctor(e, *this);
 	} else {
 		spdlog::error("Couldn't shoot aktor: \"{}\"!", type.data());
 	}
@@ -278,32 +359,33 @@ bool environment::create_(const spawn_info& info) {
 		if (info.id > 0) {
 			registry_.emplace<ecs::trigger>(e, info.id, info.mask);
 		}
-		iter->second(e, *this);
+		iter->second.ctor(e, *this);
 		return true;
 	}
 	spdlog::error("Couldn't spawn aktor: \"{}\"!", info.type.data());
 	return false;
 }
 
-bool environment::create_(const std::string& name, const glm::vec2& position, u32 flags, i32 id) {
-	const entt::hashed_string entry { name.c_str() };
-	if (const auto iter = ctors_.find(entry.value()); iter != ctors_.end()) {
+bool environment::create_(const field_aktor& info) {
+	// type is hashed when the field is compiled, and the table entry holds
+	// the same hash with its literal name
+	if (const auto iter = ctors_.find(info.type); iter != ctors_.end()) {
 		// allocate
 		auto e = this->allocate();
-		registry_.emplace<ecs::aktor>(e, entry);
-		registry_.emplace<ecs::location>(e, position);
-		if (id > 0) {
-			registry_.emplace<ecs::trigger>(e, id, flags);
+		registry_.emplace<ecs::aktor>(e, iter->second.type);
+		registry_.emplace<ecs::location>(e, info.position);
+		if (info.id > 0) {
+			registry_.emplace<ecs::trigger>(e, info.id, info.flags);
 		}
 		// construct
-		iter->second(e, *this);
+		iter->second.ctor(e, *this);
 		// aftermath
-		if (ecs::trigger::will_face_left(flags) and this->has<ecs::sprite>(e)) {
+		if (ecs::trigger::will_face_left(info.flags) and this->has<ecs::sprite>(e)) {
 			auto& spt = this->get<ecs::sprite>(e);
 			spt.mirror.horizontally = true;
 		}
 		return true;
 	}
-	spdlog::error("Couldn't spawn aktor: \"{}\"!", name);
+	spdlog::error("Couldn't spawn aktor: \"{}\"!", info.name);
 	return false;
 }
@@ -1,16 +1,20 @@
 #pragma once
 
+#include <string>
+#include <vector>
 #include <entt/entity/registry.hpp>
+#include <apostellein/rect.hpp>
 
 #include "../ecs/thinker.hpp"
-#include "../util/tmx-convert.hpp"
+#include "../util/memory-tracker.hpp"
 
-struct rect;
 struct renderer;
 struct headsup;
 struct controller;
 struct kernel;
 struct tile_map;
+struct field_file;
+struct field_aktor;
 
 namespace ecs {
 	enum class direction;
@@ -55,16 +59,21 @@ struct spawn_info {
 
 struct environment {
 public:
+	using registry_type = entt::basic_registry<entt::entity, tracked_allocator<entt::entity, memory_tag::registry>>;
 	void build();
 	void clear();
 	void prepare();
 	void handle(kernel& knl, headsup& hud, camera& cam, player& plr, const tile_map& map);
+	void settle();
 	void update(i64 delta);
 	void render(r32 ratio, const rect& view, renderer& rdr) const;
 	entt::entity search(const entt::hashed_string& type) const;
 	entt::entity search(i32 id) const;
 	entt::entity allocate() { return registry_.create(); }
-	void load(const tmx::ObjectGroup& data, const controller& ctl, kernel& knl);
+	void load(const field_file& data, const controller& ctl, kernel& knl);
+	std::vector<std::string> animations(const std::vector<std::string>& aktors) const;
+	void snapshot(std::vector<byte>& buffer) const;
+	bool restore(const std::vector<byte>& buffer);
 	bool valid(entt::entity e) const { return e != entt::null and registry_.valid(e); }
 	udx length() const;
 	udx alive() const;
@@ -79,12 +88,14 @@ public:
 	decltype(auto) emplace(entt::entity e, Args&& ...args) {
 		return registry_.get_or_emplace<T>(e, std::forward<Args>(args)...);
 	}
+	template<typename... T> void remove(entt::entity e) { registry_.remove<T...>(e); }
 	void dispose(entt::entity e);
 	void kill(i32 id);
 	void smoke(const glm::vec2& position, udx count);
 	void shrapnel(const glm::vec2& position, udx count);
 	void animate(i32 id, udx state, udx variation);
 	void think(i32 id, u32 state);
+	bool script(i32 id, u32 type);
 	bool fight(i32 id);
 	bool still(i32 id) const;
 	void redraw() { redraw_ = true; }
@@ -98,8 +109,8 @@ public:
 		const glm::vec2& position,
 		const glm::vec2& velocity
 	) { spawns_.emplace_back(type, position, velocity); }
-	bool try_spawn(const std::string& name, r32 x, r32 y, i32 id) {
-		const entt::hashed_string type { name.c_str() };
+	bool try_spawn(const entt::hashed_string& type, r32 x, r32 y, i32 id) {
+		// type has to outlive the spawn, so it's expected to be interned
 		if (auto it = ctors_.find(type.value()); it != ctors_.end()) {
 			const glm::vec2 position { x, y };
 			spawns_.emplace_back(type, position, id);
@@ -110,9 +121,10 @@ public:
 	void shoot(const entt::hashed_string& type, const glm::vec2& position, ecs::direction dir);
 private:
 	bool create_(const spawn_info& info);
-	bool create_(const std::string& name, const glm::vec2& position, u32 flags, i32 id);
+	bool create_(const field_aktor& info);
 	bool redraw_ {};
-	entt::registry registry_ {};
+	u64 generation_ {};
+	registry_type registry_ {};
 	std::vector<spawn_info> spawns_ {};
 	ecs::thinker_ctor_table ctors_ {};
 };
@@ -1,4 +1,3 @@
-#include <nlohmann/json.hpp>
 #include <spdlog/spdlog.h>
 #include <glm/gtc/constants.hpp>
 #include <apostellein/konst.hpp>
@@ -21,6 +20,7 @@
 #include "../menu/headsup.hpp"
 #include "../util/buttons.hpp"
 #include "../util/id-table.hpp"
+#include "../util/save-file.hpp"
 #include "../hw/audio.hpp"
 
 namespace {
@@ -73,10 +73,6 @@ namespace {
 	constexpr i32 ATTACK_TIMER = 8;
 	constexpr i32 POISON_LEVEL_ONE = 350;
 	constexpr i32 POISON_LEVEL_TWO = 650;
-	constexpr char BARRIER_ENTRY[] = "Barrier";
-	constexpr char POISON_ENTRY[] = "Poison";
-	constexpr char EQUIPMENT_ENTRY[] = "Equipment";
-	constexpr char POSITION_ENTRY[] = "Position";
 }
 
 namespace player_anim {
@@ -194,7 +190,7 @@ void player::clear(environment& env) {
 	viewpoint_ = {};
 }
 
-void player::read(const nlohmann::json& data, environment& env) {
+void player::read(const save_file& data, environment& env) {
 	auto s = this->entity();
 	auto [loc, kin, spt, hel, sub] = env.get<
 		ecs::location,
@@ -204,60 +200,27 @@ void player::read(const nlohmann::json& data, environment& env) {
 		ecs::submersible
 	>(s);
 
-	if (
-		data.contains(BARRIER_ENTRY) and
-		data[BARRIER_ENTRY].is_array() and
-		data[BARRIER_ENTRY].size() == 2 and
-		data[BARRIER_ENTRY][0].is_number_unsigned() and
-		data[BARRIER_ENTRY][1].is_number_unsigned()
-	) {
+	// a missing barrier means a fresh save
+	if (data.maximum > 0) {
 		hel.maximum = glm::clamp(
-			data[BARRIER_ENTRY][0].get<i32>(),
+			data.maximum,
 			ABSOLUTE_STARTING_BARRIER,
 			ABSOLUTE_MAXIMUM_BARRIER
 		);
 		hel.current = glm::clamp(
-			data[BARRIER_ENTRY][1].get<i32>(),
+			data.barrier,
 			0, hel.maximum
 		);
 	} else {
 		hel.maximum = ABSOLUTE_STARTING_BARRIER;
 		hel.current = ABSOLUTE_STARTING_BARRIER;
 	}
-	if (
-		data.contains(POISON_ENTRY) and
-		data[POISON_ENTRY].is_number_unsigned()
-	) {
-		hel.poison = glm::clamp(
-			data[POISON_ENTRY].get<i32>(),
-			0, ABSOLUTE_MAXIMUM_POISON
-		);
-	} else {
-		hel.poison = 0;
-	}
-	if (
-		data.contains(POSITION_ENTRY) and
-		data[POSITION_ENTRY].is_array() and
-		data[POSITION_ENTRY].size() == 2 and
-		data[POSITION_ENTRY][0].is_number() and
-		data[POSITION_ENTRY][1].is_number()
-	) {
-		loc.position = {
-			data[POSITION_ENTRY][0].get<r32>() * konst::TILE<r32>(),
-			data[POSITION_ENTRY][1].get<r32>() * konst::TILE<r32>()
-		};
-	} else {
-		loc.position = {};
-	}
-	if (
-		data.contains(EQUIPMENT_ENTRY) and
-		data[EQUIPMENT_ENTRY].is_string()
-	) {
-		const std::string hex = data[EQUIPMENT_ENTRY].get<std::string>();
-		equips_._raw = as<u32>(std::strtoul(hex.c_str(), nullptr, 0));
-	} else {
-		equips_._raw = {};
-	}
+	hel.poison = glm::clamp(
+		data.poison,
+		0, ABSOLUTE_MAXIMUM_POISON
+	);
+	loc.position = data.position * konst::TILE<r32>();
+	equips_._raw = data.equipment;
 	kin.clear();
 	kin.flags.bottom = true;
 	spt.clear();
@@ -279,23 +242,15 @@ void player::read(const nlohmann::json& data, environment& env) {
 	viewpoint_ = {};
 }
 
-void player::write(nlohmann::json& data, const environment& env) const {
+void player::write(save_file& data, const environment& env) const {
 	auto s = this->entity();
 	auto& hel = env.get<ecs::health>(s);
-	data[BARRIER_ENTRY] = nlohmann::json::array({
-		hel.maximum,
-		hel.current
-	});
-	data[POISON_ENTRY] = hel.poison;
+	data.maximum = hel.maximum;
+	data.barrier = hel.current;
+	data.poison = hel.poison;
 	auto& loc = env.get<ecs::location>(s);
-	data[POSITION_ENTRY] = nlohmann::json::array({
-		loc.position.x / konst::TILE<r32>(),
-		loc.position.y / konst::TILE<r32>()
-	});
-	data[EQUIPMENT_ENTRY] = fmt::format(
-		"{:#010x}", // 0x00000000
-		equips_._raw.value()
-	);
+	data.position = loc.position / konst::TILE<r32>();
+	data.equipment = equips_._raw.value();
 }
 
 void player::transfer(i32 id, camera& cam, environment& env) {
@@ -518,7 +473,7 @@ void player::handle(
 	this->do_physics_(kin);
 	this->do_water_(env, sub);
 	this->do_camera_(kin);
-	this->do_death_(knl, kin, hel, sub);
+	this->do_death_(ctl, knl, kin, hel, sub);
 	this->do_animate_(spt, hel);
 	this->do_headsup_(hud, hel, sub);
 }
@@ -1087,10 +1042,13 @@ void player::do_animate_(ecs::sprite& spt, const ecs::health& hel) {
 	}
 }
 
-void player::do_death_(kernel& knl, const ecs::kinematics& kin, const ecs::health& hel, const ecs::submersible& sub) {
+void player::do_death_(controller& ctl, kernel& knl, const ecs::kinematics& kin, const ecs::health& hel, const ecs::submersible& sub) {
 	if (!knl.running()) {
 		if (const auto death = this->death_type(kin, hel, sub); death > 0) {
-			knl.run_death(death);
+			// without a death event there's nothing to ask, so rewind straight away
+			if (!knl.run_death(death)) {
+				ctl.retry();
+			}
 		}
 	}
 }
@@ -1,7 +1,6 @@
 #pragma once
 
 #include <entt/entity/fwd.hpp>
-#include <nlohmann/json_fwd.hpp>
 #include <apostellein/struct.hpp>
 
 struct buttons;
@@ -12,6 +11,7 @@ struct environment;
 struct camera;
 struct kernel;
 struct controller;
+struct save_file;
 
 namespace ecs {
 	struct location;
@@ -145,8 +145,8 @@ struct player {
 public:
 	bool build(environment& env);
 	void clear(environment& env);
-	void read(const nlohmann::json& data, environment& env);
-	void write(nlohmann::json& data, const environment& env) const;
+	void read(const save_file& data, environment& env);
+	void write(save_file& data, const environment& env) const;
 	void transfer(i32 id, camera& cam, environment& env);
 	void damage(entt::entity o, environment& env);
 	void solid(entt::entity o, environment& env, const tile_map& map);
@@ -197,7 +197,7 @@ private:
 	void do_physics_(ecs::kinematics& kin);
 	void do_water_(const environment& env, ecs::submersible& sub);
 	void do_animate_(ecs::sprite& spt, const ecs::health& hel);
-	void do_death_(kernel& knl, const ecs::kinematics& kin, const ecs::health& hel, const ecs::submersible& sub);
+	void do_death_(controller& ctl, kernel& knl, const ecs::kinematics& kin, const ecs::health& hel, const ecs::submersible& sub);
 	void do_headsup_(headsup& hud, const ecs::health& hel, const ecs::submersible& sub);
 	player_flags flags_ {};
 	player_equips equips_ {};
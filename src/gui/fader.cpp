@@ -10,30 +10,32 @@ namespace {
 
 void gui::fader::clear() {
 	type_ = fade_type::done_out;
-	current_ = konst::WINDOW_DIMENSIONS<r32>();
-	previous_ = konst::WINDOW_DIMENSIONS<r32>();
+	history_.reset(konst::WINDOW_DIMENSIONS<r32>());
 }
 
 void gui::fader::handle() {
+	glm::vec2 next = history_.current();
 	switch (type_) {
 		case fade_type::done_in:
 		case fade_type::done_out: {
 			break;
 		}
 		case fade_type::moving_in: {
-			current_.y -= INCREMENTATION;
-			if (current_.y < 0.0f) {
+			next.y -= INCREMENTATION;
+			if (next.y < 0.0f) {
 				type_ = fade_type::done_in;
-				current_.y = 0.0f;
+				next.y = 0.0f;
 			}
+			history_.push(next);
 			break;
 		}
 		case fade_type::moving_out: {
-			current_.y += INCREMENTATION;
-			if (current_.y > konst::WINDOW_HEIGHT<r32>()) {
+			next.y += INCREMENTATION;
+			if (next.y > konst::WINDOW_HEIGHT<r32>()) {
 				type_ = fade_type::done_out;
-				current_.y = konst::WINDOW_HEIGHT<r32>();
+				next.y = konst::WINDOW_HEIGHT<r32>();
 			}
+			history_.push(next);
 			break;
 		}
 	}
@@ -46,21 +48,17 @@ void gui::fader::render(r32 ratio, renderer& rdr) const {
 			blending_type::alpha,
 			pipeline_type::blank
 		);
-		const glm::vec2 dimensions = konst::INTERPOLATE(
-			previous_,
-			current_,
-			ratio
-		);
+		const glm::vec2 dimensions = history_.at(ratio);
 		list.batch_blank(dimensions, chroma::BASE());
 	}
 }
 
 void gui::fader::fade_in() {
 	type_ = fade_type::moving_in;
-	current_.y = konst::WINDOW_HEIGHT<r32>();
+	history_.reset({ history_.current().x, konst::WINDOW_HEIGHT<r32>() });
 }
 
 void gui::fader::fade_out() {
 	type_ = fade_type::moving_out;
-	current_.y = 0.0f;
+	history_.reset({ history_.current().x, 0.0f });
 }
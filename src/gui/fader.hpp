@@ -3,6 +3,8 @@
 #include <apostellein/def.hpp>
 #include <glm/vec2.hpp>
 
+#include "../x2d/transform-history.hpp"
+
 struct renderer;
 
 namespace gui {
@@ -16,7 +18,7 @@ namespace gui {
 		void clear();
 		void prepare() {
 			if (this->visible()) {
-				previous_ = current_;
+				history_.prepare();
 			}
 		}
 		void handle();
@@ -28,7 +30,6 @@ namespace gui {
 		bool visible() const { return type_ != fade_type::done_in; }
 	private:
 		fade_type type_ { fade_type::done_out };
-		glm::vec2 previous_ {};
-		glm::vec2 current_ {};
+		transform_history history_ {};
 	};
 }
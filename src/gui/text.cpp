@@ -77,7 +77,7 @@ void gui::text::build(
 void gui::text::clear() {
 	invalidated_ = true;
 	letter_ = 0;
-	buffer_.clear();
+	this->reset_();
 	vertices_.clear();
 }
 
@@ -101,8 +101,8 @@ void gui::text::position(glm::vec2 value) {
 	value = glm::round(value);
 	if (position_ != value) {
 		invalidated_ = true;
+		this->translate_(value - position_);
 		position_ = value;
-		this->generate_attributes_();
 	}
 }
 
@@ -110,8 +110,8 @@ void gui::text::origin(glm::vec2 value) {
 	value = glm::round(value);
 	if (origin_ != value) {
 		invalidated_ = true;
+		this->translate_(origin_ - value);
 		origin_ = value;
-		this->generate_attributes_();
 	}
 }
 
@@ -151,46 +151,66 @@ rect gui::text::bounds() const {
 	return {};
 }
 
-udx gui::text::drawable() const {
+void gui::text::reset_() {
+	buffer_.clear();
+	drawable_ = 0;
+	laid_ = 0;
+	quads_ = 0;
+	pen_ = {};
+	previous_ = U'\0';
+}
+
+void gui::text::relayout_() {
+	laid_ = 0;
+	quads_ = 0;
+	pen_ = {};
+	previous_ = U'\0';
+	this->generate_quads_();
+}
+
+void gui::text::extend_(udx first, bool immediate) {
 	const auto result = std::count_if(
-		buffer_.begin(), buffer_.end(),
+		buffer_.begin() + as<std::ptrdiff_t>(first), buffer_.end(),
 		[](auto c) { return c == U'\n' or c == U'\t'; }
 	);
-	return buffer_.size() - as<udx>(result);
+	drawable_ += buffer_.size() - first - as<udx>(result);
+	if (immediate or letter_ > drawable_) {
+		letter_ = drawable_;
+	}
+	this->generate_quads_();
 }
 
 void gui::text::generate_quads_() {
-	if (font_ and !buffer_.empty()) {
-		const auto length = this->drawable();
-		if (length * display_list::QUAD > vertices_.size()) {
-			vertices_.resize(length * display_list::QUAD);
+	if (font_ and laid_ < buffer_.size()) {
+		if (drawable_ * display_list::QUAD > vertices_.size()) {
+			vertices_.resize(drawable_ * display_list::QUAD);
 		}
-		glm::vec2 pos = position_ - origin_;
+		const glm::vec2 start = position_ - origin_;
 		const glm::vec2 dim = font_->glyph_dimensions();
 		const glm::vec2 off = font_->texture_offset();
 		const auto atlas = font_->atlas();
-		char32_t previous = U'\0';
-		udx idx = 0;
-		for (auto&& c : buffer_) {
+		for (; laid_ < buffer_.size(); ++laid_) {
+			const char32_t c = buffer_[laid_];
 			switch (c) {
 				case U'\t': {
 					auto& g = font_->glyph(U' ');
-					previous = U' ';
-					pos.x += (g.w * TAB_WIDTH);
+					previous_ = U' ';
+					pen_.x += (g.w * TAB_WIDTH);
 					break;
 				}
 				case U'\n': {
-					previous = U'\0';
-					pos.x = position_.x - origin_.x;
-					pos.y += dim.y;
+					previous_ = U'\0';
+					pen_.x = 0.0f;
+					pen_.y += dim.y;
 					break;
 				}
 				default: {
 					auto& g = font_->glyph(c);
-					const r32 k = font_->kerning(previous, c);
-					previous = c;
+					const r32 k = font_->kerning(previous_, c);
+					previous_ = c;
 
-					auto vtx = &vertices_[idx * display_list::QUAD];
+					const glm::vec2 pos = start + pen_;
+					auto vtx = &vertices_[quads_ * display_list::QUAD];
 					vtx[0].position = { pos.x + g.x_offset, pos.y + g.y_offset };
 					vtx[0].index = g.channel;
 					vtx[0].uvs = glm::vec2(g.x + off.x, g.y + off.y) / material::MAXIMUM_DIMENSIONS;
@@ -215,8 +235,8 @@ void gui::text::generate_quads_() {
 					vtx[3].atlas = atlas;
 					vtx[3].color = color_;
 
-					pos.x += (g.x_advance + k);
-					++idx;
+					pen_.x += (g.x_advance + k);
+					++quads_;
 					break;
 				}
 			}
@@ -225,45 +245,16 @@ void gui::text::generate_quads_() {
 }
 
 void gui::text::generate_attributes_() {
-	if (!buffer_.empty() and font_ and !vertices_.empty()) {
-		glm::vec2 pos = position_ - origin_;
-		const glm::vec2 dim = font_->glyph_dimensions();
-		char32_t previous = U'\0';
-		udx idx = 0;
-		for (auto&& c : buffer_) {
-			switch (c) {
-				case U'\t': {
-					auto& g = font_->glyph(U' ');
-					previous = U' ';
-					pos.x += (g.w * TAB_WIDTH);
-					break;
-				}
-				case U'\n': {
-					previous = U'\0';
-					pos.x = position_.x - origin_.x;
-					pos.y += dim.y;
-					break;
-				}
-				default: {
-					auto& g = font_->glyph(c);
-					const r32 k = font_->kerning(previous, c);
-					previous = c;
-
-					auto vtx = &vertices_[idx * display_list::QUAD];
-					vtx[0].position = { pos.x + g.x_offset, pos.y + g.y_offset };
-					vtx[0].color = color_;
-					vtx[1].position = { pos.x + g.x_offset, pos.y + g.y_offset + g.h };
-					vtx[1].color = color_;
-					vtx[2].position = { pos.x + g.x_offset + g.w, pos.y + g.y_offset };
-					vtx[2].color = color_;
-					vtx[3].position = { pos.x + g.x_offset + g.w, pos.y + g.y_offset + g.h };
-					vtx[3].color = color_;
+	const auto length = quads_ * display_list::QUAD;
+	for (udx it = 0; it < length; ++it) {
+		vertices_[it].color = color_;
+	}
+}
 
-					pos.x += (g.x_advance + k);
-					++idx;
-					break;
-				}
-			}
-		}
+void gui::text::translate_(const glm::vec2& offset) {
+	// layout is relative to position - origin, so moving doesn't need the font
+	const auto length = quads_ * display_list::QUAD;
+	for (udx it = 0; it < length; ++it) {
+		vertices_[it].position += offset;
 	}
 }
@@ -26,7 +26,7 @@ namespace gui {
 		void fix(const bitmap_font* font) {
 			invalidated_ = true;
 			font_ = font;
-			this->generate_quads_();
+			this->relayout_();
 		}
 		void handle() {
 			if (!this->finished()) {
@@ -37,43 +37,29 @@ namespace gui {
 		void render(renderer& rdr) const;
 		void append(const std::string& words, bool immediate = true) {
 			invalidated_ = true;
+			const auto first = buffer_.size();
 			gui::unicode(words, buffer_);
-			const auto length = this->drawable();
-			if (immediate or letter_ > length) {
-				letter_ = length;
-			}
-			this->generate_quads_();
+			this->extend_(first, immediate);
 		}
 		void replace(const std::string& words, bool immediate = true) {
-			buffer_.clear();
+			this->reset_();
 			this->append(words, immediate);
 		}
 		void append(const std::u32string& words, bool immediate = true) {
 			invalidated_ = true;
+			const auto first = buffer_.size();
 			buffer_.append(words);
-			const auto length = this->drawable();
-			if (immediate or letter_ > length) {
-				letter_ = length;
-			}
-			this->generate_quads_();
+			this->extend_(first, immediate);
 		}
 		void replace(const std::u32string& words, bool immediate = true) {
-			invalidated_ = true;
-			buffer_ = words;
-			const auto length = this->drawable();
-			if (immediate or letter_ > length) {
-				letter_ = length;
-			}
-			this->generate_quads_();
+			this->reset_();
+			this->append(words, immediate);
 		}
 		void forward(std::u32string&& words, bool immediate = true) {
 			invalidated_ = true;
+			this->reset_();
 			buffer_ = std::move(words);
-			const auto length = this->drawable();
-			if (immediate or letter_ > length) {
-				letter_ = length;
-			}
-			this->generate_quads_();
+			this->extend_(0, immediate);
 		}
 		void position(glm::vec2 value);
 		void position(r32 x, r32 y) {
@@ -98,17 +84,27 @@ namespace gui {
 		glm::vec2 font_dimensions() const;
 		const bitmap_font* font() const { return font_; }
 		rect bounds() const;
-		bool finished() const { return letter_ >= this->drawable(); }
-		udx drawable() const;
+		bool finished() const { return letter_ >= drawable_; }
+		udx drawable() const { return drawable_; }
 	private:
+		void reset_();
+		void relayout_();
+		void extend_(udx first, bool immediate);
 		void generate_quads_();
 		void generate_attributes_();
+		void translate_(const glm::vec2& offset);
 		mutable bool invalidated_ {};
 		glm::vec2 position_ {};
 		glm::vec2 origin_ {};
 		chroma color_ { chroma::WHITE() };
 		udx letter_ {};
+		udx drawable_ {};
 		std::u32string buffer_ {};
+		// layout picks up from here, so appending only lays out the new glyphs
+		udx laid_ {};
+		udx quads_ {};
+		glm::vec2 pen_ {};
+		char32_t previous_ {};
 		const bitmap_font* font_ {};
 		std::vector<vtx_sprite> vertices_ {};
 	};
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <memory>
 #include <spdlog/spdlog.h>
 #include <apostellein/konst.hpp>
@@ -8,10 +9,20 @@
 #include "../audio/openal.hpp"
 #include "../audio/noise-buffer.hpp"
 #include "../audio/speaker.hpp"
+#include "../audio/software-mixer.hpp"
 #include "../util/config-file.hpp"
 
 namespace {
-	constexpr udx MAXIMUM_SPEAKERS = 12;
+	constexpr udx MAXIMUM_CHANNELS = 12;
+	constexpr udx MAXIMUM_VOICES = 20;
+	constexpr udx MAXIMUM_INSTANCES = 4;
+	constexpr udx INVALID_CHANNEL = static_cast<udx>(-1);
+	constexpr i32 MAXIMUM_SAMPLING_RATE = 44100;
+	constexpr char OPENAL_BACKEND[] = "openal";
+	constexpr char MIXER_BACKEND[] = "mixer";
+	constexpr char CAPTURE_BACKEND[] = "capture";
+	constexpr char NULL_BACKEND[] = "null";
+	constexpr char CAPTURE_NAME[] = "capture";
 }
 
 // private
@@ -22,9 +33,23 @@ namespace audio {
 		task_info(const noise_buffer* _payload, udx _index) noexcept :
 			payload{ _payload },
 			index{ _index } {}
+		task_info(const noise_buffer* _payload, priority _level, r32 _gain) noexcept :
+			payload{ _payload },
+			index{ INVALID_CHANNEL },
+			level{ _level },
+			gain{ _gain } {}
 
 		const noise_buffer* payload {};
 		udx index {};
+		priority level { priority::normal };
+		r32 gain { 1.0f };
+	};
+	struct voice_info {
+		const noise_buffer* payload {};
+		priority level {};
+		r32 gain {};
+		u64 stamp {};
+		bool active {};
 	};
 	// driver
 	struct driver {
@@ -33,7 +58,14 @@ namespace audio {
 		ALCdevice* device {};
 		ALCcontext* context {};
 		std::vector<speaker> speakers {};
+		std::vector<voice_info> voices {};
 		std::vector<task_info> tasks {};
+		std::vector<udx> assigned {};
+		std::vector<speaker*> halts {};
+		std::vector<speaker*> starts {};
+		std::unique_ptr<software_mixer> mixer {};
+		statistics stats {};
+		u64 stamp {};
 		r32 volume {};
 	};
 	std::unique_ptr<driver> drv_ {};
@@ -51,38 +83,78 @@ namespace audio {
 		drv_->config = &cfg;
 		drv_->volume = glm::clamp(cfg.audio_volume(), 0.0f, 1.0f);
 
-		// Create device & context
-		if (drv_->device = alcOpenDevice(nullptr); !drv_->device) {
-			spdlog::critical("Audio device creation failed!");
-			return false;
-		}
-		if (drv_->context = alcCreateContext(drv_->device, nullptr); !drv_->context) {
-			spdlog::critical("Audio context creation failed!");
-			return false;
-		}
-		if (alcMakeContextCurrent(drv_->context) == 0) {
-			spdlog::critical("Audio context cannot activate!");
-			return false;
-		}
-		if (!oal::load_extensions(drv_->device)) {
-			spdlog::critical("OpenAL extensions cannot load!");
-			return false;
+		if (const auto backend = cfg.audio_backend(); backend != OPENAL_BACKEND) {
+			// Create software mixer
+			mixer_sink sink = mixer_sink::device;
+			std::string path {};
+			if (backend == CAPTURE_BACKEND) {
+				sink = mixer_sink::file;
+				path = vfs::capture_path(CAPTURE_NAME);
+			} else if (backend == NULL_BACKEND) {
+				sink = mixer_sink::null;
+			} else if (backend != MIXER_BACKEND) {
+				spdlog::warn("Audio backend \"{}\" doesn't exist! Using software mixer instead.", backend);
+			}
+			i32 sampling_rate = cfg.sampling_rate();
+			if (
+				sampling_rate != MAXIMUM_SAMPLING_RATE / 4 and
+				sampling_rate != MAXIMUM_SAMPLING_RATE / 2 and
+				sampling_rate != MAXIMUM_SAMPLING_RATE
+			) {
+				sampling_rate = MAXIMUM_SAMPLING_RATE;
+			}
+			drv_->mixer = std::make_unique<software_mixer>();
+			if (!drv_->mixer->create(sink, sampling_rate, path)) {
+				spdlog::critical("Software mixer creation failed!");
+				return false;
+			}
+		} else {
+			// Create device & context
+			if (drv_->device = alcOpenDevice(nullptr); !drv_->device) {
+				spdlog::critical("Audio device creation failed!");
+				return false;
+			}
+			if (drv_->context = alcCreateContext(drv_->device, nullptr); !drv_->context) {
+				spdlog::critical("Audio context creation failed!");
+				return false;
+			}
+			if (alcMakeContextCurrent(drv_->context) == 0) {
+				spdlog::critical("Audio context cannot activate!");
+				return false;
+			}
+			if (!oal::load_extensions(drv_->device)) {
+				spdlog::critical("OpenAL extensions cannot load!");
+				return false;
+			}
 		}
 
 		// Create speakers
-		drv_->speakers.resize(MAXIMUM_SPEAKERS);
+		// dedicated channels come first, followed by the pooled voices
+		drv_->speakers.resize(MAXIMUM_CHANNELS + MAXIMUM_VOICES);
 		for (auto&& speak : drv_->speakers) {
 			speak.create();
 			speak.volume(drv_->volume);
 		}
+		drv_->voices.resize(MAXIMUM_VOICES);
+		drv_->stats.voices = MAXIMUM_VOICES;
 
 		// Preallocate tasks
-		drv_->tasks.reserve(MAXIMUM_SPEAKERS);
+		drv_->tasks.reserve(MAXIMUM_CHANNELS + MAXIMUM_VOICES);
+		drv_->assigned.reserve(MAXIMUM_CHANNELS + MAXIMUM_VOICES);
+		drv_->halts.reserve(MAXIMUM_CHANNELS + MAXIMUM_VOICES);
+		drv_->starts.reserve(MAXIMUM_CHANNELS + MAXIMUM_VOICES);
 		return true;
 	}
 
 	void drop_() {
 		if (drv_) {
+			if (drv_->mixer) {
+				// clear buffers before releasing voices & stopping output
+				drv_->speakers.clear();
+				vfs::clear_noises();
+
+				drv_->mixer.reset();
+			}
 			if (drv_->context) {
 				// clear buffers before clearing sources & deleting context
 				drv_->speakers.clear();
@@ -99,6 +171,83 @@ namespace audio {
 		}
 	}
 
+	speaker& voice_speaker_(udx index) {
+		return drv_->speakers[MAXIMUM_CHANNELS + index];
+	}
+
+	// What the voice is putting out right now, not what it was asked for
+	r32 audible_(udx index) {
+		auto& voice = drv_->voices[index];
+		const auto& speak = audio::voice_speaker_(index);
+		return voice.gain * voice.payload->level(speak.offset());
+	}
+
+	// Voices stamped at or after origin were handed out during this flush,
+	// so they can't be handed out again until the next one
+	udx select_voice_(const task_info& task, u64 origin) {
+		// Per-buffer cap steals the oldest instance of the same buffer
+		udx instances = 0;
+		udx eldest = INVALID_CHANNEL;
+		for (udx idx = 0; idx < MAXIMUM_VOICES; ++idx) {
+			auto& voice = drv_->voices[idx];
+			if (voice.active and voice.payload == task.payload) {
+				++instances;
+				if (voice.stamp >= origin) {
+					continue;
+				}
+				if (eldest == INVALID_CHANNEL or voice.stamp < drv_->voices[eldest].stamp) {
+					eldest = idx;
+				}
+			}
+		}
+		if (instances >= MAXIMUM_INSTANCES) {
+			if (eldest != INVALID_CHANNEL) {
+				++drv_->stats.limited;
+			} else {
+				++drv_->stats.dropped;
+			}
+			return eldest;
+		}
+
+		// Free voice, otherwise lowest priority, then quietest, then oldest
+		udx victim = INVALID_CHANNEL;
+		r32 quietest = 0.0f;
+		for (udx idx = 0; idx < MAXIMUM_VOICES; ++idx) {
+			auto& voice = drv_->voices[idx];
+			if (!voice.active) {
+				return idx;
+			}
+			if (voice.level > task.level or voice.stamp >= origin) {
+				continue;
+			}
+			const r32 audible = audio::audible_(idx);
+			if (victim == INVALID_CHANNEL) {
+				victim = idx;
+				quietest = audible;
+				continue;
+			}
+			auto& other = drv_->voices[victim];
+			bool replace = false;
+			if (voice.level != other.level) {
+				replace = voice.level < other.level;
+			} else if (audible != quietest) {
+				replace = audible < quietest;
+			} else {
+				replace = voice.stamp < other.stamp;
+			}
+			if (replace) {
+				victim = idx;
+				quietest = audible;
+			}
+		}
+		if (victim != INVALID_CHANNEL) {
+			++drv_->stats.stolen;
+		} else {
+			++drv_->stats.dropped;
+		}
+		return victim;
+	}
+
 	guard::guard(config_file& cfg) {
 		if (audio::init_(cfg)) {
 			ready_ = true;
@@ -120,34 +269,37 @@ bool audio::active() {
 }
 
 void audio::play(const entt::hashed_string& id) {
+	audio::play(id, priority::normal);
+}
+
+void audio::play(const entt::hashed_string& id, priority level, r32 gain) {
 	if (!drv_) {
 		return;
 	}
-	for (auto&& speak : drv_->speakers) {
-		if (!speak.playing()) {
-			const auto index = std::distance(&drv_->speakers[0], &speak);
-			const task_info task { vfs::find_noise(id), as<udx>(index) };
-			drv_->tasks.push_back(task);
-			break;
-		}
-	}
+	const task_info task { vfs::find_noise(id), level, glm::clamp(gain, 0.0f, 1.0f) };
+	drv_->tasks.push_back(task);
+}
+
+void audio::play(const std::string& id) {
+	const entt::hashed_string entry { id.c_str() };
+	audio::play(entry);
+}
+
+void audio::play(const std::string& id, priority level, r32 gain) {
+	const entt::hashed_string entry { id.c_str() };
+	audio::play(entry, level, gain);
 }
 
 void audio::play(const entt::hashed_string& id, udx index) {
 	if (!drv_) {
 		return;
 	}
-	if (index < drv_->speakers.size()) {
+	if (index < MAXIMUM_CHANNELS) {
 		const task_info task { vfs::find_noise(id), index };
 		drv_->tasks.push_back(task);
 	}
 }
 
-void audio::play(const std::string& id) {
-	const entt::hashed_string entry { id.c_str() };
-	audio::play(entry);
-}
-
 void audio::play(const std::string& id, udx index) {
 	const entt::hashed_string entry { id.c_str() };
 	audio::play(entry, index);
@@ -157,7 +309,7 @@ void audio::pause(udx index) {
 	if (!drv_) {
 		return;
 	}
-	if (index < drv_->speakers.size()) {
+	if (index < MAXIMUM_CHANNELS) {
 		drv_->speakers[index].pause();
 	}
 }
@@ -166,7 +318,7 @@ void audio::resume(udx index) {
 	if (!drv_) {
 		return;
 	}
-	if (index < drv_->speakers.size()) {
+	if (index < MAXIMUM_CHANNELS) {
 		auto& speak = drv_->speakers[index];
 		if (speak.paused()) {
 			speak.play();
@@ -179,8 +331,12 @@ void audio::volume(r32 value) {
 		return;
 	}
 	value = glm::clamp(value, 0.0f, 1.0f);
-	for (auto&& speak : drv_->speakers) {
-		speak.volume(value);
+	drv_->volume = value;
+	for (udx idx = 0; idx < MAXIMUM_CHANNELS; ++idx) {
+		drv_->speakers[idx].volume(value);
+	}
+	for (udx idx = 0; idx < MAXIMUM_VOICES; ++idx) {
+		audio::voice_speaker_(idx).volume(value * drv_->voices[idx].gain);
 	}
 	drv_->config->audio_volume(value);
 }
@@ -189,20 +345,129 @@ r32 audio::volume() {
 	if (!drv_) {
 		return 0.0f;
 	}
-	return drv_->speakers[0].volume();
+	return drv_->volume;
 }
 
 void audio::flush() {
 	if (!drv_) {
 		return;
 	}
+
+	// Retire finished voices
+	udx active = 0;
+	for (udx idx = 0; idx < MAXIMUM_VOICES; ++idx) {
+		auto& voice = drv_->voices[idx];
+		if (voice.active) {
+			voice.active = audio::voice_speaker_(idx).playing();
+			if (voice.active) {
+				++active;
+			}
+		}
+	}
+
+	// Requests that can't play mustn't absorb later ones on the same channel
+	drv_->tasks.erase(
+		std::remove_if(drv_->tasks.begin(), drv_->tasks.end(), [](const task_info& task) {
+			return !task.payload or !task.payload->valid();
+		}),
+		drv_->tasks.end()
+	);
+
 	if (!drv_->tasks.empty()) {
-		for (auto&& task : drv_->tasks) {
-			auto& speak = drv_->speakers[task.index];
-			if (speak.bind(task.payload)) {
-				speak.play();
+		const u64 origin = drv_->stamp;
+		// Resolve every request before touching source state
+		for (udx it = 0; it < drv_->tasks.size(); ++it) {
+			auto& task = drv_->tasks[it];
+			// Same buffer requested twice in one frame only plays once
+			bool duplicate = false;
+			for (udx prev = 0; prev < it; ++prev) {
+				auto& other = drv_->tasks[prev];
+				if (task.index != INVALID_CHANNEL and other.index == task.index) {
+					// Latest request wins on a dedicated channel
+					other.payload = task.payload;
+					duplicate = true;
+					break;
+				}
+				if (other.payload == task.payload and other.index == task.index) {
+					if (task.level > other.level) {
+						other.level = task.level;
+					}
+					duplicate = true;
+					break;
+				}
+			}
+			if (duplicate) {
+				++drv_->stats.coalesced;
+				continue;
+			}
+			if (task.index != INVALID_CHANNEL) {
+				drv_->halts.push_back(&drv_->speakers[task.index]);
+				drv_->assigned.push_back(task.index);
+				continue;
+			}
+			if (const auto idx = audio::select_voice_(task, origin); idx != INVALID_CHANNEL) {
+				auto& voice = drv_->voices[idx];
+				if (voice.active) {
+					drv_->halts.push_back(&audio::voice_speaker_(idx));
+				} else {
+					++active;
+				}
+				voice.payload = task.payload;
+				voice.level = task.level;
+				voice.gain = task.gain;
+				voice.stamp = drv_->stamp++;
+				voice.active = true;
+				drv_->assigned.push_back(MAXIMUM_CHANNELS + idx);
+			}
+		}
+
+		// Batch source state changes
+		speaker::stop(drv_->halts);
+		for (auto&& slot : drv_->assigned) {
+			auto& speak = drv_->speakers[slot];
+			const noise_buffer* payload = nullptr;
+			r32 gain = 1.0f;
+			if (slot < MAXIMUM_CHANNELS) {
+				for (auto&& task : drv_->tasks) {
+					if (task.index == slot) {
+						payload = task.payload;
+						break;
+					}
+				}
+			} else {
+				auto& voice = drv_->voices[slot - MAXIMUM_CHANNELS];
+				payload = voice.payload;
+				gain = voice.gain;
+			}
+			if (speak.attach(payload)) {
+				if (slot >= MAXIMUM_CHANNELS) {
+					speak.volume(drv_->volume * gain);
+				}
+				drv_->starts.push_back(&speak);
+				++drv_->stats.played;
 			}
 		}
+		speaker::play(drv_->starts);
+
 		drv_->tasks.clear();
+		drv_->assigned.clear();
+		drv_->halts.clear();
+		drv_->starts.clear();
+	}
+	drv_->stats.active = active;
+}
+
+software_mixer* audio::mixer() {
+	if (!drv_) {
+		return nullptr;
+	}
+	return drv_->mixer.get();
+}
+
+const audio::statistics& audio::stats() {
+	static const statistics NULL_STATISTICS {};
+	if (!drv_) {
+		return NULL_STATISTICS;
 	}
+	return drv_->stats;
 }
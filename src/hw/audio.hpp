@@ -5,18 +5,39 @@
 #include <apostellein/struct.hpp>
 
 struct config_file;
+struct software_mixer;
 
 namespace audio {
+	enum class priority : i32 {
+		low,
+		normal,
+		high
+	};
+	struct statistics {
+		udx voices {};
+		udx active {};
+		udx played {};
+		udx coalesced {};
+		udx limited {};
+		udx stolen {};
+		udx dropped {};
+	};
 	bool active();
+	// pooled voice
 	void play(const entt::hashed_string& id);
-	void play(const entt::hashed_string& id, udx index);
+	void play(const entt::hashed_string& id, priority level, r32 gain = 1.0f);
 	void play(const std::string& id);
+	void play(const std::string& id, priority level, r32 gain = 1.0f);
+	// dedicated channel
+	void play(const entt::hashed_string& id, udx index);
 	void play(const std::string& id, udx index);
 	void pause(udx index);
 	void resume(udx index);
 	void volume(r32 value);
 	r32 volume();
 	void flush();
+	const statistics& stats();
+	software_mixer* mixer();
 	// Init-Guard
 	struct guard : public not_moveable {
 		guard(config_file& cfg);
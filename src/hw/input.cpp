@@ -1,3 +1,4 @@
+#include <array>
 #include <limits>
 #include <memory>
 #include <map>
@@ -5,6 +6,7 @@
 #include <spdlog/spdlog.h>
 #include <SDL2/SDL_events.h>
 #include <SDL2/SDL_gamecontroller.h>
+#include <SDL2/SDL_timer.h>
 #include <apostellein/konst.hpp>
 #include <apostellein/cast.hpp>
 
@@ -17,6 +19,7 @@ namespace {
 	constexpr i32 JOYSTICK_CODE_TRIGGER_LEFT = 29;
 	constexpr i32 JOYSTICK_CODE_TRIGGER_RIGHT = 30;
 	constexpr i16 AXIS_DEAD_ZONE = std::numeric_limits<i16>::max() / 2;
+	constexpr udx MAXIMUM_EVENTS = 256;
 }
 
 // private
@@ -33,6 +36,11 @@ namespace input {
 		bool listening_for_joystick {};
 		std::map<SDL_Scancode, u32> keyboard_bindings {};
 		std::map<i32, u32> joystick_bindings {};
+		// button events wait here until the tick they happened during
+		std::array<SDL_Event, MAXIMUM_EVENTS> events {};
+		udx first {};
+		udx count {};
+		bool latency {};
 	};
 	std::unique_ptr<driver> drv_ {};
 	// functions
@@ -130,93 +138,9 @@ namespace input {
 		}
 	}
 
-	bool init_(config_file& cfg) {
-		// Create driver
-		if (drv_) {
-			spdlog::critical("Input system already has active driver!");
-			return false;
-		}
-		drv_ = std::make_unique<driver>();
-
-		// Get config
-		drv_->config = &cfg;
-		input::init_keyboard_bindings_(cfg);
-		input::init_joystick_bindings_(cfg);
-
-		// Create joystick handle
-		if (SDL_NumJoysticks() != 0) {
-			if (drv_->device = SDL_GameControllerOpen(0); !drv_->device) {
-				spdlog::warn("Joystick couldn't open at startup! SDL Error: {}", SDL_GetError());
-			}
-		}
-
-		return true;
-	}
-
-	void drop_() {
-		if (drv_) {
-			if (drv_->device) {
-				SDL_GameControllerClose(drv_->device);
-				drv_->device = nullptr;
-			}
-			drv_.reset();
-		}
-	}
-
-	guard::guard(config_file& cfg) {
-		if (input::init_(cfg)) {
-			ready_ = true;
-		} else {
-			input::drop_();
-		}
-	}
-
-	guard::~guard() {
-		if (ready_) {
-			input::drop_();
-		}
-	}
-}
-
-// public
-void input::zero(buttons& bts) {
-	bts.pressed._raw = {};
-	bts.holding._raw = {};
-	bts.released._raw = {};
-}
-
-void input::callback(bool(*function)(const void*)) {
-	if (!drv_) {
-		return;
-	}
-	if (function) {
-		drv_->callback = function;
-	}
-}
-
-bool input::poll(activity_type& aty, buttons& bts) {
-	if (!drv_) {
-		return false;
-	}
-	SDL_Event event {};
-	while (SDL_PollEvent(&event)) {
-		if (drv_->callback) {
-			drv_->callback(&event);
-		}
+	// folds a queued event into the buttons of whichever tick it landed in
+	void apply_(const SDL_Event& event, buttons& bts) {
 		switch (event.type) {
-			case SDL_QUIT: {
-				aty = activity_type::quitting;
-				break;
-			}
-			case SDL_WINDOWEVENT: {
-				if (event.window.type == SDL_WINDOWEVENT_FOCUS_GAINED and aty == activity_type::stopped) {
-					aty = activity_type::running;
-				} else if (event.window.type == SDL_WINDOWEVENT_FOCUS_LOST and aty == activity_type::running) {
-					aty = activity_type::stopped;
-					input::zero(bts);
-				}
-				break;
-			}
 			case SDL_KEYDOWN: {
 				const auto code = event.key.keysym.scancode;
 				if (auto iter = drv_->keyboard_bindings.find(code); iter != drv_->keyboard_bindings.end()) {
@@ -225,12 +149,6 @@ bool input::poll(activity_type& aty, buttons& bts) {
 					bts.pressed._raw.set(name, !holding);
 					bts.holding._raw.set(name, true);
 				}
-				if (drv_->debugger_code and *drv_->debugger_code == code) {
-					bts.pressed.debugger = !bts.holding.debugger;
-					bts.holding.debugger = true;
-				} else if (drv_->listening_for_keyboard) {
-					drv_->stored_code = code;
-				}
 				break;
 			}
 			case SDL_KEYUP: {
@@ -240,10 +158,6 @@ bool input::poll(activity_type& aty, buttons& bts) {
 					bts.holding._raw.set(name, false);
 					bts.released._raw.set(name, true);
 				}
-				if (drv_->debugger_code and *drv_->debugger_code == code) {
-					bts.holding.debugger = false;
-					bts.released.debugger = true;
-				}
 				break;
 			}
 			case SDL_CONTROLLERAXISMOTION: {
@@ -298,9 +212,6 @@ bool input::poll(activity_type& aty, buttons& bts) {
 								bts.released._raw.set(name, true);
 							}
 						}
-						if (drv_->listening_for_joystick and event.caxis.value > AXIS_DEAD_ZONE) {
-							drv_->stored_code = code;
-						}
 					}
 				}
 				break;
@@ -346,9 +257,6 @@ bool input::poll(activity_type& aty, buttons& bts) {
 							bts.pressed._raw.set(name, !holding);
 							bts.holding._raw.set(name, true);
 						}
-						if (drv_->listening_for_joystick) {
-							drv_->stored_code = code;
-						}
 					}
 				}
 				break;
@@ -387,6 +295,171 @@ bool input::poll(activity_type& aty, buttons& bts) {
 				}
 				break;
 			}
+			default: {
+				break;
+			}
+		}
+	}
+
+	bool pressing_(const SDL_Event& event) {
+		switch (event.type) {
+			case SDL_KEYDOWN: return event.key.repeat == 0;
+			case SDL_CONTROLLERBUTTONDOWN: return true;
+			default: return false;
+		}
+	}
+
+	void enqueue_(const SDL_Event& event, buttons& bts) {
+		if (drv_->count == MAXIMUM_EVENTS) {
+			// nothing has been consumed in a while, so fold the oldest event early
+			input::apply_(drv_->events[drv_->first], bts);
+			drv_->first = (drv_->first + 1) % MAXIMUM_EVENTS;
+			--drv_->count;
+		}
+		drv_->events[(drv_->first + drv_->count) % MAXIMUM_EVENTS] = event;
+		++drv_->count;
+	}
+
+	bool init_(config_file& cfg) {
+		// Create driver
+		if (drv_) {
+			spdlog::critical("Input system already has active driver!");
+			return false;
+		}
+		drv_ = std::make_unique<driver>();
+
+		// Get config
+		drv_->config = &cfg;
+		input::init_keyboard_bindings_(cfg);
+		input::init_joystick_bindings_(cfg);
+		drv_->latency = cfg.input_latency();
+
+		// Create joystick handle
+		if (SDL_NumJoysticks() != 0) {
+			if (drv_->device = SDL_GameControllerOpen(0); !drv_->device) {
+				spdlog::warn("Joystick couldn't open at startup! SDL Error: {}", SDL_GetError());
+			}
+		}
+
+		return true;
+	}
+
+	void drop_() {
+		if (drv_) {
+			if (drv_->device) {
+				SDL_GameControllerClose(drv_->device);
+				drv_->device = nullptr;
+			}
+			drv_.reset();
+		}
+	}
+
+	guard::guard(config_file& cfg) {
+		if (input::init_(cfg)) {
+			ready_ = true;
+		} else {
+			input::drop_();
+		}
+	}
+
+	guard::~guard() {
+		if (ready_) {
+			input::drop_();
+		}
+	}
+}
+
+// public
+void input::zero(buttons& bts) {
+	bts.pressed._raw = {};
+	bts.holding._raw = {};
+	bts.released._raw = {};
+}
+
+void input::callback(bool(*function)(const void*)) {
+	if (!drv_) {
+		return;
+	}
+	if (function) {
+		drv_->callback = function;
+	}
+}
+
+bool input::poll(activity_type& aty, buttons& bts) {
+	if (!drv_) {
+		return false;
+	}
+	SDL_Event event {};
+	while (SDL_PollEvent(&event)) {
+		if (drv_->callback) {
+			drv_->callback(&event);
+		}
+		switch (event.type) {
+			case SDL_QUIT: {
+				aty = activity_type::quitting;
+				break;
+			}
+			case SDL_WINDOWEVENT: {
+				if (event.window.type == SDL_WINDOWEVENT_FOCUS_GAINED and aty == activity_type::stopped) {
+					aty = activity_type::running;
+				} else if (event.window.type == SDL_WINDOWEVENT_FOCUS_LOST and aty == activity_type::running) {
+					aty = activity_type::stopped;
+					drv_->first = 0;
+					drv_->count = 0;
+					input::zero(bts);
+				}
+				break;
+			}
+			case SDL_KEYDOWN: {
+				const auto code = event.key.keysym.scancode;
+				// the debugger isn't simulated, so it doesn't wait for a tick
+				if (drv_->debugger_code and *drv_->debugger_code == code) {
+					bts.pressed.debugger = !bts.holding.debugger;
+					bts.holding.debugger = true;
+				} else if (drv_->listening_for_keyboard) {
+					drv_->stored_code = code;
+				}
+				input::enqueue_(event, bts);
+				break;
+			}
+			case SDL_KEYUP: {
+				const auto code = event.key.keysym.scancode;
+				if (drv_->debugger_code and *drv_->debugger_code == code) {
+					bts.holding.debugger = false;
+					bts.released.debugger = true;
+				}
+				input::enqueue_(event, bts);
+				break;
+			}
+			case SDL_CONTROLLERAXISMOTION: {
+				if (
+					drv_->listening_for_joystick and
+					event.caxis.which == 0 and
+					event.caxis.value > AXIS_DEAD_ZONE
+				) {
+					if (event.caxis.axis == SDL_CONTROLLER_AXIS_TRIGGERLEFT) {
+						drv_->stored_code = JOYSTICK_CODE_TRIGGER_LEFT;
+					} else if (event.caxis.axis == SDL_CONTROLLER_AXIS_TRIGGERRIGHT) {
+						drv_->stored_code = JOYSTICK_CODE_TRIGGER_RIGHT;
+					}
+				}
+				input::enqueue_(event, bts);
+				break;
+			}
+			case SDL_CONTROLLERBUTTONDOWN: {
+				if (drv_->listening_for_joystick and event.cbutton.which == 0) {
+					const auto code = as<i32>(event.cbutton.button);
+					if (code < SDL_CONTROLLER_BUTTON_DPAD_UP or code > SDL_CONTROLLER_BUTTON_DPAD_RIGHT) {
+						drv_->stored_code = code;
+					}
+				}
+				input::enqueue_(event, bts);
+				break;
+			}
+			case SDL_CONTROLLERBUTTONUP: {
+				input::enqueue_(event, bts);
+				break;
+			}
 			case SDL_CONTROLLERDEVICEADDED: {
 				if (event.cdevice.which == 0 and !drv_->device) {
 					if (drv_->device = SDL_GameControllerOpen(0); !drv_->device) {
@@ -414,6 +487,34 @@ bool input::poll(activity_type& aty, buttons& bts) {
 	return aty != activity_type::quitting;
 }
 
+void input::consume(u32 deadline, buttons& bts) {
+	if (!drv_) {
+		return;
+	}
+	while (drv_->count > 0) {
+		const auto& event = drv_->events[drv_->first];
+		if (SDL_TICKS_PASSED(event.common.timestamp, deadline + 1)) {
+			break;
+		}
+		if (drv_->latency and input::pressing_(event)) {
+			spdlog::info("Input latency: {} ms", SDL_GetTicks() - event.common.timestamp);
+		}
+		input::apply_(event, bts);
+		drv_->first = (drv_->first + 1) % MAXIMUM_EVENTS;
+		--drv_->count;
+	}
+}
+
+void input::consume(buttons& bts) {
+	if (!drv_) {
+		return;
+	}
+	if (drv_->count > 0) {
+		const udx last = (drv_->first + drv_->count - 1) % MAXIMUM_EVENTS;
+		input::consume(drv_->events[last].common.timestamp, bts);
+	}
+}
+
 bool input::joystick_attached() {
 	if (!drv_) {
 		return false;
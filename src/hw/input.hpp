@@ -17,6 +17,9 @@ namespace input {
 	void zero(buttons& bts);
 	void callback(bool(*function)(const void*));
 	bool poll(activity_type& aty, buttons& bts);
+	// applies queued events stamped up to the deadline (in SDL ticks), or all of them
+	void consume(u32 deadline, buttons& bts);
+	void consume(buttons& bts);
 	bool joystick_attached();
 	bool valid_stored_code();
 	i32 receive_stored_code();
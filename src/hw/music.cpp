@@ -5,6 +5,7 @@
 #include <array>
 #include <vector>
 #include <limits>
+#include <algorithm>
 #include <glm/common.hpp>
 #include <spdlog/spdlog.h>
 #include <pxtone/pxtnService.h>
@@ -14,7 +15,9 @@
 #include "./audio.hpp"
 #include "./vfs.hpp"
 #include "../audio/openal.hpp"
+#include "../audio/software-mixer.hpp"
 #include "../util/config-file.hpp"
+#include "../util/profiler.hpp"
 
 namespace {
 	constexpr r64 DELAY_FACTOR = 750.0;
@@ -24,6 +27,7 @@ namespace {
 	constexpr r64 MINIMUM_BUFFERING_TIME = 0.05;
 	constexpr r64 MAXIMUM_BUFFERING_TIME = 1.0;
 	constexpr i32 MAXIMUM_FILE_SIZE = 10485760;
+	constexpr udx TOTAL_DECKS = 2;
 
 	template<typename T>
 	constexpr T calculate_buffer_length_(
@@ -42,17 +46,28 @@ namespace {
 
 // private
 namespace music {
+	// deck
+	struct deck {
+	public:
+		pxtnService service {};
+		std::string title {};
+	};
 	// driver
 	struct driver {
 	public:
 		config_file* config {};
-		pxtnService service {};
+		std::array<deck, TOTAL_DECKS> decks {};
+		std::atomic<udx> front {};
 		std::thread thread {};
-		std::string title {};
+		std::thread loader {};
 		std::atomic<bool> playing {};
+		std::atomic<bool> loading {};
 		std::atomic<bool> looping { true };
+		std::atomic<bool> crossfading {};
 		std::atomic<r32> fade_length {};
 		std::atomic<r32> volume {};
+		r32 crossfade_point {};
+		i32 crossfade_frames {};
 		i32 channels {};
 		i32 sampling_rate {};
 		r64 buffering_time {};
@@ -100,21 +115,31 @@ namespace music {
 			MAXIMUM_BUFFERING_TIME
 		);
 
-		// Initialize pxtone service
-		if (auto result = drv_->service.init(); result != pxtnERR::pxtnOK) {
-			spdlog::critical("Pxtone service initialization failed! Error: {}", pxtnError_get_string(result));
-			return false;
+		// Software mixer only takes stereo at its own rate
+		if (auto mixer = audio::mixer(); mixer) {
+			drv_->channels = STEREO_CHANNELS;
+			drv_->sampling_rate = mixer->sampling_rate();
 		}
-		if (!drv_->service.set_destination_quality(drv_->channels, drv_->sampling_rate)) {
-			spdlog::critical("Pxtone quality setting failed!");
-			return false;
+
+		// Initialize pxtone services
+		for (auto&& deck : drv_->decks) {
+			if (auto result = deck.service.init(); result != pxtnERR::pxtnOK) {
+				spdlog::critical("Pxtone service initialization failed! Error: {}", pxtnError_get_string(result));
+				return false;
+			}
+			if (!deck.service.set_destination_quality(drv_->channels, drv_->sampling_rate)) {
+				spdlog::critical("Pxtone quality setting failed!");
+				return false;
+			}
 		}
 
 		// Create buffers & source
 		drv_->buffers.fill(0);
-		const auto size = as<i32>(drv_->buffers.size());
-		alCheck(alGenSources(1, &drv_->source));
-		alCheck(alGenBuffers(size, drv_->buffers.data()));
+		if (!audio::mixer()) {
+			const auto size = as<i32>(drv_->buffers.size());
+			alCheck(alGenSources(1, &drv_->source));
+			alCheck(alGenBuffers(size, drv_->buffers.data()));
+		}
 
 		return true;
 	}
@@ -135,20 +160,138 @@ namespace music {
 				drv_->buffers.fill(0);
 				drv_->source = 0;
 			}
-			if (drv_->service.master) {
-				drv_->service.clear();
+			for (auto&& deck : drv_->decks) {
+				if (deck.service.master) {
+					deck.service.clear();
+				}
 			}
 			drv_.reset();
 		}
 	}
 
+	// Loader only ever touches the back deck, but that deck can't be
+	// cleared or swapped out from under it
+	void settle_() {
+		if (drv_->loader.joinable()) {
+			drv_->loader.join();
+		}
+	}
+
+	deck& front_() {
+		return drv_->decks[drv_->front];
+	}
+
+	deck& back_() {
+		return drv_->decks[drv_->front ^ 1];
+	}
+
+	void unload_(deck& target) {
+		if (!target.title.empty()) {
+			target.service.clear();
+			target.title.clear();
+		}
+	}
+
+	bool read_(deck& target, const std::string& title) {
+		std::vector<char> file = vfs::buffer_chars(vfs::tune_path(title));
+		if (file.empty()) {
+			spdlog::error("Pxtone file loading failed!");
+			return false;
+		}
+
+		const auto size = as<i32>(file.size());
+		if (size >= MAXIMUM_FILE_SIZE) {
+			spdlog::error("Pxtone file too large!");
+			return false;
+		}
+
+		pxtnDescriptor descriptor {};
+		if (!descriptor.set_memory_r(file.data(), size)) {
+			spdlog::error("Pxtone descriptor creation failed!");
+			return false;
+		}
+
+		if (auto result = target.service.read(&descriptor); result != pxtnERR::pxtnOK) {
+			spdlog::error("Pxtone descriptor reading failed! Pxtone Error: {}", pxtnError_get_string(result));
+			target.service.clear();
+			return false;
+		}
+
+		if (auto result = target.service.tones_ready(); result != pxtnERR::pxtnOK) {
+			spdlog::error("Pxtone tone readying failed! Pxtone Error: {}", pxtnError_get_string(result));
+			target.service.clear();
+			return false;
+		}
+
+		target.title = title;
+		return true;
+	}
+
+	bool prepare_(deck& target, r32 start_point, i32 start_sample, r32 fade_length) {
+		pxtnVOMITPREPARATION preparation {};
+		if (drv_->looping) {
+			preparation.flags |= pxtnVOMITPREPFLAG_loop;
+		}
+		if (start_sample > 0) {
+			preparation.start_pos_sample = start_sample;
+		} else {
+			preparation.start_pos_float = start_point / 1000.0f;
+		}
+		preparation.fadein_sec = fade_length / 1000.0f;
+		preparation.master_volume = drv_->volume;
+		if (!target.service.moo_preparation(&preparation)) {
+			spdlog::error("Pxtone couldn't prepare tune!");
+			return false;
+		}
+		return true;
+	}
+
+	void update_(bool& looping, r32& volume, i32 position) {
+		// Check if looping has changed
+		if (drv_->looping != looping) {
+			looping = drv_->looping;
+			music::front_().service.moo_set_loop(looping);
+			if (position >= 0) {
+				music::back_().service.moo_set_loop(looping);
+			}
+		}
+		// Check if volume has changed
+		if (drv_->volume != volume) {
+			volume = glm::clamp(drv_->volume.load(), 0.0f, 1.0f);
+			music::front_().service.moo_set_master_volume(volume);
+			if (position >= 0) {
+				music::back_().service.moo_set_master_volume(volume);
+			}
+		}
+		// Check if fade out has started
+		if (drv_->fade_length != 0.0f) {
+			music::front_().service.moo_set_fade(-1, drv_->fade_length);
+			if (position >= 0) {
+				music::back_().service.moo_set_fade(-1, drv_->fade_length);
+			}
+			drv_->fade_length = 0.0f;
+		}
+	}
+
+	void finish_() {
+		// Interrupted crossfade resolves to the incoming tune
+		if (drv_->crossfading) {
+			drv_->front = drv_->front ^ 1;
+			drv_->crossfading = false;
+		}
+		drv_->looping = true;
+	}
+
 	void process_() {
+		APOSTELLEIN_THREAD("music");
 		// Initialize constants
 		const auto length = calculate_buffer_length_<i32>(
 			drv_->buffering_time,
 			drv_->channels,
 			drv_->sampling_rate
 		);
+		const auto samples = as<udx>(length) / sizeof(i16);
+		const auto frames = as<i32>(samples) / drv_->channels;
 		const auto format = drv_->channels == STEREO_CHANNELS ?
 			AL_FORMAT_STEREO16 :
 			AL_FORMAT_MONO16;
@@ -161,11 +304,91 @@ namespace music {
 		r32 volume = drv_->volume;
 		i32 state = 0;
 		i32 processed = 0;
-		auto pointer = std::make_unique<char[]>(as<udx>(length));
+		i32 position = -1;
+		auto pointer = std::make_unique<i16[]>(samples);
+		auto auxiliary = std::make_unique<i16[]>(samples);
+
+		// Render both decks while crossfading, otherwise just the front deck.
+		// Incoming deck is prepared right before its first block is rendered,
+		// which lets it start on the exact sample where the outgoing deck is.
+		auto vomit = [&] {
+			APOSTELLEIN_ZONE("music::process_");
+			auto& outgoing = music::front_();
+			if (!drv_->crossfading) {
+				return outgoing.service.Moo(pointer.get(), length);
+			}
+			auto& incoming = music::back_();
+			if (position < 0) {
+				i32 start_sample = 0;
+				if (drv_->crossfade_point < 0.0f) {
+					const auto total = incoming.service.moo_get_total_sample();
+					if (total > 0) {
+						start_sample = outgoing.service.moo_get_sampling_offset() % total;
+					}
+				}
+				music::prepare_(incoming, drv_->crossfade_point, start_sample, 0.0f);
+				position = 0;
+			}
+			const bool outgoing_valid = outgoing.service.Moo(pointer.get(), length);
+			if (!outgoing_valid) {
+				std::fill_n(pointer.get(), samples, i16{});
+			}
+			const bool incoming_valid = incoming.service.Moo(auxiliary.get(), length);
+			if (!incoming_valid) {
+				std::fill_n(auxiliary.get(), samples, i16{});
+			}
+			const auto total = drv_->crossfade_frames;
+			for (i32 f = 0; f < frames; ++f) {
+				const r32 ratio = position < total ?
+					as<r32>(position) / as<r32>(total) :
+					1.0f;
+				for (i32 c = 0; c < drv_->channels; ++c) {
+					const auto idx = as<udx>(f * drv_->channels + c);
+					const r32 sample =
+						as<r32>(pointer[idx]) * (1.0f - ratio) +
+						as<r32>(auxiliary[idx]) * ratio;
+					pointer[idx] = as<i16>(glm::clamp(
+						sample,
+						as<r32>(std::numeric_limits<i16>::min()),
+						as<r32>(std::numeric_limits<i16>::max())
+					));
+				}
+				if (position < total) {
+					++position;
+				}
+			}
+			if (position >= total) {
+				drv_->front = drv_->front ^ 1;
+				drv_->crossfading = false;
+				position = -1;
+			}
+			return outgoing_valid or incoming_valid;
+		};
+
+		// Software mixer pulls from its own ring, so keep as many blocks queued there
+		// as there would be buffers queued on the source
+		if (auto mixer = audio::mixer(); mixer) {
+			const auto queue = as<udx>(frames) * drv_->buffers.size();
+			while (drv_->playing) {
+				music::update_(looping, volume, position);
+				while (mixer->streamed() + as<udx>(frames) <= queue) {
+					if (vomit()) {
+						mixer->stream(pointer.get(), as<udx>(frames));
+					} else {
+						drv_->playing = false;
+						break;
+					}
+				}
+				std::this_thread::sleep_for(buffering_delay);
+			}
+			mixer->discard();
+			music::finish_();
+			return;
+		}
 
 		// Queue tune beginning
 		for (auto&& buffer : drv_->buffers) {
-			if (drv_->service.Moo(pointer.get(), length)) {
+			if (vomit()) {
 				alCheck(alBufferData(
 					buffer,
 					format,
@@ -181,21 +404,7 @@ namespace music {
 
 		// Main loop
 		while (drv_->playing) {
-			// Check if looping has changed
-			if (drv_->looping != looping) {
-				looping = drv_->looping;
-				drv_->service.moo_set_loop(looping);
-			}
-			// Check if volume has changed
-			if (drv_->volume != volume) {
-				volume = glm::clamp(drv_->volume.load(), 0.0f, 1.0f);
-				drv_->service.moo_set_master_volume(drv_->volume);
-			}
-			// Check if fade out has started
-			if (drv_->fade_length != 0.0f) {
-				drv_->service.moo_set_fade(-1, drv_->fade_length);
-				drv_->fade_length = 0.0f;
-			}
+			music::update_(looping, volume, position);
 
 			// Play sound & process buffers
 			alCheck(alGetSourcei(drv_->source, AL_SOURCE_STATE, &state));
@@ -206,7 +415,7 @@ namespace music {
 			while (processed > 0) {
 				u32 buffer = 0;
 				alCheck(alSourceUnqueueBuffers(drv_->source, 1, &buffer));
-				if (drv_->service.Moo(pointer.get(), length)) {
+				if (vomit()) {
 					alCheck(alBufferData(
 						buffer,
 						format,
@@ -232,8 +441,7 @@ namespace music {
 			alCheck(alSourceStop(drv_->source));
 		}
 		alCheck(alSourcei(drv_->source, AL_BUFFER, 0));
-
-		drv_->looping = true;
+		music::finish_();
 	}
 
 	guard::guard(config_file& cfg) {
@@ -256,43 +464,11 @@ bool music::load(const std::string& title) {
 	if (!drv_) {
 		return false;
 	}
-	if (title == drv_->title) {
+	if (title == music::front_().title) {
 		return true;
 	}
 	music::clear();
-
-	std::vector<char> file = vfs::buffer_chars(vfs::tune_path(title));
-	if (file.empty()) {
-		spdlog::error("Pxtone file loading failed!");
-		return false;
-	}
-
-	const auto size = as<i32>(file.size());
-	if (size >= MAXIMUM_FILE_SIZE) {
-		spdlog::error("Pxtone file too large!");
-		return false;
-	}
-
-	pxtnDescriptor descriptor {};
-	if (!descriptor.set_memory_r(file.data(), size)) {
-		spdlog::error("Pxtone descriptor creation failed!");
-		return false;
-	}
-
-	if (auto result = drv_->service.read(&descriptor); result != pxtnERR::pxtnOK) {
-		spdlog::error("Pxtone descriptor reading failed! Pxtone Error: {}", pxtnError_get_string(result));
-		drv_->service.clear();
-		return false;
-	}
-
-	if (auto result = drv_->service.tones_ready(); result != pxtnERR::pxtnOK) {
-		spdlog::error("Pxtone tone readying failed! Pxtone Error: {}", pxtnError_get_string(result));
-		drv_->service.clear();
-		return false;
-	}
-
-	drv_->title = title;
-	return true;
+	return music::read_(music::front_(), title);
 }
 
 bool music::play(r32 start_point, r32 fade_length) {
@@ -311,19 +487,56 @@ bool music::play(r32 start_point, r32 fade_length) {
 		spdlog::error("Estimated pxtone buffer will overflow!");
 		return false;
 	}
+	music::prepare_(music::front_(), start_point, 0, fade_length);
+	drv_->playing = true;
+	drv_->thread = std::thread(music::process_);
+	return true;
+}
 
-	pxtnVOMITPREPARATION preparation {};
-	if (drv_->looping) {
-		preparation.flags |= pxtnVOMITPREPFLAG_loop;
+bool music::crossfade(const std::string& title, r32 start_point, r32 fade_length) {
+	if (!drv_) {
+		return false;
 	}
-	preparation.start_pos_float = start_point / 1000.0f;
-	preparation.fadein_sec = fade_length / 1000.0f;
-	preparation.master_volume = drv_->volume;
-	if (!drv_->service.moo_preparation(&preparation)) {
-		spdlog::error("Pxtone couldn't prepare tune!");
+	if (!drv_->playing) {
+		if (!music::load(title)) {
+			return false;
+		}
+		return music::play(glm::max(start_point, 0.0f), fade_length);
 	}
-	drv_->playing = true;
-	drv_->thread = std::thread(music::process_);
+	if (drv_->crossfading) {
+		spdlog::warn("Music system is already crossfading!");
+		return false;
+	}
+	if (title == music::front_().title) {
+		return true;
+	}
+	if (drv_->loading) {
+		spdlog::warn("Music system is already loading a crossfade!");
+		return false;
+	}
+	music::settle_();
+	drv_->crossfade_point = start_point;
+	drv_->crossfade_frames = glm::max(
+		as<i32>(as<r32>(drv_->sampling_rate) * fade_length / 1000.0f),
+		1
+	);
+	// Mixing thread never touches the back deck until crossfading is set
+	auto& incoming = music::back_();
+	if (title == incoming.title) {
+		drv_->crossfading = true;
+		return true;
+	}
+	// Decoding a tune takes long enough to hitch a tick, so it happens
+	// on the loader and the fade starts once the deck is ready
+	drv_->loading = true;
+	drv_->loader = std::thread([&incoming, title] {
+		APOSTELLEIN_THREAD("music loader");
+		music::unload_(incoming);
+		if (music::read_(incoming, title) and drv_->playing) {
+			drv_->crossfading = true;
+		}
+		drv_->loading = false;
+	});
 	return true;
 }
 
@@ -331,6 +544,7 @@ void music::pause() {
 	if (!drv_) {
 		return;
 	}
+	music::settle_();
 	if (drv_->playing) {
 		drv_->playing = false;
 	}
@@ -352,7 +566,7 @@ void music::resume(r32 fade_length) {
 	if (!drv_) {
 		return;
 	}
-	if (!drv_->playing and drv_->service.moo_is_valid_data()) {
+	if (!drv_->playing and music::front_().service.moo_is_valid_data()) {
 		music::play(0.0f, fade_length);
 	}
 }
@@ -362,9 +576,8 @@ void music::clear() {
 		return;
 	}
 	music::pause();
-	if (!drv_->title.empty()) {
-		drv_->service.clear();
-		drv_->title.clear();
+	for (auto&& deck : drv_->decks) {
+		music::unload_(deck);
 	}
 	drv_->looping = true;
 }
@@ -376,6 +589,13 @@ bool music::playing() {
 	return drv_->playing;
 }
 
+bool music::crossfading() {
+	if (!drv_) {
+		return false;
+	}
+	return drv_->crossfading or drv_->loading;
+}
+
 void music::loop(bool value) {
 	if (!drv_) {
 		return;
@@ -8,11 +8,14 @@ struct config_file;
 namespace music {
 	bool load(const std::string& title);
 	bool play(r32 start_point, r32 fade_length);
+	// negative start_point syncs incoming tune with outgoing tune
+	bool crossfade(const std::string& title, r32 start_point, r32 fade_length);
 	void pause();
 	void fade(r32 fade_length);
 	void resume(r32 fade_length);
 	void clear();
 	bool playing();
+	bool crossfading();
 	void loop(bool value);
 	bool looping();
 	void volume(r32 value);
@@ -1,7 +1,13 @@
 #include <algorithm>
 #include <array>
+#include <cstdio>
+#include <atomic>
+#include <chrono>
 #include <fstream>
+#include <future>
 #include <memory>
+#include <thread>
+#include <utility>
 #include <unordered_map>
 #include <filesystem>
 #include <spdlog/spdlog.h>
@@ -10,12 +16,23 @@
 #include <fmt/chrono.h>
 #include <SDL2/SDL_filesystem.h>
 #include <SDL2/SDL_error.h>
+#include <tmxlite/Map.hpp>
 #include <apostellein/konst.hpp>
+#include <apostellein/cast.hpp>
+
+#if defined(APOSTELLEIN_PLATFORM_WINDOWS)
+	#include <io.h>
+#elif defined(APOSTELLEIN_POSIX_COMPLIANT)
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
 
 #include "./vfs.hpp"
+#include "../audio/noise-bank.hpp"
 #include "../audio/noise-buffer.hpp"
 #include "../video/material.hpp"
 #include "../util/config-file.hpp"
+#include "../util/memory-tracker.hpp"
 #include "../util/message-box.hpp"
 #include "../x2d/bitmap-font.hpp"
 #include "../x2d/animation-group.hpp"
@@ -25,6 +42,8 @@ namespace vfs_route {
 	constexpr char INIT[] = "init";
 	constexpr char SAVE[] = "save";
 	constexpr char LOG[] = "log";
+	constexpr char CAPTURE[] = "capture";
+	constexpr char CACHE[] = "cache";
 	constexpr char ANIM[] = "anim";
 	constexpr char EVENT[] = "event";
 	constexpr char FIELD[] = "field";
@@ -38,13 +57,21 @@ namespace vfs_route {
 
 namespace vfs_ext {
 	constexpr char TMX[] = ".tmx";
+	constexpr char FLD[] = ".fld";
+	constexpr char ANM[] = ".anm";
+	constexpr char MFT[] = ".mft";
+	constexpr char BNK[] = ".bnk";
 	constexpr char JSON[] = ".json";
+	constexpr char CSV[] = ".csv";
 	constexpr char PNG[] = ".png";
 	constexpr char WAV[] = ".wav";
 	constexpr char ATTR[] = ".attr";
 	constexpr char PTCOP[] = ".ptcop";
 	constexpr char LUA[] = ".lua";
 	constexpr char LOG[] = ".log";
+	constexpr char LUAC[] = ".luac";
+	constexpr char SAV[] = ".sav";
+	constexpr char TMP[] = ".tmp";
 }
 
 namespace {
@@ -52,12 +79,43 @@ namespace {
 	constexpr char FONT_ENTRY[] = "Font";
 	constexpr char EVENT_ENTRY[] = "Event";
 	constexpr udx MAXIMUM_FONTS = 4;
+
+	// only returns once the bytes have reached the disk, not just the OS cache
+	bool write_durably_(const std::string& path, const std::vector<byte>& buffer) {
+		std::FILE* file = std::fopen(path.c_str(), "wb");
+		if (!file) {
+			return false;
+		}
+		bool result =
+			std::fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size() and
+			std::fflush(file) == 0;
+#if defined(APOSTELLEIN_PLATFORM_WINDOWS)
+		// _commit goes through FlushFileBuffers
+		result = result and _commit(_fileno(file)) == 0;
+#elif defined(APOSTELLEIN_POSIX_COMPLIANT)
+		result = result and fsync(fileno(file)) == 0;
+#endif
+		return std::fclose(file) == 0 and result;
+	}
+
+	void sync_directory_(const std::filesystem::path& path) {
+#if defined(APOSTELLEIN_POSIX_COMPLIANT)
+		// the rename itself lives in the directory, so that has to be flushed too
+		if (const int handle = open(path.parent_path().c_str(), O_RDONLY); handle >= 0) {
+			fsync(handle);
+			close(handle);
+		}
+#else
+		static_cast<void>(path);
+#endif
+	}
 }
 
 // private
 namespace vfs {
 	// types
-	using i18n_entry = std::vector<std::string>;
+	using i18n_entry = tracked_vector<std::string, memory_tag::i18n>;
+	using i18n_table = tracked_unordered_map<entt::id_type, i18n_entry, memory_tag::i18n>;
 	// driver
 	struct driver {
 	public:
@@ -65,15 +123,77 @@ namespace vfs {
 		bool logging { false };
 		std::filesystem::path root_directory {};
 		std::filesystem::path personal_directory {};
-		std::unordered_map<std::string, i18n_entry> i18n {};
-		std::unordered_map<entt::id_type, noise_buffer> noises {};
-		std::unordered_map<std::string, material> materials {};
-		std::unordered_map<std::string, bitmap_font> fonts {};
-		std::unordered_map<entt::id_type, animation_group> animations {};
+		i18n_table i18n {};
+		tracked_unordered_map<entt::id_type, noise_buffer, memory_tag::noises> noises {};
+		tracked_unordered_map<entt::id_type, material, memory_tag::images> materials {};
+		tracked_unordered_map<std::string, bitmap_font, memory_tag::fonts> fonts {};
+		tracked_unordered_map<entt::id_type, animation_group, memory_tag::animations> animations {};
+		std::future<bool> writing {};
+		std::string written {};
+		bool failed {};
 	};
 	std::unique_ptr<driver> drv_ {};
 
 	// functions
+	void settle_() {
+		// a failure stays recorded until someone asks with flush() or poll()
+		if (drv_->writing.valid() and !drv_->writing.get()) {
+			if (drv_->logging) {
+				spdlog::error("Failed to write file in background: {}!", drv_->written);
+			}
+			drv_->failed = true;
+		}
+	}
+
+	std::string report_path_(const std::string& name, const char* extension) {
+		if (!drv_) {
+			return {};
+		}
+		const std::filesystem::path directory =
+			drv_->personal_directory /
+			vfs_route::CAPTURE;
+		if (const std::string dir = directory.string(); !vfs::create_directory(dir)) {
+			return {};
+		}
+		// several reports can be taken in one session
+		const std::time_t time = std::time(nullptr);
+		const std::string file = fmt::format(
+			"{}.{:%Y-%m-%d_%H-%M-%S}{}", name,
+			fmt::localtime(time),
+			extension
+		);
+		const std::filesystem::path result =
+			directory /
+			file;
+		return result.string();
+	}
+
+	// Runs func over [0, count) on a few workers and keeps the results in
+	// order. Sinks are thread-safe, so workers are free to log failures.
+	template<typename T, typename F>
+	std::vector<T> decode_parallel_(udx count, F&& func) {
+		std::vector<T> result(count);
+		std::atomic<udx> cursor { 0 };
+		auto worker = [&result, &cursor, &func, count] {
+			for (udx idx = cursor++; idx < count; idx = cursor++) {
+				result[idx] = func(idx);
+			}
+		};
+		const udx threads = std::min(
+			count,
+			std::max(as<udx>(std::thread::hardware_concurrency()), udx{ 1 })
+		);
+		std::vector<std::future<void>> helpers {};
+		for (udx it = 1; it < threads; ++it) {
+			helpers.push_back(std::async(std::launch::async, worker));
+		}
+		worker();
+		for (auto&& helper : helpers) {
+			helper.get();
+		}
+		return result;
+	}
+
 	std::string application_name_() {
 		std::string name = konst::APPLICATION;
 		name[0] = std::tolower(name[0], std::locale{});
@@ -138,6 +258,21 @@ namespace vfs {
 		return result;
 	}
 
+	bool create_directories_(const std::filesystem::path& path) {
+		std::error_code code;
+		if (!std::filesystem::is_directory(path, code)) {
+			if (std::filesystem::create_directories(path, code); code) {
+				spdlog::error(
+					"Failed to create directory \"{}\"! System Error: {}",
+					path.string(),
+					code.message()
+				);
+				return false;
+			}
+		}
+		return true;
+	}
+
 	bool directory_exists_(const std::filesystem::path& path, bool alert) {
 		std::error_code code;
 		if (!std::filesystem::is_directory(path, code)) {
@@ -236,10 +371,10 @@ namespace vfs {
 		{
 			std::vector<spdlog::sink_ptr> sinks {};
 			if constexpr (konst::DEBUG) {
-				sinks.push_back(std::make_shared<spdlog::sinks::stdout_color_sink_st>());
+				sinks.push_back(std::make_shared<spdlog::sinks::stdout_color_sink_mt>());
 			}
 			if (cfg.logging()) {
-				sinks.push_back(std::make_shared<spdlog::sinks::rotating_file_sink_st>(
+				sinks.push_back(std::make_shared<spdlog::sinks::rotating_file_sink_mt>(
 					vfs::log_path(konst::APPLICATION),
 					konst::MAXIMUM_BYTES,
 					konst::MAXIMUM_SINKS,
@@ -278,6 +413,7 @@ namespace vfs {
 
 	void drop_() {
 		if (drv_) {
+			vfs::flush();
 			if (drv_->config) {
 				const std::string path = vfs::init_path(CONFIG_NAME);
 				if (std::ofstream ofs {
@@ -339,10 +475,10 @@ bool vfs::try_language(const std::string& name) {
 		spdlog::error("Couldn't load language file: {}", path.string());
 		return false;
 	}
-	std::unordered_map<std::string, i18n_entry> result {};
+	i18n_table result {};
 	auto file = nlohmann::json::parse(ifs);
 	for (auto iter = file.begin(); iter != file.end(); ++iter) {
-		auto& entry = result[iter.key()];
+		auto& entry = result[entt::hashed_string::value(iter.key().c_str())];
 		for (auto&& value : iter.value()) {
 			if (value.is_string()) {
 				entry.push_back(value.get<std::string>());
@@ -362,6 +498,11 @@ bool vfs::directory_exists(const std::string& path) {
 	return vfs::directory_exists_(path, alert);
 }
 
+bool vfs::file_exists(const std::string& path) {
+	std::error_code code;
+	return std::filesystem::is_regular_file(path, code);
+}
+
 bool vfs::create_directory(const std::string& path) {
 	if (vfs::directory_exists_(path, false)) {
 		return true;
@@ -397,6 +538,9 @@ std::string vfs::init_path(const std::string& name) {
 }
 
 std::string vfs::save_path(const std::string& name, udx profile) {
+	if (!drv_) {
+		return {};
+	}
 	const std::filesystem::path directory =
 		drv_->personal_directory /
 		vfs_route::SAVE;
@@ -405,6 +549,17 @@ std::string vfs::save_path(const std::string& name, udx profile) {
 	}
 	const std::filesystem::path result =
 		directory /
+		(name + std::to_string(profile) + vfs_ext::SAV);
+	return result.string();
+}
+
+std::string vfs::export_path(const std::string& name, udx profile) {
+	if (!drv_) {
+		return {};
+	}
+	const std::filesystem::path result =
+		drv_->personal_directory /
+		vfs_route::SAVE /
 		(name + std::to_string(profile) + vfs_ext::JSON);
 	return result.string();
 }
@@ -426,6 +581,36 @@ std::string vfs::log_path(const std::string& name) {
 	return result.string();
 }
 
+std::string vfs::capture_path(const std::string& name) {
+	if (!drv_) {
+		return {};
+	}
+	const std::filesystem::path directory =
+		drv_->personal_directory /
+		vfs_route::CAPTURE;
+	if (const std::string dir = directory.string(); !vfs::create_directory(dir)) {
+		return {};
+	}
+	static const std::time_t time = std::time(nullptr);
+	const std::string file = fmt::format(
+		"{}.{:%Y-%m-%d_%H-%M-%S}{}", name,
+		fmt::localtime(time),
+		vfs_ext::WAV
+	);
+	const std::filesystem::path result =
+		directory /
+		file;
+	return result.string();
+}
+
+std::string vfs::trace_path(const std::string& name) {
+	return vfs::report_path_(name, vfs_ext::JSON);
+}
+
+std::string vfs::stats_path(const std::string& name) {
+	return vfs::report_path_(name, vfs_ext::CSV);
+}
+
 std::string vfs::tune_path(const std::string& name) {
 	if (!drv_) {
 		return {};
@@ -460,6 +645,41 @@ std::string vfs::local_script_path(const std::string& name) {
 	return result.string();
 }
 
+std::string vfs::global_bytecode_path(const std::string& name) {
+	if (!drv_) {
+		return {};
+	}
+	const std::filesystem::path directory =
+		drv_->personal_directory /
+		vfs_route::CACHE /
+		vfs_route::EVENT;
+	if (!vfs::create_directories_(directory)) {
+		return {};
+	}
+	const std::filesystem::path result =
+		directory /
+		(name + vfs_ext::LUAC);
+	return result.string();
+}
+
+std::string vfs::local_bytecode_path(const std::string& name) {
+	if (!drv_) {
+		return {};
+	}
+	const std::filesystem::path directory =
+		drv_->personal_directory /
+		vfs_route::CACHE /
+		vfs_route::EVENT /
+		vfs::i18n_at(EVENT_ENTRY, 0);
+	if (!vfs::create_directories_(directory)) {
+		return {};
+	}
+	const std::filesystem::path result =
+		directory /
+		(name + vfs_ext::LUAC);
+	return result.string();
+}
+
 std::string vfs::field_path(const std::string& name) {
 	if (!drv_) {
 		return {};
@@ -471,6 +691,61 @@ std::string vfs::field_path(const std::string& name) {
 	return result.string();
 }
 
+std::string vfs::compiled_field_path(const std::string& name) {
+	if (!drv_) {
+		return {};
+	}
+	const std::filesystem::path result =
+		drv_->root_directory /
+		vfs_route::FIELD /
+		(name + vfs_ext::FLD);
+	return result.string();
+}
+
+std::string vfs::animation_path(const std::string& name) {
+	if (!drv_) {
+		return {};
+	}
+	const std::filesystem::path result =
+		drv_->root_directory /
+		vfs_route::ANIM /
+		(name + vfs_ext::JSON);
+	return result.string();
+}
+
+std::string vfs::compiled_animation_path(const std::string& name) {
+	if (!drv_) {
+		return {};
+	}
+	const std::filesystem::path result =
+		drv_->root_directory /
+		vfs_route::ANIM /
+		(name + vfs_ext::ANM);
+	return result.string();
+}
+
+std::string vfs::manifest_path(const std::string& name) {
+	if (!drv_) {
+		return {};
+	}
+	const std::filesystem::path result =
+		drv_->root_directory /
+		vfs_route::FIELD /
+		(name + vfs_ext::MFT);
+	return result.string();
+}
+
+std::string vfs::bank_path(const std::string& name) {
+	if (!drv_) {
+		return {};
+	}
+	const std::filesystem::path result =
+		drv_->root_directory /
+		vfs_route::FIELD /
+		(name + vfs_ext::BNK);
+	return result.string();
+}
+
 std::string vfs::key_path(const std::string& name) {
 	if (!drv_) {
 		return {};
@@ -513,7 +788,11 @@ std::vector<std::string> vfs::list_fields() {
 	if (!drv_) {
 		return {};
 	}
-	return vfs::list_normal_files_(drv_->root_directory / vfs_route::FIELD);
+	// compiled fields sit next to their descriptions
+	std::vector<std::string> fields = vfs::list_normal_files_(drv_->root_directory / vfs_route::FIELD);
+	std::sort(fields.begin(), fields.end());
+	fields.erase(std::unique(fields.begin(), fields.end()), fields.end());
+	return fields;
 }
 
 std::vector<std::string> vfs::list_keys() {
@@ -603,6 +882,124 @@ image_file vfs::buffer_image(const std::string& path) {
 	return result;
 }
 
+field_file vfs::buffer_field(const std::string& name) {
+	field_file result {};
+	if (!drv_) {
+		return result;
+	}
+	const std::filesystem::path binary = vfs::compiled_field_path(name);
+	const std::filesystem::path description = vfs::field_path(name);
+
+	// Compiled field is preferred unless its description was edited afterwards
+	std::error_code code;
+	if (std::filesystem::exists(binary, code)) {
+		const auto binary_time = std::filesystem::last_write_time(binary, code);
+		const auto description_time = std::filesystem::last_write_time(description, code);
+		if (code or binary_time >= description_time) {
+			if (result.load(vfs::buffer_bytes(binary.string()))) {
+				return result;
+			}
+		} else {
+			spdlog::warn("Compiled field \"{}\" is older than its description!", name);
+		}
+	}
+
+	tmx::Map desc {};
+	if (!desc.load(description.string())) {
+		spdlog::error("Couldn't load field description: {}!", description.string());
+		return result;
+	}
+	const std::vector<u32> key = vfs::buffer_uints(
+		vfs::key_path(field_file::tileset(desc))
+	);
+	if (!result.compile(desc, key)) {
+		spdlog::error("Couldn't compile field description: {}!", description.string());
+	}
+	return result;
+}
+
+animation_file vfs::buffer_animation(const std::string& name) {
+	animation_file result {};
+	if (!drv_) {
+		return result;
+	}
+	const std::filesystem::path binary = vfs::compiled_animation_path(name);
+	const std::filesystem::path description = vfs::animation_path(name);
+
+	// Same rule as fields: stale binaries fall back to the description
+	std::error_code code;
+	if (std::filesystem::exists(binary, code)) {
+		const auto binary_time = std::filesystem::last_write_time(binary, code);
+		const auto description_time = std::filesystem::last_write_time(description, code);
+		if (code or binary_time >= description_time) {
+			if (result.load(vfs::buffer_bytes(binary.string()))) {
+				return result;
+			}
+		} else {
+			spdlog::warn("Compiled animation \"{}\" is older than its description!", name);
+		}
+	}
+
+	const auto desc = vfs::buffer_json(description.string());
+	if (desc.is_null() or !result.compile(desc)) {
+		spdlog::error("Couldn't compile animation description: {}!", description.string());
+	}
+	return result;
+}
+
+asset_manifest vfs::buffer_manifest(const std::string& name, const field_file& field) {
+	asset_manifest result {};
+	if (!drv_) {
+		return result;
+	}
+	const std::filesystem::path binary = vfs::manifest_path(name);
+	const std::filesystem::path description = vfs::field_path(name);
+	const std::filesystem::path script = vfs::local_script_path(name);
+
+	// Either source being newer means the manifest could be missing something
+	std::error_code code;
+	if (std::filesystem::exists(binary, code)) {
+		const auto binary_time = std::filesystem::last_write_time(binary, code);
+		const auto description_time = std::filesystem::last_write_time(description, code);
+		const auto script_time = std::filesystem::last_write_time(script, code);
+		if (code or (binary_time >= description_time and binary_time >= script_time)) {
+			if (result.load(vfs::buffer_bytes(binary.string()))) {
+				return result;
+			}
+		} else {
+			spdlog::warn("Asset manifest \"{}\" is older than its field!", name);
+		}
+	}
+	result.compile(field, { vfs::buffer_string(script.string()) });
+	return result;
+}
+
+bank_file vfs::buffer_bank(const std::string& name) {
+	bank_file result {};
+	if (!drv_) {
+		return result;
+	}
+	const std::filesystem::path binary = vfs::bank_path(name);
+	const std::filesystem::path description = vfs::field_path(name);
+	const std::filesystem::path script = vfs::local_script_path(name);
+
+	// Same rules as the manifest, since the bank is baked from it
+	std::error_code code;
+	if (std::filesystem::exists(binary, code)) {
+		const auto binary_time = std::filesystem::last_write_time(binary, code);
+		const auto description_time = std::filesystem::last_write_time(description, code);
+		const auto script_time = std::filesystem::last_write_time(script, code);
+		if (code or (binary_time >= description_time and binary_time >= script_time)) {
+			if (!result.load(vfs::buffer_bytes(binary.string()))) {
+				spdlog::error("Couldn't load noise bank: {}!", binary.string());
+			}
+		} else {
+			spdlog::warn("Noise bank \"{}\" is older than its field!", name);
+		}
+	}
+	return result;
+}
+
 nlohmann::json vfs::buffer_json(const std::string& path) {
 	std::ifstream ifs { path, std::ios::binary };
 	if (!ifs.is_open()) {
@@ -636,11 +1033,80 @@ bool vfs::dump_json(const nlohmann::json& file, const std::string& path) {
 	return true;
 }
 
+bool vfs::dump_string(const std::string& buffer, const std::string& path) {
+	std::ofstream ofs { path, std::ios::binary };
+	if (!ofs.is_open()) {
+		spdlog::error("Failed to dump text file: {}!", path);
+		return false;
+	}
+	ofs.write(buffer.data(), buffer.size());
+	return true;
+}
+
+bool vfs::dump_bytes(const std::vector<byte>& buffer, const std::string& path) {
+	std::ofstream ofs { path, std::ios::binary };
+	if (!ofs.is_open()) {
+		spdlog::error("Failed to dump binary file: {}!", path);
+		return false;
+	}
+	ofs.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+	return true;
+}
+
+void vfs::dump_bytes_async(std::vector<byte>&& buffer, const std::string& path) {
+	if (!drv_) {
+		return;
+	}
+	// one write in flight at a time keeps saves to the same path ordered
+	vfs::settle_();
+	drv_->written = path;
+	drv_->writing = std::async(
+		std::launch::async,
+		[buffer = std::move(buffer), path] {
+			// failures are reported by flush() or poll(), whichever comes first
+			const std::string temp = path + vfs_ext::TMP;
+			if (!write_durably_(temp, buffer)) {
+				return false;
+			}
+			// the new bytes are on disk before rename swaps them in, so a
+			// crash at any point leaves either the old save or the new one
+			std::error_code code;
+			std::filesystem::rename(temp, path, code);
+			if (code) {
+				return false;
+			}
+			sync_directory_(path);
+			return true;
+		}
+	);
+}
+
+bool vfs::flush() {
+	if (!drv_) {
+		return true;
+	}
+	vfs::settle_();
+	return !std::exchange(drv_->failed, false);
+}
+
+bool vfs::poll() {
+	if (!drv_) {
+		return true;
+	}
+	if (
+		drv_->writing.valid() and
+		drv_->writing.wait_for(std::chrono::seconds::zero()) != std::future_status::ready
+	) {
+		return true;
+	}
+	return vfs::flush();
+}
+
 std::string vfs::i18n_from(const std::string& segment, udx first, udx last) {
 	if (!drv_) {
 		return {};
 	}
-	auto iter = drv_->i18n.find(segment);
+	auto iter = drv_->i18n.find(entt::hashed_string::value(segment.c_str()));
 	if (iter == drv_->i18n.end()) {
 		return {};
 	}
@@ -665,29 +1131,30 @@ std::string vfs::i18n_from(const std::string& segment, udx first, udx last) {
 	return result;
 }
 
-std::string vfs::i18n_at(const std::string& segment, udx index) {
+const std::string& vfs::i18n_at(const entt::hashed_string& segment, udx index) {
+	static const std::string EMPTY {};
 	if (!drv_) {
-		return {};
+		return EMPTY;
 	}
-	auto iter = drv_->i18n.find(segment);
+	auto iter = drv_->i18n.find(segment.value());
 	if (iter == drv_->i18n.end()) {
-		spdlog::error("I18N segment \"{}\" doesn't exist!", segment);
-		return {};
+		spdlog::error("I18N segment \"{}\" doesn't exist!", segment.data());
+		return EMPTY;
 	}
 	if (index >= iter->second.size()) {
-		spdlog::error("I18N segment \"\" doesn't have data at index {}!", index);
-		return {};
+		spdlog::error("I18N segment \"{}\" doesn't have data at index {}!", segment.data(), index);
+		return EMPTY;
 	}
 	return iter->second[index];
 }
 
-udx vfs::i18n_size(const std::string& segment) {
+udx vfs::i18n_size(const entt::hashed_string& segment) {
 	if (!drv_) {
 		return 0;
 	}
-	auto iter = drv_->i18n.find(segment);
+	auto iter = drv_->i18n.find(segment.value());
 	if (iter == drv_->i18n.end()) {
-		spdlog::error("I18N segment \"{}\" doesn't exist!", segment);
+		spdlog::error("I18N segment \"{}\" doesn't exist!", segment.data());
 		return 0;
 	}
 	return iter->second.size();
@@ -735,6 +1202,99 @@ void vfs::clear_animations() {
 	}
 }
 
+udx vfs::preload_noises(const std::string& field, const std::vector<std::string>& names) {
+	if (!drv_) {
+		return 0;
+	}
+	bank_file bank = vfs::buffer_bank(field);
+	udx baked = bank.entries().size();
+	for (auto&& name : names) {
+		const entt::hashed_string entry { name.c_str() };
+		if (drv_->noises.find(entry.value()) != drv_->noises.end() or bank.contains(entry.value())) {
+			// either loaded already, failed before, or baked into the bank
+			continue;
+		}
+		const std::filesystem::path path =
+			drv_->root_directory /
+			vfs_route::NOISE /
+			(name + vfs_ext::WAV);
+		if (!bank.append(name, vfs::buffer_bytes(path.string()))) {
+			// compressed or missing, so let SDL have a go at it
+			drv_->noises[entry.value()].load(path.string());
+		}
+	}
+	if (bank.entries().size() > baked) {
+		spdlog::warn(
+			"{} noises for \"{}\" weren't baked, run fieldc again.",
+			bank.entries().size() - baked, field
+		);
+	}
+	const udx result = noise_bank::upload(bank, drv_->noises);
+	if (result > 0) {
+		spdlog::info("Preloaded {} noises ({} KB).", result, bank.bytes() / konst::KILOBYTE);
+	}
+	return result;
+}
+
+udx vfs::preload_materials(const std::vector<std::string>& names) {
+	if (!drv_) {
+		return 0;
+	}
+	std::vector<std::string> pending {};
+	for (auto&& name : names) {
+		const entt::hashed_string entry { name.c_str() };
+		if (drv_->materials.find(entry.value()) == drv_->materials.end()) {
+			pending.push_back(name);
+		}
+	}
+	std::sort(pending.begin(), pending.end());
+	pending.erase(std::unique(pending.begin(), pending.end()), pending.end());
+	// decoding is spread out, but uploads have to happen on this thread
+	auto images = vfs::decode_parallel_<image_file>(pending.size(), [&pending](udx idx) {
+		const std::filesystem::path path =
+			drv_->root_directory /
+			vfs_route::IMAGE /
+			(pending[idx] + vfs_ext::PNG);
+		return vfs::buffer_image(path.string());
+	});
+	for (udx idx = 0; idx < pending.size(); ++idx) {
+		const entt::hashed_string entry { pending[idx].c_str() };
+		drv_->materials[entry.value()].load(std::move(images[idx]));
+	}
+	return pending.size();
+}
+
+udx vfs::preload_animations(const std::vector<std::string>& names) {
+	if (!drv_) {
+		return 0;
+	}
+	std::vector<std::string> pending {};
+	for (auto&& name : names) {
+		const entt::hashed_string entry { name.c_str() };
+		if (drv_->animations.find(entry.value()) == drv_->animations.end()) {
+			pending.push_back(name);
+		}
+	}
+	std::sort(pending.begin(), pending.end());
+	pending.erase(std::unique(pending.begin(), pending.end()), pending.end());
+	auto files = vfs::decode_parallel_<animation_file>(pending.size(), [&pending](udx idx) {
+		return vfs::buffer_animation(pending[idx]);
+	});
+	// materials go first, so groups find their textures already resident
+	std::vector<std::string> materials {};
+	for (auto&& file : files) {
+		if (!file.material().empty()) {
+			materials.push_back(file.material());
+		}
+	}
+	vfs::preload_materials(materials);
+	for (udx idx = 0; idx < pending.size(); ++idx) {
+		const entt::hashed_string entry { pending[idx].c_str() };
+		drv_->animations[entry.value()].load(std::move(files[idx]));
+	}
+	return pending.size();
+}
+
 const noise_buffer* vfs::find_noise(const entt::hashed_string& entry) {
 	if (!drv_) {
 		return nullptr;
@@ -771,31 +1331,21 @@ const noise_buffer* vfs::find_noise(const std::string& name) {
 	return std::addressof(iter->second);
 }
 
-const material* vfs::find_material(const std::string& name) {
-	if (!drv_) {
-		return nullptr;
-	}
-	auto iter = drv_->materials.find(name);
-	if (iter == drv_->materials.end()) {
-		auto& ref = drv_->materials[name];
-		const std::filesystem::path path =
-			drv_->root_directory /
-			vfs_route::IMAGE /
-			(name + vfs_ext::PNG);
-		auto image = vfs::buffer_image(path.string());
-		ref.load(std::move(image));
-		return &ref;
-	}
-	return std::addressof(iter->second);
+const material* vfs::find_material(const entt::hashed_string& entry) {
+	return vfs::find_material(entry, vfs_route::IMAGE);
 }
 
-const material* vfs::find_material(const std::string& name, const std::string& route) {
+const material* vfs::find_material(const entt::hashed_string& entry, const std::string& route) {
+	return vfs::find_material(entry.value(), entry.data(), route);
+}
+
+const material* vfs::find_material(entt::id_type id, const std::string& name, const std::string& route) {
 	if (!drv_) {
 		return nullptr;
 	}
-	auto iter = drv_->materials.find(name);
+	auto iter = drv_->materials.find(id);
 	if (iter == drv_->materials.end()) {
-		auto& ref = drv_->materials[name];
+		auto& ref = drv_->materials[id];
 		const std::filesystem::path path =
 			drv_->root_directory /
 			route /
@@ -807,6 +1357,20 @@ const material* vfs::find_material(const std::string& name, const std::string& r
 	return std::addressof(iter->second);
 }
 
+const material* vfs::find_material(const std::string& name) {
+	const entt::hashed_string entry { name.c_str() };
+	return vfs::find_material(entry, vfs_route::IMAGE);
+}
+
+const material* vfs::find_material(const std::string& name, const std::string& route) {
+	const entt::hashed_string entry { name.c_str() };
+	return vfs::find_material(entry, route);
+}
+
+const material* vfs::find_material(entt::id_type id, const std::string& name) {
+	return vfs::find_material(id, name, vfs_route::IMAGE);
+}
+
 const bitmap_font* vfs::find_font(const std::string& name) {
 	if (!drv_) {
 		return nullptr;
@@ -859,12 +1423,7 @@ const animation_group* vfs::find_animation(const entt::hashed_string& entry) {
 	auto iter = drv_->animations.find(entry.value());
 	if (iter == drv_->animations.end()) {
 		auto& ref = drv_->animations[entry.value()];
-		const std::string name { entry.data() };
-		const std::filesystem::path path =
-			drv_->root_directory /
-			vfs_route::ANIM /
-			(name + vfs_ext::JSON);
-		ref.load(path.string());
+		ref.load(vfs::buffer_animation(entry.data()));
 		return &ref;
 	}
 	return std::addressof(iter->second);
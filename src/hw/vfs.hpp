@@ -4,8 +4,12 @@
 #include <string>
 #include <entt/core/hashed_string.hpp>
 
+#include "../util/bank-file.hpp"
 #include "../util/config-file.hpp"
 #include "../util/image-file.hpp"
+#include "../util/field-file.hpp"
+#include "../util/animation-file.hpp"
+#include "../util/asset-manifest.hpp"
 
 struct noise_buffer;
 struct material;
@@ -17,14 +21,26 @@ namespace vfs {
 	bool try_language();
 	bool try_language(const std::string& name);
 	bool directory_exists(const std::string& path);
+	bool file_exists(const std::string& path);
 	bool create_directory(const std::string& path);
 	std::string init_path(const std::string& name);
 	std::string save_path(const std::string& name, udx profile);
+	std::string export_path(const std::string& name, udx profile);
 	std::string log_path(const std::string& name);
+	std::string capture_path(const std::string& name);
+	std::string trace_path(const std::string& name);
+	std::string stats_path(const std::string& name);
 	std::string tune_path(const std::string& name);
 	std::string global_script_path(const std::string& name);
 	std::string local_script_path(const std::string& name);
+	std::string global_bytecode_path(const std::string& name);
+	std::string local_bytecode_path(const std::string& name);
 	std::string field_path(const std::string& name);
+	std::string compiled_field_path(const std::string& name);
+	std::string manifest_path(const std::string& name);
+	std::string bank_path(const std::string& name);
+	std::string animation_path(const std::string& name);
+	std::string compiled_animation_path(const std::string& name);
 	std::string key_path(const std::string& name);
 	std::string image_path(const std::string& name);
 	std::vector<std::string> list_languages();
@@ -35,20 +51,37 @@ namespace vfs {
 	std::vector<byte> buffer_bytes(const std::string& path);
 	std::vector<u32> buffer_uints(const std::string& path);
 	image_file buffer_image(const std::string& path);
+	field_file buffer_field(const std::string& name);
+	animation_file buffer_animation(const std::string& name);
+	asset_manifest buffer_manifest(const std::string& name, const field_file& field);
+	bank_file buffer_bank(const std::string& name);
 	nlohmann::json buffer_json(const std::string& path);
 	bool dump_json(const nlohmann::json& file, const std::string& path);
+	bool dump_string(const std::string& buffer, const std::string& path);
+	bool dump_bytes(const std::vector<byte>& buffer, const std::string& path);
+	void dump_bytes_async(std::vector<byte>&& buffer, const std::string& path);
+	bool flush();
+	// same as flush, but returns right away while a write is still in flight
+	bool poll();
 	void clear_noises();
 	void clear_materials();
 	void clear_material(const material* handle);
 	void clear_fonts();
 	void clear_animations();
 	std::string i18n_from(const std::string& segment, udx first, udx last);
-	std::string i18n_at(const std::string& segment, udx index);
-	udx i18n_size(const std::string& segment);
+	const std::string& i18n_at(const entt::hashed_string& segment, udx index);
+	udx i18n_size(const entt::hashed_string& segment);
+	udx preload_noises(const std::string& field, const std::vector<std::string>& names);
+	udx preload_materials(const std::vector<std::string>& names);
+	udx preload_animations(const std::vector<std::string>& names);
 	const noise_buffer* find_noise(const entt::hashed_string& entry);
 	const noise_buffer* find_noise(const std::string& name);
+	const material* find_material(const entt::hashed_string& entry);
+	const material* find_material(const entt::hashed_string& entry, const std::string& route);
 	const material* find_material(const std::string& name);
 	const material* find_material(const std::string& name, const std::string& route);
+	const material* find_material(entt::id_type id, const std::string& name);
+	const material* find_material(entt::id_type id, const std::string& name, const std::string& route);
 	const bitmap_font* find_font(const std::string& name);
 	const bitmap_font* find_font(udx index);
 	const animation_group* find_animation(const entt::hashed_string& entry);
@@ -1,3 +1,5 @@
+#include <array>
+#include <cmath>
 #include <memory>
 #include <thread>
 #include <chrono>
@@ -11,6 +13,7 @@
 #include "./vfs.hpp"
 #include "../util/config-file.hpp"
 #include "../util/message-box.hpp"
+#include "../util/profiler.hpp"
 #include "../video/opengl.hpp"
 #include "../video/swap-chain.hpp"
 
@@ -24,6 +27,13 @@ namespace {
 	constexpr i32 MAXIMUM_REFRESH_RATE = DEFAULT_FRAME_RATE * 4;
 	constexpr u32 DEFAULT_WINDOW_FLAGS = SDL_WINDOW_HIDDEN | SDL_WINDOW_OPENGL;
 	constexpr u32 HIGH_DPI_WINDOW_FLAGS = DEFAULT_WINDOW_FLAGS | SDL_WINDOW_ALLOW_HIGHDPI;
+	constexpr udx PACING_HISTORY = 64;
+	constexpr i64 SPIN_THRESHOLD = konst::SECONDS_TO_NANOSECONDS(0.002);
+	constexpr i64 PUMPING_INTERVAL = konst::SECONDS_TO_NANOSECONDS(0.001);
+	constexpr i64 PACING_MARGIN = konst::SECONDS_TO_NANOSECONDS(0.0005);
+	constexpr r64 PACING_DEVIATIONS = 2.0;
+	constexpr r64 MISSED_FRAME_FACTOR = 1.5;
+	constexpr r64 NANOSECONDS_PER_MILLISECOND = 1000000.0;
 
 	constexpr i32 clamp_frame_rate_(i32 fps) {
 		if (fps <= 0) { // Unlimited
@@ -64,21 +74,45 @@ namespace video {
 		bool yield {};
 		i32 refresh_rate { MINIMUM_REFRESH_RATE };
 		i32 frame_rate { DEFAULT_FRAME_RATE };
-		std::chrono::steady_clock::time_point time {};
+		// pacing
+		std::chrono::steady_clock::time_point woken {};
+		std::chrono::steady_clock::time_point presented {};
+		std::array<i64, PACING_HISTORY> costs {};
+		std::array<i64, PACING_HISTORY> intervals {};
+		udx cursor {};
+		udx samples {};
+		statistics stats {};
 	};
 	std::unique_ptr<driver> drv_ {};
 	// functions
-	i64 calculate_yield_duration_() {
-		if (drv_->frame_rate == 0) {
-			return 0;
+	i64 calculate_frame_period_() {
+		if (drv_->vertical_sync) {
+			return konst::SECONDS_TO_NANOSECONDS(1.0 / as<r64>(drv_->refresh_rate));
+		}
+		if (drv_->frame_rate > 0) {
+			return konst::SECONDS_TO_NANOSECONDS(1.0 / as<r64>(drv_->frame_rate));
+		}
+		return 0;
+	}
+
+	// mean and variance over however much of the history is filled
+	std::pair<r64, r64> calculate_moments_(const std::array<i64, PACING_HISTORY>& history) {
+		const udx count = glm::min(drv_->samples, PACING_HISTORY);
+		if (count == 0) {
+			return {};
 		}
-		const auto fps = as<r64>(drv_->frame_rate);
-		if (drv_->yield) {
-			return konst::SECONDS_TO_NANOSECONDS(1.0 / fps);
+		r64 mean = 0.0;
+		for (udx idx = 0; idx < count; ++idx) {
+			mean += as<r64>(history[idx]);
 		}
-		const auto now = std::chrono::steady_clock::now();
-		const auto result = konst::SECONDS_TO_NANOSECONDS(1.0 / fps) - (now - drv_->time).count();
-		return glm::max(as<i64>(0), result);
+		mean /= as<r64>(count);
+		r64 variance = 0.0;
+		for (udx idx = 0; idx < count; ++idx) {
+			const r64 difference = as<r64>(history[idx]) - mean;
+			variance += difference * difference;
+		}
+		variance /= as<r64>(count);
+		return { mean, variance };
 	}
 
 	glm::ivec2 calculate_actual_viewport_() {
@@ -136,6 +170,26 @@ namespace video {
 #endif
 	}
 
+	void wait_until_(std::chrono::steady_clock::time_point deadline) {
+		// events only get stamped when they're pumped, so keep pumping while
+		// idle or everything would look like it arrived at the end of the wait
+		if (!drv_->yield) {
+			while (1) {
+				const auto remaining = (deadline - std::chrono::steady_clock::now()).count();
+				if (remaining <= SPIN_THRESHOLD) {
+					break;
+				}
+				video::high_resolution_sleep_(glm::min(remaining - SPIN_THRESHOLD, PUMPING_INTERVAL));
+				SDL_PumpEvents();
+			}
+		}
+		// the scheduler routinely oversleeps, so spin the last stretch
+		while (std::chrono::steady_clock::now() < deadline) {
+			SDL_PumpEvents();
+			std::this_thread::yield();
+		}
+	}
+
 	bool init_(config_file& cfg) {
 		// Create driver
 		if (drv_) {
@@ -298,6 +352,7 @@ namespace video {
 		swap_chain::viewport(video::calculate_actual_viewport_());
 		swap_chain::clear(chroma::BASE());
 		SDL_GL_SwapWindow(drv_->window);
+		drv_->presented = std::chrono::steady_clock::now();
 
 		// Set swap interval
 		if (drv_->vertical_sync) {
@@ -379,28 +434,50 @@ void video::show() {
 	SDL_ShowWindow(drv_->window);
 }
 
+void video::pace() {
+	APOSTELLEIN_ZONE("video::pace");
+	if (!drv_) {
+		return;
+	}
+	const auto start = std::chrono::steady_clock::now();
+	if (const i64 period = video::calculate_frame_period_(); period > 0 and drv_->samples > 0) {
+		// wake up just early enough for the predicted frame to be
+		// presented at the next deadline, whether that's vblank or the cap
+		const auto [mean, variance] = video::calculate_moments_(drv_->costs);
+		const i64 predicted = as<i64>(mean + PACING_DEVIATIONS * std::sqrt(variance)) + PACING_MARGIN;
+		const auto deadline = drv_->presented + std::chrono::nanoseconds{ period - predicted };
+		video::wait_until_(deadline);
+		drv_->stats.predicted = as<r64>(predicted) / NANOSECONDS_PER_MILLISECOND;
+	}
+	drv_->woken = std::chrono::steady_clock::now();
+	drv_->stats.slept = as<r64>((drv_->woken - start).count()) / NANOSECONDS_PER_MILLISECOND;
+}
+
 void video::flush() {
+	APOSTELLEIN_ZONE("video::flush");
 	if (!drv_) {
 		return;
 	}
+	const auto submitted = std::chrono::steady_clock::now();
 	SDL_GL_SwapWindow(drv_->window);
-	if (!drv_->vertical_sync and drv_->frame_rate > 0) {
-		// pre-calculate before tight loop
-		const auto duration = video::calculate_yield_duration_();
-		if (drv_->yield) {
-			while (1) {
-				const auto now = std::chrono::steady_clock::now();
-				if ((now - drv_->time).count() < duration) {
-					std::this_thread::yield();
-				} else {
-					break;
-				}
-			}
-		} else {
-			video::high_resolution_sleep_(duration);
+	const auto now = std::chrono::steady_clock::now();
+	// blocking on vblank isn't work, so it stays out of the prediction
+	const auto finished = drv_->vertical_sync ? submitted : now;
+	drv_->costs[drv_->cursor] = (finished - drv_->woken).count();
+	drv_->intervals[drv_->cursor] = (now - drv_->presented).count();
+	drv_->cursor = (drv_->cursor + 1) % PACING_HISTORY;
+	++drv_->samples;
+	drv_->presented = now;
+
+	const auto [mean, variance] = video::calculate_moments_(drv_->intervals);
+	drv_->stats.average = mean / NANOSECONDS_PER_MILLISECOND;
+	drv_->stats.variance = variance / (NANOSECONDS_PER_MILLISECOND * NANOSECONDS_PER_MILLISECOND);
+	if (const i64 period = video::calculate_frame_period_(); period > 0) {
+		const i64 interval = drv_->intervals[(drv_->cursor + PACING_HISTORY - 1) % PACING_HISTORY];
+		if (as<r64>(interval) > MISSED_FRAME_FACTOR * as<r64>(period)) {
+			++drv_->stats.missed;
 		}
 	}
-	drv_->time = std::chrono::steady_clock::now();
 }
 
 void video::full_screen(bool value) {
@@ -512,6 +589,14 @@ bool video::vertical_sync() {
 	return drv_->vertical_sync;
 }
 
+const video::statistics& video::stats() {
+	static const statistics NULL_STATISTICS {};
+	if (!drv_) {
+		return NULL_STATISTICS;
+	}
+	return drv_->stats;
+}
+
 std::tuple<void*, void*> video::pointers() {
 	if (!drv_) {
 		return { nullptr, nullptr };
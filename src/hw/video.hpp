@@ -6,7 +6,17 @@
 struct config_file;
 
 namespace video {
+	// milliseconds, except for the counter
+	struct statistics {
+		r64 average {};
+		r64 variance {};
+		r64 predicted {};
+		r64 slept {};
+		udx missed {};
+	};
 	void show();
+	// sleeps until the next frame has to start, call it before polling input
+	void pace();
 	void flush();
 	void full_screen(bool value);
 	void scaling(i32 value);
@@ -14,6 +24,7 @@ namespace video {
 	bool full_screen();
 	i32 scaling();
 	bool vertical_sync();
+	const statistics& stats();
 	std::tuple<void*, void*> pointers();
 	// Init-Guard
 	struct guard : public not_moveable {
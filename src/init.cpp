@@ -15,20 +15,30 @@
 #include "./hw/video.hpp"
 #include "./ctrl/runtime.hpp"
 #include "./util/buttons.hpp"
+#include "./util/memory-tracker.hpp"
 #include "./util/message-box.hpp"
+#include "./util/profiler.hpp"
+#include "./util/tick-clock.hpp"
 #include "./x2d/renderer.hpp"
 
 namespace {
 	using namespace std::chrono_literals;
 	constexpr auto MINIMUM_SLEEP = 30ms;
-	constexpr udx MAXIMUM_TICKS = 10;
+	constexpr r32 MAXIMUM_EXTRAPOLATION = 0.5f;
+	constexpr char MEMORY_NAME[] = "memory";
 }
 
 namespace {
 	std::atomic<bool> interrupt_ = false;
+	std::atomic<bool> report_ = false;
 	void apostellein_interrupt_handler_(int) {
 		interrupt_ = true;
 	}
+#if defined(SIGUSR1)
+	void apostellein_report_handler_(int) {
+		report_ = true;
+	}
+#endif
 }
 
 int main_loop(config_file& cfg) {
@@ -48,14 +58,8 @@ int main_loop(config_file& cfg) {
 		const auto now = std::chrono::steady_clock::now();
 		return (now - start).count();
 	};
-	auto accumulate_ticks = [&elapsed_time](auto& current) {
-		udx ticks = 0;
-		while (elapsed_time() >= current and ticks < MAXIMUM_TICKS) {
-			current += konst::NANOSECONDS_PER_TICK();
-			++ticks;
-		}
-		return ticks;
-	};
+	// input events are stamped in SDL ticks, which started at about the same time
+	const u32 origin = SDL_GetTicks();
 	// init input data
 	activity_type aty {};
 	buttons bts {};
@@ -70,45 +74,53 @@ int main_loop(config_file& cfg) {
 		return EXIT_FAILURE;
 	}
 	// init timers
-	i64 previous = 0;
-	i64 current = 0;
+	tick_clock timer {};
+	// ticks that run late are rendered slightly ahead instead of stalling
+	const r32 maximum_ratio = cfg.extrapolation() ?
+		1.0f + MAXIMUM_EXTRAPOLATION :
+		1.0f;
 	// show window
 	video::show();
 	// enter loop
+	APOSTELLEIN_THREAD("main");
 	while (input::poll(aty, bts)) {
 		if (interrupt_) {
 			spdlog::info("Recieved interrupt! Closing gracefully...");
 			break;
 		}
+		if (report_.exchange(false)) {
+			// handlers can't do any of this themselves
+			const std::string report = memory_tracker::report();
+			spdlog::info("Memory report:\n{}", report);
+			if (const std::string path = vfs::stats_path(MEMORY_NAME); !path.empty()) {
+				vfs::dump_string(report, path);
+			}
+		}
 		switch (aty) {
 			case activity_type::running: {
 				// Handle
-				const auto preserve = current;
-				if (const auto ticks = accumulate_ticks(current); ticks == MAXIMUM_TICKS) {
-					spdlog::warn("Long frame time just occurred: {}!", ticks);
-					previous = elapsed_time();
-					current = previous + konst::NANOSECONDS_PER_TICK();
-				} else if (ticks > 0) {
-					previous = preserve;
-					state.handle(ticks, aty, bts);
+				if (const auto ticks = timer.advance(elapsed_time()); ticks > 0) {
+					state.handle(
+						ticks,
+						origin + as<u32>(konst::NANOSECONDS_TO_MILLISECONDS(timer.previous())),
+						aty, bts
+					);
 					audio::flush();
+					// catch up as far as one frame allows, then drop whatever is left
+					if (const auto backlog = timer.drop(elapsed_time()); backlog > 0) {
+						spdlog::warn(
+							"Long frame time just occurred! Dropped {} ms of backlog.",
+							konst::NANOSECONDS_TO_MILLISECONDS(backlog)
+						);
+					}
 				}
 				// Update
 				state.update(delta_time());
 				// Render
-				const auto elapsed = elapsed_time();
-				{
-					if (current > previous) {
-						const auto ratio = (
-							as<r32>(elapsed - previous) /
-							as<r32>(current - previous)
-						);
-						state.render(ratio, rdr);
-					} else {
-						state.render(1.0f, rdr);
-					}
-					video::flush();
-				}
+				state.render(timer.ratio(elapsed_time(), maximum_ratio), rdr);
+				video::flush();
+				APOSTELLEIN_FRAME();
+				video::pace();
 				break;
 			}
 			case activity_type::stopped: {
@@ -181,6 +193,9 @@ int init(int argc, char** argv) {
 int main(int argc, char** argv) {
 	// Register signal handlers
 	std::signal(SIGINT, apostellein_interrupt_handler_);
+#if defined(SIGUSR1)
+	std::signal(SIGUSR1, apostellein_report_handler_);
+#endif
 
 	// Ideally exceptions are never thrown at all,
 	// but disabling them has gnarly side-effects.
@@ -0,0 +1,86 @@
+#include <fstream>
+#include <filesystem>
+#include <spdlog/spdlog.h>
+#include <nlohmann/json.hpp>
+#include <apostellein/cast.hpp>
+
+#include "./tool-common.hpp"
+#include "../util/animation-file.hpp"
+
+namespace {
+	constexpr char ANIM_ROUTE[] = "anim";
+	constexpr char JSON_EXTENSION[] = ".json";
+	constexpr char ANM_EXTENSION[] = ".anm";
+
+	bool compile_(const std::filesystem::path& path, animation_file& result) {
+		std::ifstream ifs { path, std::ios::binary };
+		if (!ifs.is_open()) {
+			spdlog::error("Couldn't open animation description: {}!", path.string());
+			return false;
+		}
+		const auto desc = nlohmann::json::parse(
+			ifs, // stream
+			nullptr, // parser callback
+			false, // no exceptions
+			true // ignore comments
+		);
+		if (desc.is_discarded()) {
+			spdlog::error("Couldn't parse animation description: {}!", path.string());
+			return false;
+		}
+		return result.compile(desc);
+	}
+}
+
+// Bakes every animation description under <data>/anim into a compiled animation
+// that sits right next to it. Passing --bench also compares load times across
+// the whole directory.
+int main(int argc, char** argv) {
+	tool::options opts {};
+	if (!tool::parse(argc, argv, opts)) {
+		return EXIT_FAILURE;
+	}
+	std::error_code code;
+	if (!std::filesystem::is_directory(opts.root / ANIM_ROUTE, code)) {
+		spdlog::error("\"{}\" doesn't have an animation directory!", opts.root.string());
+		return EXIT_FAILURE;
+	}
+
+	udx compiled = 0;
+	r64 description_total = 0.0;
+	r64 compiled_total = 0.0;
+	const udx failures = tool::walk(opts.root / ANIM_ROUTE, JSON_EXTENSION, [&](const std::filesystem::path& path) {
+		animation_file animation {};
+		if (!compile_(path, animation)) {
+			spdlog::error("Couldn't compile animation: {}!", path.string());
+			return false;
+		}
+		auto output = path;
+		output.replace_extension(ANM_EXTENSION);
+		if (!tool::emit<animation_file>(output, animation.dump(), "compiled animation")) {
+			return false;
+		}
+		++compiled;
+
+		if (opts.bench) {
+			description_total += tool::measure(opts.iterations, [&path] {
+				animation_file temp {};
+				compile_(path, temp);
+			});
+			compiled_total += tool::measure(opts.iterations, [&output] {
+				animation_file temp {};
+				temp.load(tool::buffer_bytes(output));
+			});
+		}
+		return true;
+	});
+	spdlog::info("Compiled {} animations.", compiled);
+	if (opts.bench and compiled > 0) {
+		spdlog::info(
+			"    description: {:.3f} ms, compiled: {:.3f} ms, speedup: {:.1f}x",
+			description_total, compiled_total,
+			compiled_total > 0.0 ? description_total / compiled_total : 0.0
+		);
+	}
+	return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
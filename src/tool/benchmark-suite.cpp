@@ -0,0 +1,1062 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <new>
+#include <random>
+#include <spdlog/spdlog.h>
+#include <spdlog/sinks/stdout_color_sinks.h>
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <nlohmann/json.hpp>
+#include <pxtone/pxtnService.h>
+#include <apostellein/konst.hpp>
+#include <apostellein/cast.hpp>
+
+#include "../audio/software-mixer.hpp"
+#include "../ctrl/controller.hpp"
+#include "../ctrl/kernel.hpp"
+#include "../ecs/aktor.hpp"
+#include "../ecs/collision.hpp"
+#include "../ecs/kinematics.hpp"
+#include "../ecs/thinker.hpp"
+#include "../field/camera.hpp"
+#include "../field/environment.hpp"
+#include "../field/player.hpp"
+#include "../gui/text.hpp"
+#include "../hw/vfs.hpp"
+#include "../menu/dialogue.hpp"
+#include "../menu/headsup.hpp"
+#include "../menu/inventory.hpp"
+#include "../menu/overlay.hpp"
+#include "../util/buttons.hpp"
+#include "../util/byte-stream.hpp"
+#include "../util/config-file.hpp"
+#include "../util/field-file.hpp"
+#include "../util/save-file.hpp"
+#include "../util/tick-clock.hpp"
+#include "../video/index-buffer.hpp"
+#include "../video/material.hpp"
+#include "../video/shader.hpp"
+#include "../x2d/animation-group.hpp"
+#include "../x2d/bitmap-font.hpp"
+#include "../x2d/display-list.hpp"
+#include "../x2d/mirror-type.hpp"
+#include "../x2d/tile-map.hpp"
+
+namespace {
+	constexpr char FILTER_ARGUMENT[] = "--filter";
+	constexpr char SCRATCH_DIRECTORY[] = "apostellein-bench";
+	constexpr char FONT_NAME[] = "font.json";
+	constexpr char LANGUAGE_NAME[] = "language.json";
+	constexpr char DIALOGUE_ENTRY[] = "Dialogue";
+	constexpr u32 REPORT_VERSION = 1;
+	constexpr u32 SEED = 0x41504F53;
+	constexpr udx SAMPLES = 7;
+	constexpr i64 MINIMUM_SAMPLE = 20'000'000;
+	constexpr udx MAXIMUM_ITERATIONS = 1 << 24;
+	// mirrors the header that field_file writes
+	constexpr char FIELD_MAGIC[4] = { 'A', 'P', 'F', 'D' };
+	constexpr i32 FIELD_WIDTH = 256;
+	constexpr i32 FIELD_HEIGHT = 64;
+	constexpr udx PROBES = 256;
+	constexpr r32 TRACE_DISTANCE = 320.0f;
+	constexpr udx SPRITES = 1024;
+	constexpr udx ANIMATION_FRAMES = 4;
+	constexpr udx ANIMATION_VARIATIONS = 4;
+	constexpr udx AKTORS = 1024;
+	constexpr i32 MUSIC_RATE = 44100;
+	constexpr i32 MUSIC_CHANNELS = 2;
+	constexpr i32 MUSIC_FRAMES = 4096;
+	constexpr i32 MUSIC_MEASURES = 16;
+	constexpr i32 MUSIC_CLOCK = 480;
+	constexpr i32 MUSIC_EVENTS = 4096;
+	constexpr i32 WOICE_RATE = 22050;
+	constexpr udx MIXER_FRAMES = 1024;
+	constexpr udx DIALOGUE_LINES = 96;
+	constexpr udx DIALOGUE_WORDS = 9;
+	constexpr udx DIALOGUE_PAGE = 3;
+	constexpr udx SAVE_ITEMS = 30;
+	constexpr udx SAVE_FLAGS = 64;
+	constexpr udx SLEEPERS = 500;
+	constexpr udx THINKERS = 1000;
+	constexpr i32 CUTSCENE_ID = 1;
+	constexpr udx CUTSCENE_TICKS = 64;
+	constexpr udx GARBAGE_TABLES = 256;
+	constexpr udx COLLECTION_TICKS = 600;
+	constexpr udx COLLECTION_CYCLES = 2;
+	constexpr i32 COLLECTION_BUDGET = 500;
+	// mirrors the pause kernel::collect waits out between cycles
+	constexpr udx COLLECTION_PAUSE = 150;
+	constexpr r64 COLLECTION_OVERRUN = 2.0;
+	constexpr udx CLOCK_FRAMES = 600;
+	constexpr udx STALL_FRAME = 300;
+	constexpr i64 STALL_LENGTH = 500'000'000;
+	constexpr r32 MAXIMUM_RATIO = 1.5f;
+
+	constexpr char LATIN_TEXT[] =
+		"The lighthouse keeper counted the waves twice before answering.\n"
+		"\t\"Nobody has climbed those stairs since the storm,\" she said, "
+		"wiping salt from the brass railing. \"Not even the gulls.\"\n";
+	constexpr char MIXED_TEXT[] =
+		"Ferry timetable / \xE6\x99\x82\xE5\x88\xBB\xE8\xA1\xA8\n"
+		"\xE3\x81\x82\xE3\x81\x97\xE3\x81\x9F\xE3\x81\xAE\xE3\x81\xB5\xE3\x81\xAD\xE3\x81\xAF "
+		"\xE3\x81\x8F\xE3\x81\x98\xE3\x81\xAB\xE3\x81\xA7\xE3\x81\xBE\xE3\x81\x99\xE3\x80\x82\n"
+		"\tK\xC3\xB8" "benhavn \xE2\x86\x92 Malm\xC3\xB6, \xE6\xB8\xAF\xE3\x81\xBE\xE3\x81\xA7 20 min.\n";
+	// every routine wakes on its own period, so only a few resume per tick
+	constexpr char SLEEPER_SOURCE[] =
+		"for it = 1, {} do\n"
+			"sys.spawn(function()\n"
+				"while true do\n"
+					"sys.wait(0.25 + (it % 60) / 60)\n"
+				"end\n"
+			"end)\n"
+		"end\n";
+	// bounces every member off the floor, the kind of work a thinker does
+	constexpr char THINKER_SOURCE[] =
+		"env.thinker(\"bench.drifter\", function(count, batch)\n"
+			"for it = 1, count do\n"
+				"if batch.y[it] > 256 then\n"
+					"batch.vy[it] = -batch.vy[it]\n"
+					"batch.state[it] = 2\n"
+				"else\n"
+					"batch.vy[it] = batch.vy[it] + 0.25\n"
+					"batch.state[it] = 1\n"
+				"end\n"
+			"end\n"
+		"end)\n";
+	// waits a tick between steps like a scripted scene would
+	constexpr char CUTSCENE_SOURCE[] =
+		"env.event({0}, function()\n"
+			"sys.lock()\n"
+			"for step = 1, 8 do\n"
+				"sfx.sound(\"bench.step\", 3)\n"
+				"env.animate({0}, step % 3 + 1, 1)\n"
+				"env.think({0}, step)\n"
+				"sys.flag(step, true)\n"
+				"sys.wait(0)\n"
+			"end\n"
+			"sys.unlock()\n"
+		"end)\n";
+	// leaves a few hundred dead tables behind every tick
+	constexpr char GARBAGE_SOURCE[] =
+		"sys.spawn(function()\n"
+			"while true do\n"
+				"local heap = {{}}\n"
+				"for it = 1, {} do\n"
+					"heap[it] = {{ it, it * 2 }}\n"
+				"end\n"
+				"sys.wait(0)\n"
+			"end\n"
+		"end)\n";
+	// vocabulary for the synthesized dialogue, mixing scripts like a translation would
+	constexpr const char* DIALOGUE_VOCABULARY[] = {
+		"the", "lighthouse", "keeper", "said", "nobody", "climbed", "stairs",
+		"storm,", "gulls.", "\"Wait!\"", "ferry", "K\xC3\xB8" "benhavn", "\xE2\x86\x92",
+		"\xE3\x81\x82\xE3\x81\x97\xE3\x81\x9F", "\xE3\x81\xB5\xE3\x81\xAD",
+		"\xE6\xB8\xAF", "\xE6\x99\x82\xE5\x88\xBB\xE8\xA1\xA8\xE3\x80\x82"
+	};
+	constexpr char32_t KANA_FIRST = 0x3041;
+	constexpr char32_t KANA_LAST = 0x3096;
+	constexpr char32_t EXTRA_GLYPHS[] = {
+		0x00F8, 0x00F6, 0x2192, 0x3002,
+		0x6642, 0x523B, 0x8868, 0x6E2F
+	};
+	constexpr const char* AKTOR_TYPES[] = {
+		"bench.ghost",
+		"bench.door",
+		"bench.chest",
+		"bench.spikes",
+		"bench.lamp",
+		"bench.villager",
+		"bench.save_point",
+		"bench.elevator"
+	};
+
+	std::atomic<udx> allocations_ {};
+	volatile udx sink_ {};
+
+	// Only the vertices are wanted, so staging never leaves the CPU
+	struct staging_quad_buffer : public quad_buffer {
+		staging_quad_buffer(udx quads, const vertex_format& format) : quad_buffer{ index_buffer{}, format } {
+			length_ = quads * display_list::QUAD;
+			staging_ = std::make_unique<char[]>(format_.size * length_);
+		}
+	public:
+		bool draw(const shader_program&, udx count) noexcept override {
+			uploaded_ = format_.size * count;
+			this->invalidate();
+			return true;
+		}
+		bool valid() const noexcept override { return staging_ != nullptr; }
+	protected:
+		char* staging() noexcept override {
+			return staging_.get();
+		}
+	private:
+		std::unique_ptr<char[]> staging_ {};
+	};
+
+	// Everything the kernel binds to. None of it draws, so defaults are enough.
+	struct script_host : public not_copyable {
+	public:
+		bool build(const std::string& source) {
+			return knl.build(source, cfg, ctl, ovl, hud, dlg, cam, plr, env);
+		}
+		void tick() {
+			knl.update(konst::NANOSECONDS_PER_TICK());
+			knl.handle(bts, ctl, ovl, hud, dlg, ivt);
+			knl.collect();
+		}
+		config_file cfg {};
+		buttons bts {};
+		controller ctl {};
+		overlay ovl {};
+		headsup hud {};
+		dialogue dlg {};
+		inventory ivt {};
+		camera cam {};
+		player plr {};
+		environment env {};
+		// declared last so it goes away before anything it binds to
+		kernel knl {};
+	};
+
+	struct suite : public not_copyable {
+	public:
+		suite(const std::string& filter) : filter_{ filter } {}
+		// Doubles the batch until one sample takes long enough to trust,
+		// then keeps the median of several samples.
+		void run(const std::string& name, const std::function<udx()>& func) {
+			if (!filter_.empty() and name.find(filter_) == std::string::npos) {
+				return;
+			}
+			sink_ = sink_ + func();
+
+			udx iterations = 1;
+			while (this->measure_(iterations, func) < MINIMUM_SAMPLE and iterations < MAXIMUM_ITERATIONS) {
+				iterations *= 2;
+			}
+			std::vector<r64> samples {};
+			const udx before = allocations_.load(std::memory_order_relaxed);
+			for (udx it = 0; it < SAMPLES; ++it) {
+				samples.push_back(as<r64>(this->measure_(iterations, func)) / as<r64>(iterations));
+			}
+			const udx allocations = allocations_.load(std::memory_order_relaxed) - before;
+			std::sort(samples.begin(), samples.end());
+
+			const r64 median = samples[samples.size() / 2];
+			spdlog::info("{:<40} {:>14.1f} ns", name, median);
+			results_.push_back({
+				{ "name", name },
+				{ "iterations", iterations },
+				{ "median_ns", median },
+				{ "minimum_ns", samples.front() },
+				{ "maximum_ns", samples.back() },
+				{ "allocations", as<r64>(allocations) / as<r64>(iterations * SAMPLES) }
+			});
+		}
+		nlohmann::json report() const {
+			return {
+				{ "version", REPORT_VERSION },
+				{ "timestamp", std::chrono::duration_cast<std::chrono::seconds>(
+					std::chrono::system_clock::now().time_since_epoch()
+				).count() },
+				{ "samples", SAMPLES },
+				{ "benchmarks", results_ }
+			};
+		}
+	private:
+		i64 measure_(udx iterations, const std::function<udx()>& func) {
+			udx total = 0;
+			const auto start = std::chrono::steady_clock::now();
+			for (udx it = 0; it < iterations; ++it) {
+				total += func();
+			}
+			const auto elapsed = std::chrono::steady_clock::now() - start;
+			sink_ = sink_ + total;
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+		}
+		std::string filter_ {};
+		nlohmann::json results_ = nlohmann::json::array();
+	};
+
+	// Solid border, scattered blocks, and runs of slopes along the floor
+	std::vector<byte> synthesize_field_() {
+		std::minstd_rand engine { SEED };
+		std::uniform_int_distribution<u32> roll { 0, 99 };
+		const udx length = as<udx>(FIELD_WIDTH) * as<udx>(FIELD_HEIGHT);
+		std::vector<u32> attributes(length);
+		std::vector<i32> solid(length, -1);
+		std::vector<i32> decor(length, -1);
+		for (i32 y = 0; y < FIELD_HEIGHT; ++y) {
+			for (i32 x = 0; x < FIELD_WIDTH; ++x) {
+				const udx idx = as<udx>(x) + as<udx>(y) * as<udx>(FIELD_WIDTH);
+				const u32 chance = roll(engine);
+				tile_type tile {};
+				if (x == 0 or y == 0 or x == FIELD_WIDTH - 1 or y >= FIELD_HEIGHT - 2) {
+					tile.flags.block = true;
+				} else if (y == FIELD_HEIGHT - 3 and chance < 30) {
+					tile.flags.sloped = true;
+					tile.flags.floor = true;
+					if (chance < 15) {
+						tile.flags.positive = true;
+					} else {
+						tile.flags.negative = true;
+					}
+					if (chance % 2 == 0) {
+						tile.flags.high = true;
+					} else {
+						tile.flags.low = true;
+					}
+				} else if (chance < 6) {
+					tile.flags.block = true;
+				}
+				attributes[idx] = tile.flags._raw.value();
+				if (tile.any()) {
+					solid[idx] = as<i32>(chance);
+				} else if (chance > 90) {
+					decor[idx] = as<i32>(chance);
+				}
+			}
+		}
+
+		byte_writer stream {};
+		stream.put(FIELD_MAGIC);
+		stream.put(field_file::VERSION);
+		stream.put(rect {
+			0.0f, 0.0f,
+			as<r32>(FIELD_WIDTH * konst::TILE<i32>()),
+			as<r32>(FIELD_HEIGHT * konst::TILE<i32>())
+		});
+		stream.put(std::string{});
+		stream.put(attributes);
+		stream.put(as<u32>(0));
+		stream.put(as<u32>(2));
+		stream.put(true);
+		stream.put(false);
+		stream.put(solid);
+		stream.put(false);
+		stream.put(true);
+		stream.put(decor);
+		stream.put(as<u32>(0));
+		stream.put(as<u32>(0));
+		return std::move(stream.buffer);
+	}
+
+	nlohmann::json synthesize_font_() {
+		nlohmann::json chars = nlohmann::json::array();
+		auto glyph = [&chars](char32_t code, udx slot) {
+			chars.push_back({
+				{ "-id", as<u32>(code) },
+				{ "-x", as<r32>((slot % 32) * 16) },
+				{ "-y", as<r32>((slot / 32) * 16) },
+				{ "-width", 12.0f },
+				{ "-height", 14.0f },
+				{ "-xoffset", 0.0f },
+				{ "-yoffset", 2.0f },
+				{ "-xadvance", code < bitmap_font::DENSE_GLYPHS ? 8.0f : 14.0f },
+				{ "-chnl", 15 }
+			});
+		};
+		udx slot = 0;
+		for (char32_t code = U' '; code <= U'~'; ++code) {
+			glyph(code, slot++);
+		}
+		for (char32_t code = KANA_FIRST; code <= KANA_LAST; ++code) {
+			glyph(code, slot++);
+		}
+		for (auto&& code : EXTRA_GLYPHS) {
+			glyph(code, slot++);
+		}
+		nlohmann::json kernings = nlohmann::json::array();
+		for (char32_t first = U'A'; first <= U'Z'; ++first) {
+			for (char32_t second = U'a'; second <= U'z'; second += 5) {
+				kernings.push_back({
+					{ "-first", as<u32>(first) },
+					{ "-second", as<u32>(second) },
+					{ "-amount", -1.0f }
+				});
+			}
+		}
+		return {
+			{ "font", {
+				{ "common", { { "-base", 12.0f }, { "-lineHeight", 16.0f } } },
+				{ "chars", { { "char", chars } } },
+				{ "kernings", { { "kerning", kernings } } },
+				// never found, since there's no file system mounted
+				{ "pages", { { "page", { { "-file", "bench" } } } } }
+			} }
+		};
+	}
+
+	// A language file with one long conversation, shaped like the ones under i18n
+	nlohmann::json synthesize_language_() {
+		std::mt19937 engine { SEED };
+		std::uniform_int_distribution<udx> pick { 0, std::size(DIALOGUE_VOCABULARY) - 1 };
+		nlohmann::json lines = nlohmann::json::array();
+		for (udx line = 0; line < DIALOGUE_LINES; ++line) {
+			std::string words {};
+			for (udx it = 0; it < DIALOGUE_WORDS; ++it) {
+				words += DIALOGUE_VOCABULARY[pick(engine)];
+				words += it + 1 < DIALOGUE_WORDS ? ' ' : '\n';
+			}
+			lines.push_back(words);
+		}
+		return { { DIALOGUE_ENTRY, lines } };
+	}
+
+	// One second of a sine wave as a 16-bit mono wav
+	std::vector<char> synthesize_woice_() {
+		std::vector<char> buffer {};
+		auto put = [&buffer](const auto& value) {
+			const auto ptr = reinterpret_cast<const char*>(&value);
+			buffer.insert(buffer.end(), ptr, ptr + sizeof(value));
+		};
+		const auto length = as<u32>(WOICE_RATE * as<i32>(sizeof(i16)));
+		buffer.insert(buffer.end(), { 'R', 'I', 'F', 'F' });
+		put(as<u32>(36) + length);
+		buffer.insert(buffer.end(), { 'W', 'A', 'V', 'E', 'f', 'm', 't', ' ' });
+		put(as<u32>(16));
+		put(as<u16>(1));
+		put(as<u16>(1));
+		put(as<u32>(WOICE_RATE));
+		put(length);
+		put(as<u16>(sizeof(i16)));
+		put(as<u16>(16));
+		buffer.insert(buffer.end(), { 'd', 'a', 't', 'a' });
+		put(length);
+		for (i32 it = 0; it < WOICE_RATE; ++it) {
+			const r64 phase = as<r64>(it) * 440.0 * 2.0 * 3.14159265358979 / as<r64>(WOICE_RATE);
+			put(as<i16>(std::sin(phase) * 8000.0));
+		}
+		return buffer;
+	}
+
+	void bench_collision_(suite& s) {
+		field_file field {};
+		if (!field.load(synthesize_field_())) {
+			spdlog::error("Couldn't synthesize field!");
+			return;
+		}
+		tile_map map {};
+		map.load(field);
+
+		std::minstd_rand engine { SEED };
+		std::uniform_real_distribution<r32> across { konst::TILE<r32>(), as<r32>((FIELD_WIDTH - 1) * konst::TILE<i32>()) };
+		std::uniform_real_distribution<r32> down { konst::TILE<r32>(), as<r32>((FIELD_HEIGHT - 1) * konst::TILE<i32>()) };
+		std::uniform_real_distribution<r32> turn { 0.0f, 6.2831853f };
+		std::vector<glm::vec2> origins {};
+		std::vector<r32> angles {};
+		for (udx it = 0; it < PROBES; ++it) {
+			origins.emplace_back(across(engine), down(engine));
+			angles.push_back(turn(engine));
+		}
+		const composite_rect hitbox {
+			{ 4.0f, 4.0f, 6.0f, 8.0f },
+			{ 10.0f, 4.0f, 6.0f, 8.0f },
+			{ 4.0f, 0.0f, 8.0f, 8.0f },
+			{ 4.0f, 8.0f, 8.0f, 8.0f }
+		};
+		const ecs::kinematics kin {};
+		s.run("collision::check", [&] {
+			udx result = 0;
+			for (auto&& origin : origins) {
+				for (auto side : { side_type::right, side_type::left, side_type::top, side_type::bottom }) {
+					const rect delta = hitbox.side(side, origin, 2.0f);
+					if (collision::check(map, kin, delta, side)) {
+						++result;
+					}
+				}
+			}
+			return result;
+		});
+		s.run("collision::trace", [&] {
+			udx result = 0;
+			for (udx it = 0; it < PROBES; ++it) {
+				const glm::vec2 end = collision::trace(map, origins[it], angles[it], TRACE_DISTANCE);
+				result += as<udx>(glm::distance(origins[it], end));
+			}
+			return result;
+		});
+
+		tile_layer layer { map.dimensions() };
+		layer.build(field.layers().front());
+		material atlas {};
+		atlas.offset(1, 256, 512);
+		const glm::ivec2 screen {
+			(konst::WINDOW_WIDTH<i32>() / konst::TILE<i32>()) + 1,
+			(konst::WINDOW_HEIGHT<i32>() / konst::TILE<i32>()) + 1
+		};
+		i32 scroll = 0;
+		s.run("tile_layer::handle", [&] {
+			scroll = (scroll + 1) % (map.dimensions().x - screen.x);
+			const glm::ivec2 first { scroll, 0 };
+			layer.handle(first, first + screen, map.dimensions(), &atlas);
+			return as<udx>(scroll);
+		});
+	}
+
+	void bench_display_list_(suite& s) {
+		display_list list {
+			priority_type::automatic,
+			blending_type::alpha,
+			pipeline_type::sprite,
+			std::make_unique<staging_quad_buffer>(SPRITES, vertex_format::of<vtx_sprite>())
+		};
+		material atlas {};
+		atlas.offset(2, 128, 64);
+		const shader_program program {};
+		const rect uvs { 16.0f, 32.0f, 16.0f, 16.0f };
+		s.run("display_list::batch_sprite", [&] {
+			for (udx it = 0; it < SPRITES; ++it) {
+				const glm::vec2 position {
+					as<r32>((it % 40) * 16),
+					as<r32>((it / 40) * 16)
+				};
+				list.batch_sprite(position, konst::TILE_DIMENSIONS<r32>(), uvs, atlas);
+			}
+			list.flush(program, false);
+			return list.stats().quads;
+		});
+	}
+
+	void bench_animation_(suite& s) {
+		animation_header header {};
+		header.dimensions = { 32.0f, 48.0f };
+		header.delay = konst::SECONDS_TO_NANOSECONDS(0.1);
+		header.count = as<u32>(ANIMATION_FRAMES);
+		header.frames = as<u32>(ANIMATION_FRAMES * ANIMATION_VARIATIONS);
+		header.flags = animation_file::REPEATING;
+		std::vector<animation_frame> frames {};
+		for (udx it = 0; it < header.frames; ++it) {
+			frames.emplace_back(
+				glm::vec2{ as<r32>(it % ANIMATION_FRAMES) * 32.0f, as<r32>(it / ANIMATION_FRAMES) * 48.0f },
+				glm::vec2{ 16.0f, 40.0f }
+			);
+		}
+		const animation_sequence sequence { header, frames.data(), nullptr };
+		const mirror_type mirror { true, false };
+		const glm::vec2 scale { 1.0f, 1.0f };
+		const glm::vec2 pivot { 16.0f, 24.0f };
+		s.run("animation_sequence::raster_with", [&] {
+			udx result = 0;
+			for (udx it = 0; it < SPRITES; ++it) {
+				const glm::vec2 position { as<r32>(it), as<r32>(it / 2) };
+				const auto raster = sequence.raster_with(
+					it % ANIMATION_FRAMES,
+					(it / ANIMATION_FRAMES) % ANIMATION_VARIATIONS,
+					mirror, scale, position
+				);
+				result += as<udx>(glm::abs(raster.bounds.x));
+			}
+			return result;
+		});
+		s.run("animation_sequence::raster_with (rotated)", [&] {
+			udx result = 0;
+			for (udx it = 0; it < SPRITES; ++it) {
+				const glm::vec2 position { as<r32>(it), as<r32>(it / 2) };
+				const auto raster = sequence.raster_with(
+					it % ANIMATION_FRAMES,
+					(it / ANIMATION_FRAMES) % ANIMATION_VARIATIONS,
+					mirror, scale, as<r32>(it) * 0.01f, pivot, position
+				);
+				result += as<udx>(glm::abs(raster.points[2].x));
+			}
+			return result;
+		});
+	}
+
+	void bench_text_(suite& s, const std::filesystem::path& scratch) {
+		const std::string path = (scratch / FONT_NAME).string();
+		if (!vfs::dump_json(synthesize_font_(), path)) {
+			return;
+		}
+		s.run("vfs::buffer_json", [&path] {
+			return vfs::buffer_json(path).size();
+		});
+
+		bitmap_font font {};
+		font.load(scratch.string(), path);
+		std::u32string output {};
+		const std::string latin { LATIN_TEXT };
+		const std::string mixed { MIXED_TEXT };
+		s.run("gui::unicode", [&] {
+			output.clear();
+			gui::unicode(latin, output);
+			gui::unicode(mixed, output);
+			return output.size();
+		});
+
+		gui::text text {};
+		const glm::vec2 position { 32.0f, 32.0f };
+		s.run("gui::text (latin)", [&] {
+			text.build(position, {}, chroma::WHITE(), &font, latin);
+			return text.drawable();
+		});
+		s.run("gui::text (mixed scripts)", [&] {
+			text.build(position, {}, chroma::WHITE(), &font, mixed);
+			return text.drawable();
+		});
+		s.run("gui::text::fix", [&] {
+			text.fix(&font);
+			return text.drawable();
+		});
+
+		// the script reaches the textbox as utf-32, one say() per line
+		const std::string language = (scratch / LANGUAGE_NAME).string();
+		if (!vfs::dump_json(synthesize_language_(), language)) {
+			return;
+		}
+		std::vector<std::u32string> script {};
+		for (auto&& line : vfs::buffer_json(language)[DIALOGUE_ENTRY]) {
+			gui::unicode(line.get<std::string>(), script.emplace_back());
+		}
+		text.build(position, {}, chroma::WHITE(), &font, {});
+		s.run("gui::text::append (dialogue script)", [&] {
+			udx result = 0;
+			for (udx it = 0; it < script.size(); ++it) {
+				if (it % DIALOGUE_PAGE == 0) {
+					text.clear();
+				}
+				text.append(script[it], false);
+				result += text.drawable();
+			}
+			return result;
+		});
+		s.run("gui::text typewriter (dialogue script)", [&] {
+			udx result = 0;
+			for (udx it = 0; it < script.size(); ++it) {
+				if (it % DIALOGUE_PAGE == 0) {
+					text.clear();
+				}
+				text.append(script[it], false);
+				// one letter per tick, the way dialogue reveals it
+				while (!text.finished()) {
+					text.handle();
+					++result;
+				}
+			}
+			return result;
+		});
+	}
+
+	void bench_environment_(suite& s) {
+		environment env {};
+		std::vector<entt::hashed_string> types {};
+		for (auto&& name : AKTOR_TYPES) {
+			types.emplace_back(name);
+		}
+		for (udx it = 0; it < AKTORS; ++it) {
+			const auto e = env.allocate();
+			// the rarest type only shows up at the very end
+			const udx type = it + 1 == AKTORS ?
+				types.size() - 1 :
+				it % (types.size() - 1);
+			env.emplace<ecs::aktor>(e, types[type]);
+			env.emplace<ecs::trigger>(e, as<i32>(it + 1), 0u);
+		}
+		s.run("environment::search (type)", [&] {
+			return as<udx>(entt::to_integral(env.search(types.back())));
+		});
+		s.run("environment::search (id)", [&] {
+			return as<udx>(entt::to_integral(env.search(as<i32>(AKTORS))));
+		});
+	}
+
+	void bench_routines_(suite& s) {
+		auto host = std::make_unique<script_host>();
+		if (!host->build(fmt::format(SLEEPER_SOURCE, SLEEPERS))) {
+			spdlog::error("Couldn't spawn sleeping routines!");
+			return;
+		}
+		s.run("kernel::handle (500 sleeping routines)", [&host] {
+			host->tick();
+			return host->knl.stats().sleeping;
+		});
+	}
+
+	// the same bounce as THINKER_SOURCE, for comparing against a native thinker
+	void drifter_tick_(entt::entity e, kernel&, camera&, player&, environment& env) {
+		auto [loc, kin, thk] = env.get<ecs::location, ecs::kinematics, ecs::thinker>(e);
+		if (loc.position.y > 256.0f) {
+			kin.velocity.y = -kin.velocity.y;
+			thk.state = 1;
+		} else {
+			kin.velocity.y += 0.25f;
+			thk.state = 0;
+		}
+	}
+
+	void drifter_ctor_(entt::entity e, environment& env) {
+		env.emplace<ecs::thinker>(e, drifter_tick_);
+	}
+
+	void bench_thinkers_(suite& s) {
+		auto host = std::make_unique<script_host>();
+		if (!host->build(THINKER_SOURCE)) {
+			spdlog::error("Couldn't register scripted thinker!");
+			return;
+		}
+		auto& env = host->env;
+		entt::entity first = entt::null;
+		for (udx it = 0; it < THINKERS; ++it) {
+			const auto e = env.allocate();
+			if (first == entt::null) {
+				first = e;
+			}
+			env.emplace<ecs::location>(e, glm::vec2{ as<r32>(it % 40) * 16.0f, as<r32>(it / 40) * 16.0f });
+			env.emplace<ecs::kinematics>(e, glm::vec2{ 1.0f, 0.0f });
+			// the first registered type gets index zero
+			env.emplace<ecs::script_thinker>(e, 0u);
+		}
+		s.run("kernel::think (1k scripted thinkers)", [&host, first] {
+			host->knl.think(host->env);
+			return as<udx>(host->env.get<ecs::script_thinker>(first).state);
+		});
+
+		// same members and layout, but spawned through a native thinker_ctor
+		auto native = std::make_unique<script_host>();
+		if (!native->build({})) {
+			spdlog::error("Couldn't build kernel for native thinkers!");
+			return;
+		}
+		const ecs::thinker_ctor ctor = drifter_ctor_;
+		first = entt::null;
+		for (udx it = 0; it < THINKERS; ++it) {
+			const auto e = native->env.allocate();
+			if (first == entt::null) {
+				first = e;
+			}
+			native->env.emplace<ecs::location>(e, glm::vec2{ as<r32>(it % 40) * 16.0f, as<r32>(it / 40) * 16.0f });
+			native->env.emplace<ecs::kinematics>(e, glm::vec2{ 1.0f, 0.0f });
+			ctor(e, native->env);
+		}
+		s.run("ecs::thinker::handle (1k native thinkers)", [&native, first] {
+			ecs::thinker::handle(native->knl, native->cam, native->plr, native->env);
+			return as<udx>(native->env.get<ecs::thinker>(first).state);
+		});
+	}
+
+	void bench_cutscene_(suite& s) {
+		auto host = std::make_unique<script_host>();
+		// events can only be bound to aktors that already exist
+		const auto e = host->env.allocate();
+		host->env.emplace<ecs::location>(e);
+		host->env.emplace<ecs::trigger>(e, CUTSCENE_ID, 0u);
+		if (!host->build(fmt::format(CUTSCENE_SOURCE, CUTSCENE_ID))) {
+			spdlog::error("Couldn't bind cutscene event!");
+			return;
+		}
+		s.run("kernel cutscene (8 steps)", [&host] {
+			if (!host->knl.run_event(CUTSCENE_ID)) {
+				return udx{ 0 };
+			}
+			udx ticks = 0;
+			while (host->knl.running() and ticks < CUTSCENE_TICKS) {
+				host->tick();
+				++ticks;
+			}
+			return ticks;
+		});
+	}
+
+	// Ticks the kernel like runtime::update does, checking every collection
+	// against the pause and the budget, and that the stats the debugger shows
+	// add up. Returns how many cycles finished, or zero if a check failed.
+	udx simulate_collection_(script_host& host) {
+		auto& knl = host.knl;
+		const r64 budget = as<r64>(host.cfg.collection_budget()) / 1000.0;
+		udx settled = 0;
+		udx cycles = 0;
+		udx paused = 0;
+		r64 longest = 0.0;
+		for (udx tick = 0; tick < COLLECTION_TICKS; ++tick) {
+			knl.update(konst::NANOSECONDS_PER_TICK());
+			knl.handle(host.bts, host.ctl, host.ovl, host.hud, host.dlg, host.ivt);
+			const udx bytes = knl.heap().bytes;
+			const kernel::stats_type before = knl.stats();
+			knl.collect();
+			const auto& after = knl.stats();
+
+			const bool due = bytes * 100 >= settled * COLLECTION_PAUSE;
+			if ((after.steps > before.steps) != due) {
+				spdlog::error("Lua collection didn't respect its pause on tick {}!", tick);
+				return 0;
+			}
+			if (!due) {
+				++paused;
+				continue;
+			}
+			if (after.collection > budget * COLLECTION_OVERRUN) {
+				spdlog::error(
+					"Lua collection took {:.3f} ms on tick {}, over its {:.3f} ms budget!",
+					after.collection, tick, budget
+				);
+				return 0;
+			}
+			longest = std::max(longest, after.collection);
+			if (after.cycles > before.cycles) {
+				++cycles;
+				settled = knl.heap().bytes;
+			}
+		}
+		const auto& stats = knl.stats();
+		if (stats.cycles != cycles or stats.longest != longest or knl.heap().peak < knl.heap().bytes) {
+			spdlog::error("Lua collection stats don't match what was collected!");
+			return 0;
+		}
+		if (cycles < COLLECTION_CYCLES or paused == 0) {
+			spdlog::error("Lua collection finished {} cycles and paused {} ticks!", cycles, paused);
+			return 0;
+		}
+		return cycles;
+	}
+
+	bool bench_collection_(suite& s) {
+		auto host = std::make_unique<script_host>();
+		host->cfg.collection_budget(COLLECTION_BUDGET);
+		if (!host->build(fmt::format(GARBAGE_SOURCE, GARBAGE_TABLES))) {
+			spdlog::error("Couldn't spawn garbage routine!");
+			return false;
+		}
+		if (simulate_collection_(*host) == 0) {
+			return false;
+		}
+		s.run("kernel::collect (garbage routine)", [&host] {
+			host->tick();
+			return host->knl.stats().steps;
+		});
+		return true;
+	}
+
+	void bench_music_(suite& s) {
+		pxtnService service {};
+		if (service.init_collage(MUSIC_EVENTS) != pxtnERR::pxtnOK or !service.set_destination_quality(MUSIC_CHANNELS, MUSIC_RATE)) {
+			spdlog::error("Couldn't initialize pxtone service!");
+			return;
+		}
+		service.master->Set(4, 120.0f, MUSIC_CLOCK);
+		std::vector<char> woice = synthesize_woice_();
+		pxtnDescriptor descriptor {};
+		if (
+			!descriptor.set_memory_r(woice.data(), as<i32>(woice.size())) or
+			service.Woice_read(0, &descriptor, pxtnWOICE_PCM) != pxtnERR::pxtnOK or
+			!service.Unit_AddNew()
+		) {
+			spdlog::error("Couldn't synthesize pxtone voice!");
+			return;
+		}
+		for (i32 measure = 0; measure < MUSIC_MEASURES * 4; ++measure) {
+			const i32 clock = measure * MUSIC_CLOCK;
+			service.evels->Record_Add_i(clock, 0, EVENTKIND_VOICENO, 0);
+			service.evels->Record_Add_i(clock, 0, EVENTKIND_KEY, 0x4000 + (measure % 8) * 0x100);
+			service.evels->Record_Add_i(clock, 0, EVENTKIND_ON, MUSIC_CLOCK / 2);
+		}
+		service.AdjustMeasNum();
+		pxtnVOMITPREPARATION preparation {};
+		preparation.flags |= pxtnVOMITPREPFLAG_loop;
+		preparation.master_volume = 1.0f;
+		if (service.tones_ready() != pxtnERR::pxtnOK or !service.moo_preparation(&preparation)) {
+			spdlog::error("Couldn't prepare synthesized tune!");
+			return;
+		}
+		std::vector<i16> samples(as<udx>(MUSIC_FRAMES * MUSIC_CHANNELS));
+		s.run("pxtnService::Moo", [&] {
+			const bool result = service.Moo(samples.data(), as<i32>(samples.size() * sizeof(i16)));
+			return result ? samples.size() : 0;
+		});
+	}
+
+	// Every voice the mixer can hold, each reading its own slice of noise
+	void bench_mixer_(suite& s) {
+		constexpr udx CHANNELS = software_mixer::CHANNELS;
+		constexpr udx VOICES = software_mixer::MAXIMUM_VOICES;
+		std::minstd_rand engine { SEED };
+		std::uniform_int_distribution<i32> noise { -12000, 12000 };
+		std::uniform_real_distribution<r32> pan { -1.0f, 1.0f };
+		std::vector<i16> samples(VOICES * MIXER_FRAMES * CHANNELS);
+		for (auto&& sample : samples) {
+			sample = as<i16>(noise(engine));
+		}
+		std::vector<glm::vec2> gains {};
+		for (udx it = 0; it < VOICES; ++it) {
+			const r32 value = pan(engine);
+			gains.emplace_back(
+				0.5f * glm::min(1.0f, 1.0f - value),
+				0.5f * glm::min(1.0f, 1.0f + value)
+			);
+		}
+		std::vector<r32> accumulator(MIXER_FRAMES * CHANNELS);
+		std::vector<i16> output(MIXER_FRAMES * CHANNELS);
+		s.run("software_mixer::accumulate + resolve (64 voices)", [&] {
+			std::fill(accumulator.begin(), accumulator.end(), 0.0f);
+			for (udx it = 0; it < VOICES; ++it) {
+				software_mixer::accumulate(
+					samples.data() + it * MIXER_FRAMES * CHANNELS,
+					gains[it].x, gains[it].y,
+					accumulator.data(),
+					MIXER_FRAMES
+				);
+			}
+			software_mixer::resolve(accumulator.data(), output.data(), MIXER_FRAMES);
+			return as<udx>(output[MIXER_FRAMES] & 0xFF);
+		});
+	}
+
+	// One display frame per tick, with a single injected stall halfway through.
+	// Returns how many ticks ran, or zero if the catch-up rules were broken.
+	udx simulate_stall_() {
+		tick_clock timer {};
+		i64 now = 0;
+		udx total = 0;
+		udx drops = 0;
+		for (udx frame = 0; frame < CLOCK_FRAMES; ++frame) {
+			if (frame == STALL_FRAME) {
+				now += STALL_LENGTH;
+			}
+			const udx ticks = timer.advance(now);
+			// a stall is caught up in one capped batch, then the rest is dropped
+			const udx expected = frame == STALL_FRAME ?
+				tick_clock::MAXIMUM_TICKS :
+				1;
+			if (ticks != expected) {
+				return 0;
+			}
+			if (timer.drop(now) > 0) {
+				++drops;
+			}
+			const r32 ratio = timer.ratio(now, MAXIMUM_RATIO);
+			if (ratio < 0.0f or ratio > MAXIMUM_RATIO) {
+				return 0;
+			}
+			total += ticks;
+			now += konst::NANOSECONDS_PER_TICK();
+		}
+		return drops == 1 ? total : 0;
+	}
+
+	bool bench_clock_(suite& s) {
+		if (simulate_stall_() == 0) {
+			spdlog::error("Tick clock didn't recover from an injected stall!");
+			return false;
+		}
+		s.run("tick_clock (injected 500 ms stall)", [] {
+			return simulate_stall_();
+		});
+		return true;
+	}
+
+	void bench_save_(suite& s) {
+		save_file save {};
+		save.field = "bench-harbor";
+		save.ticks = 123456789;
+		save.cursor = 3;
+		save.maximum = 20;
+		save.barrier = 12;
+		save.position = { 512.0f, 384.0f };
+		for (udx it = 0; it < SAVE_ITEMS; ++it) {
+			auto& slot = save.items.emplace_back();
+			slot.type = as<i32>(it + 1);
+			slot.count = as<i32>(it * 3);
+			slot.limit = item_slot::MAXIMUM_LIMIT;
+			slot.weapon = it % 5 == 0;
+		}
+		for (udx it = 0; it < SAVE_FLAGS; ++it) {
+			save.flags.push_back(0x9E3779B97F4A7C15ULL * (it + 1));
+		}
+		s.run("save_file::dump + load", [&save] {
+			save_file result {};
+			result.load(save.dump());
+			return result.flags.size();
+		});
+		s.run("save_file::write + read", [&save] {
+			nlohmann::json data {};
+			save.write(data);
+			save_file result {};
+			result.read(data);
+			return result.flags.size();
+		});
+	}
+}
+
+void* operator new(std::size_t size) {
+	allocations_.fetch_add(1, std::memory_order_relaxed);
+	if (void* ptr = std::malloc(size > 0 ? size : 1)) {
+		return ptr;
+	}
+	throw std::bad_alloc {};
+}
+
+void operator delete(void* ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+	std::free(ptr);
+}
+
+// Times the engine's hot paths against maps, fonts, and songs generated on the
+// spot, so nothing needs a window, a GPU, or a data directory. Results are
+// written as JSON, either to the given file or to standard output.
+int main(int argc, char** argv) {
+	spdlog::set_default_logger(spdlog::stderr_color_mt(SCRATCH_DIRECTORY));
+
+	std::string output {};
+	std::string filter {};
+	for (int it = 1; it < argc; ++it) {
+		const std::string argument { argv[it] };
+		if (argument == FILTER_ARGUMENT and it + 1 < argc) {
+			filter = argv[++it];
+		} else if (output.empty()) {
+			output = argument;
+		} else {
+			spdlog::error("Usage: {} [output file] [{} <name>]", argv[0], FILTER_ARGUMENT);
+			return EXIT_FAILURE;
+		}
+	}
+
+	std::error_code code;
+	const auto scratch = std::filesystem::temp_directory_path(code) / SCRATCH_DIRECTORY;
+	if (!code) {
+		std::filesystem::create_directories(scratch, code);
+	}
+	if (code) {
+		spdlog::error("Couldn't create scratch directory: {}!", scratch.string());
+		return EXIT_FAILURE;
+	}
+
+	suite s { filter };
+	bench_collision_(s);
+	bench_display_list_(s);
+	bench_animation_(s);
+	bench_text_(s, scratch);
+	bench_environment_(s);
+	bench_routines_(s);
+	bench_thinkers_(s);
+	bench_cutscene_(s);
+	const bool collected = bench_collection_(s);
+	bench_music_(s);
+	bench_mixer_(s);
+	bench_save_(s);
+	const bool recovered = bench_clock_(s);
+	std::filesystem::remove_all(scratch, code);
+
+	const std::string report = s.report().dump(1, '\t');
+	if (output.empty()) {
+		std::cout << report << std::endl;
+	} else {
+		std::ofstream ofs { output, std::ios::binary | std::ios::trunc };
+		if (!ofs.write(report.data(), as<std::streamsize>(report.size()))) {
+			spdlog::error("Couldn't write benchmark results: {}!", output);
+			return EXIT_FAILURE;
+		}
+	}
+	return recovered and collected ? EXIT_SUCCESS : EXIT_FAILURE;
+}
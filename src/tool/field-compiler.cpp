@@ -0,0 +1,151 @@
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <spdlog/spdlog.h>
+#include <tmxlite/Map.hpp>
+#include <apostellein/cast.hpp>
+
+#include "./tool-common.hpp"
+#include "../util/field-file.hpp"
+#include "../util/asset-manifest.hpp"
+#include "../util/bank-file.hpp"
+#include "../util/id-table.hpp"
+
+namespace {
+	constexpr char FIELD_ROUTE[] = "field";
+	constexpr char KEY_ROUTE[] = "key";
+	constexpr char EVENT_ROUTE[] = "event";
+	constexpr char NOISE_ROUTE[] = "noise";
+	constexpr char TMX_EXTENSION[] = ".tmx";
+	constexpr char FLD_EXTENSION[] = ".fld";
+	constexpr char ATTR_EXTENSION[] = ".attr";
+	constexpr char LUA_EXTENSION[] = ".lua";
+	constexpr char MFT_EXTENSION[] = ".mft";
+	constexpr char BNK_EXTENSION[] = ".bnk";
+	constexpr char WAV_EXTENSION[] = ".wav";
+
+	std::vector<std::string> buffer_scripts_(const std::filesystem::path& root, const std::string& name) {
+		// every language has its own copy of a field's script
+		std::vector<std::string> result {};
+		std::error_code code;
+		if (!std::filesystem::is_directory(root / EVENT_ROUTE, code)) {
+			return result;
+		}
+		for (auto&& entry : std::filesystem::directory_iterator(root / EVENT_ROUTE)) {
+			const auto path = entry.path() / (name + LUA_EXTENSION);
+			if (entry.is_directory(code) and std::filesystem::exists(path, code)) {
+				const std::vector<byte> bytes = tool::buffer_bytes(path);
+				result.emplace_back(bytes.begin(), bytes.end());
+			}
+		}
+		return result;
+	}
+
+	std::vector<u32> buffer_key_(const std::filesystem::path& root, const std::string& tileset) {
+		const std::vector<byte> bytes = tool::buffer_bytes(root / KEY_ROUTE / (tileset + ATTR_EXTENSION));
+		std::vector<u32> result(bytes.size() / sizeof(u32));
+		std::memcpy(result.data(), bytes.data(), result.size() * sizeof(u32));
+		return result;
+	}
+
+	bank_file bake_(const std::filesystem::path& root, const asset_manifest& manifest) {
+		// engine noises go into every bank, so a transfer never reads loose files
+		std::vector<std::string> names = manifest.noises();
+		for (auto&& id : sfx::Global) {
+			names.emplace_back(id.data());
+		}
+		std::sort(names.begin(), names.end());
+		names.erase(std::unique(names.begin(), names.end()), names.end());
+		bank_file result {};
+		for (auto&& name : names) {
+			const auto path = root / NOISE_ROUTE / (name + WAV_EXTENSION);
+			if (!result.append(name, tool::buffer_bytes(path))) {
+				spdlog::warn("Couldn't bake noise, it loads at transfer instead: {}", path.string());
+			}
+		}
+		return result;
+	}
+
+	bool compile_(const std::filesystem::path& root, const std::filesystem::path& path, field_file& result) {
+		tmx::Map desc {};
+		if (!desc.load(path.string())) {
+			spdlog::error("Couldn't load field description: {}!", path.string());
+			return false;
+		}
+		return result.compile(desc, buffer_key_(root, field_file::tileset(desc)));
+	}
+}
+
+// Bakes every field description under <data>/field into a compiled field, an
+// asset manifest and a noise bank that sit right next to it. Passing --bench
+// also compares transfer-time loading.
+int main(int argc, char** argv) {
+	tool::options opts {};
+	if (!tool::parse(argc, argv, opts)) {
+		return EXIT_FAILURE;
+	}
+	const auto& root = opts.root;
+	std::error_code code;
+	if (!std::filesystem::is_directory(root / FIELD_ROUTE, code)) {
+		spdlog::error("\"{}\" doesn't have a field directory!", root.string());
+		return EXIT_FAILURE;
+	}
+
+	const udx failures = tool::walk(root / FIELD_ROUTE, TMX_EXTENSION, [&](const std::filesystem::path& path) {
+		field_file field {};
+		if (!compile_(root, path, field)) {
+			spdlog::error("Couldn't compile field: {}!", path.string());
+			return false;
+		}
+		const std::vector<byte> buffer = field.dump();
+		auto output = path;
+		output.replace_extension(FLD_EXTENSION);
+		if (!tool::emit<field_file>(output, buffer, "compiled field")) {
+			return false;
+		}
+		spdlog::info("Compiled {} ({} bytes).", output.filename().string(), buffer.size());
+
+		// Assets the field loads up front, before its first tick
+		asset_manifest manifest {};
+		manifest.compile(field, buffer_scripts_(root, path.stem().string()));
+		auto listing = path;
+		listing.replace_extension(MFT_EXTENSION);
+		if (!tool::emit<asset_manifest>(listing, manifest.dump(), "asset manifest")) {
+			return false;
+		}
+		spdlog::info(
+			"    {} aktors, {} noises, {} materials.",
+			manifest.aktors().size(),
+			manifest.noises().size(),
+			manifest.materials().size()
+		);
+
+		// Every noise the field can play, packed so a transfer reads it in one go
+		const bank_file bank = bake_(root, manifest);
+		const std::vector<byte> packed = bank.dump();
+		auto archive = path;
+		archive.replace_extension(BNK_EXTENSION);
+		if (!tool::emit<bank_file>(archive, packed, "noise bank")) {
+			return false;
+		}
+		spdlog::info("    {} noises baked ({} bytes).", bank.entries().size(), packed.size());
+
+		if (opts.bench) {
+			const r64 description = tool::measure(opts.iterations, [&root, &path] {
+				field_file temp {};
+				compile_(root, path, temp);
+			});
+			const r64 compiled = tool::measure(opts.iterations, [&output] {
+				field_file temp {};
+				temp.load(tool::buffer_bytes(output));
+			});
+			spdlog::info(
+				"    description: {:.3f} ms, compiled: {:.3f} ms, speedup: {:.1f}x",
+				description, compiled,
+				compiled > 0.0 ? description / compiled : 0.0
+			);
+		}
+		return true;
+	});
+	return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,79 @@
+#include <cstdlib>
+#include <iterator>
+#include <fstream>
+#include <filesystem>
+#include <spdlog/spdlog.h>
+#include <lua.hpp>
+
+#include "../util/lua-bytecode.hpp"
+
+namespace {
+	constexpr char EVENT_ROUTE[] = "event";
+	constexpr char LUA_EXTENSION[] = ".lua";
+	constexpr char LUAC_EXTENSION[] = ".luac";
+
+	std::string buffer_string_(const std::filesystem::path& path) {
+		std::ifstream ifs { path, std::ios::binary };
+		if (!ifs.is_open()) {
+			return {};
+		}
+		return std::string {
+			std::istreambuf_iterator<char>{ ifs },
+			std::istreambuf_iterator<char>{}
+		};
+	}
+}
+
+// Compiles every script under <data>/event into the same layout the game
+// uses for its bytecode cache, so pointing <output> at the personal cache
+// directory (or shipping it there) skips parsing on first launch.
+int main(int argc, char** argv) {
+	if (argc < 3) {
+		spdlog::error("Usage: {} <data directory> <output directory>", argv[0]);
+		return EXIT_FAILURE;
+	}
+	const std::filesystem::path input = std::filesystem::path{ argv[1] } / EVENT_ROUTE;
+	const std::filesystem::path output = std::filesystem::path{ argv[2] } / EVENT_ROUTE;
+
+	std::error_code code;
+	if (!std::filesystem::is_directory(input, code)) {
+		spdlog::error("\"{}\" isn't a valid directory!", input.string());
+		return EXIT_FAILURE;
+	}
+
+	auto state = luaL_newstate();
+	if (!state) {
+		spdlog::error("Couldn't create lua state!");
+		return EXIT_FAILURE;
+	}
+	udx failures = 0;
+	for (auto&& entry : std::filesystem::recursive_directory_iterator(input)) {
+		const auto& path = entry.path();
+		if (!entry.is_regular_file(code) or path.extension() != LUA_EXTENSION) {
+			continue;
+		}
+		const std::string source = buffer_string_(path);
+		const std::string name = path.stem().string();
+		if (luaL_loadbufferx(state, source.data(), source.size(), name.c_str(), "t") != LUA_OK) {
+			spdlog::error("{}: {}", path.string(), lua_tostring(state, -1));
+			lua_pop(state, 1);
+			++failures;
+			continue;
+		}
+		const std::vector<byte> buffer = lua_bytecode::dump(state, lua_bytecode::hash(source));
+		lua_pop(state, 1);
+
+		auto target = output / std::filesystem::relative(path, input);
+		target.replace_extension(LUAC_EXTENSION);
+		std::filesystem::create_directories(target.parent_path(), code);
+		std::ofstream ofs { target, std::ios::binary | std::ios::trunc };
+		if (buffer.empty() or !ofs.write(reinterpret_cast<const char*>(buffer.data()), buffer.size())) {
+			spdlog::error("Couldn't write bytecode: {}!", target.string());
+			++failures;
+			continue;
+		}
+		spdlog::info("Compiled {} ({} -> {} bytes).", target.string(), source.size(), buffer.size());
+	}
+	lua_close(state);
+	return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
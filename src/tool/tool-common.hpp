@@ -0,0 +1,99 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <spdlog/spdlog.h>
+#include <apostellein/cast.hpp>
+
+// Shared by the offline compilers, which all bake a directory of descriptions
+// into binary files that sit right next to them.
+namespace tool {
+	constexpr char BENCH_ARGUMENT[] = "--bench";
+	constexpr udx DEFAULT_ITERATIONS = 100;
+
+	struct options {
+		std::filesystem::path root {};
+		bool bench {};
+		udx iterations { DEFAULT_ITERATIONS };
+	};
+
+	// <data directory> [--bench [iterations]]
+	inline bool parse(int argc, char** argv, options& result) {
+		if (argc < 2) {
+			spdlog::error("Usage: {} <data directory> [{} [iterations]]", argv[0], BENCH_ARGUMENT);
+			return false;
+		}
+		result.root = argv[1];
+		result.bench = argc > 2 and std::string{ argv[2] } == BENCH_ARGUMENT;
+		if (argc > 3) {
+			result.iterations = as<udx>(std::max(std::atoi(argv[3]), 1));
+		}
+		return true;
+	}
+
+	inline std::vector<byte> buffer_bytes(const std::filesystem::path& path) {
+		std::ifstream ifs { path, std::ios::binary | std::ios::ate };
+		if (!ifs.is_open()) {
+			return {};
+		}
+		std::vector<byte> buffer(static_cast<udx>(ifs.tellg()));
+		ifs.seekg(0, std::ios::beg);
+		ifs.read(reinterpret_cast<char*>(buffer.data()), as<std::streamsize>(buffer.size()));
+		return buffer;
+	}
+
+	inline bool write_bytes(const std::filesystem::path& path, const std::vector<byte>& buffer) {
+		std::ofstream ofs { path, std::ios::binary | std::ios::trunc };
+		return static_cast<bool>(
+			ofs.write(reinterpret_cast<const char*>(buffer.data()), as<std::streamsize>(buffer.size()))
+		);
+	}
+
+	// Writes a baked file, then reads it back so format drift shows up here
+	// instead of in the game
+	template<typename File>
+	bool emit(const std::filesystem::path& path, const std::vector<byte>& buffer, const char* kind) {
+		if (!tool::write_bytes(path, buffer)) {
+			spdlog::error("Couldn't write {}: {}!", kind, path.string());
+			return false;
+		}
+		File check {};
+		if (!check.load(tool::buffer_bytes(path)) or check.dump() != buffer) {
+			spdlog::error("{} doesn't round trip: {}!", kind, path.string());
+			return false;
+		}
+		return true;
+	}
+
+	// Calls func on every file in directory with the given extension, and
+	// returns how many of those calls failed
+	template<typename F>
+	udx walk(const std::filesystem::path& directory, const char* extension, F&& func) {
+		udx failures = 0;
+		std::error_code code;
+		for (auto&& entry : std::filesystem::directory_iterator(directory, code)) {
+			const auto& path = entry.path();
+			if (entry.is_regular_file(code) and path.extension() == extension) {
+				if (!func(path)) {
+					++failures;
+				}
+			}
+		}
+		return failures;
+	}
+
+	template<typename F>
+	r64 measure(udx iterations, F&& func) {
+		const auto start = std::chrono::steady_clock::now();
+		for (udx it = 0; it < iterations; ++it) {
+			func();
+		}
+		const std::chrono::duration<r64, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+		return elapsed.count() / as<r64>(iterations);
+	}
+}
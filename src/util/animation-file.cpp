@@ -0,0 +1,191 @@
+#include <cstring>
+#include <spdlog/spdlog.h>
+#include <glm/common.hpp>
+#include <glm/vec4.hpp>
+#include <nlohmann/json.hpp>
+#include <entt/core/hashed_string.hpp>
+#include <apostellein/konst.hpp>
+#include <apostellein/cast.hpp>
+
+#include "./animation-file.hpp"
+#include "./byte-stream.hpp"
+
+namespace {
+	constexpr char MAGIC[4] = { 'A', 'P', 'A', 'N' };
+	constexpr char MATERIAL_ENTRY[] = "Material";
+	constexpr char ANIMATIONS_ENTRY[] = "Animations";
+	constexpr char STARTS_ENTRY[] = "starts";
+	constexpr char VKSIZE_ENTRY[] = "vksize";
+	constexpr char TDELAY_ENTRY[] = "tdelay";
+	constexpr char REPEAT_ENTRY[] = "repeat";
+	constexpr char REFLECT_ENTRY[] = "reflect";
+	constexpr char ACTION_ENTRY[] = "action";
+	constexpr char FRAMES_ENTRY[] = "frames";
+
+	glm::vec2 pair_to_vec2_(const nlohmann::json& data) {
+		if (
+			data.is_array() and
+			data.size() >= 2 and
+			data[0].is_number() and
+			data[1].is_number()
+		) {
+			return {
+				data[0].get<r32>(),
+				data[1].get<r32>()
+			};
+		}
+		return {};
+	}
+}
+
+bool animation_file::compile(const nlohmann::json& data) {
+	this->clear();
+	if (data.contains(MATERIAL_ENTRY) and data[MATERIAL_ENTRY].is_string()) {
+		material_ = data[MATERIAL_ENTRY].get<std::string>();
+		material_id_ = entt::hashed_string{ material_.c_str() }.value();
+	}
+	if (!data.contains(ANIMATIONS_ENTRY)) {
+		spdlog::error("Animation doesn't have any sequences!");
+		return false;
+	}
+
+	for (auto&& anim : data[ANIMATIONS_ENTRY]) {
+		auto& recent = headers_.emplace_back();
+		glm::vec2 starts {};
+		if (anim.contains(STARTS_ENTRY)) {
+			starts = pair_to_vec2_(anim[STARTS_ENTRY]);
+		}
+		if (anim.contains(VKSIZE_ENTRY)) {
+			recent.dimensions = glm::abs(pair_to_vec2_(anim[VKSIZE_ENTRY]));
+		}
+		if (
+			anim.contains(TDELAY_ENTRY) and
+			anim[TDELAY_ENTRY].is_number_float()
+		) {
+			recent.delay = konst::SECONDS_TO_NANOSECONDS(
+				glm::abs(anim[TDELAY_ENTRY].get<r64>())
+			);
+		}
+		if (
+			!anim.contains(REPEAT_ENTRY) or
+			!anim[REPEAT_ENTRY].is_boolean() or
+			anim[REPEAT_ENTRY].get<bool>()
+		) {
+			recent.flags |= REPEATING;
+		}
+		if (
+			anim.contains(REFLECT_ENTRY) and
+			anim[REFLECT_ENTRY].is_boolean() and
+			anim[REFLECT_ENTRY].get<bool>()
+		) {
+			recent.flags |= REFLECTING;
+		}
+		if (
+			anim.contains(FRAMES_ENTRY) and
+			anim[FRAMES_ENTRY].is_array() and
+			anim[FRAMES_ENTRY].size() > 0 and
+			anim[FRAMES_ENTRY][0].is_array()
+		) {
+			recent.count = as<u32>(anim[FRAMES_ENTRY][0].size());
+		}
+		if (recent.count == 0) {
+			spdlog::error("Animation has a sequence without frames!");
+			this->clear();
+			return false;
+		}
+
+		if (
+			anim.contains(ACTION_ENTRY) and
+			anim[ACTION_ENTRY].is_array()
+		) {
+			for (auto&& action : anim[ACTION_ENTRY]) {
+				action_points_.push_back(pair_to_vec2_(action));
+				++recent.actions;
+			}
+		}
+
+		for (auto&& frames : anim[FRAMES_ENTRY]) {
+			for (auto&& rule : frames) {
+				glm::vec4 points {};
+				if (rule.is_array()) {
+					const glm::length_t total = glm::min(
+						points.length(),
+						as<glm::length_t>(rule.size())
+					);
+					for (glm::length_t idx = 0; idx < total; ++idx) {
+						if (rule[as<udx>(idx)].is_number()) {
+							points[idx] = rule[as<udx>(idx)].get<r32>();
+						}
+					}
+				}
+				frames_.emplace_back(
+					starts + (glm::vec2{ points[0], points[1] } * recent.dimensions),
+					glm::vec2{ points[2], points[3] }
+				);
+				++recent.frames;
+			}
+		}
+	}
+	return this->valid();
+}
+
+bool animation_file::load(const std::vector<byte>& buffer) {
+	this->clear();
+	byte_reader stream { buffer };
+
+	char magic[sizeof(MAGIC)] {};
+	u32 version = 0;
+	if (
+		!stream.get(magic) or
+		std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 or
+		!stream.get(version) or
+		version != VERSION
+	) {
+		spdlog::error("Animation file has wrong identifier or version!");
+		return false;
+	}
+
+	bool result =
+		stream.get(material_) and
+		stream.get(material_id_) and
+		stream.get(headers_) and
+		stream.get(frames_) and
+		stream.get(action_points_);
+	if (result) {
+		// every sequence has to fit inside the shared arrays
+		udx frames = 0;
+		udx actions = 0;
+		for (auto&& header : headers_) {
+			result = result and header.count > 0 and header.count <= header.frames;
+			frames += header.frames;
+			actions += header.actions;
+		}
+		result = result and frames == frames_.size() and actions == action_points_.size();
+	}
+	if (!result or stream.cursor != buffer.size()) {
+		spdlog::error("Animation file is truncated or malformed!");
+		this->clear();
+		return false;
+	}
+	return true;
+}
+
+std::vector<byte> animation_file::dump() const {
+	byte_writer stream {};
+	stream.put(MAGIC);
+	stream.put(VERSION);
+	stream.put(material_);
+	stream.put(material_id_);
+	stream.put(headers_);
+	stream.put(frames_);
+	stream.put(action_points_);
+	return std::move(stream.buffer);
+}
+
+void animation_file::clear() {
+	material_.clear();
+	material_id_ = 0;
+	headers_.clear();
+	frames_.clear();
+	action_points_.clear();
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <glm/vec2.hpp>
+#include <nlohmann/json_fwd.hpp>
+#include <apostellein/struct.hpp>
+
+#include "./memory-tracker.hpp"
+
+struct animation_frame {
+	constexpr animation_frame() noexcept = default;
+	constexpr animation_frame(
+		const glm::vec2& _position,
+		const glm::vec2& _origin
+	) noexcept : position{ _position }, origin{ _origin } {}
+
+	glm::vec2 position {};
+	glm::vec2 origin {};
+};
+
+// Kept free of padding so compiled files are byte-for-byte reproducible
+struct animation_header {
+	glm::vec2 dimensions {};
+	i64 delay {};
+	u32 count {};
+	u32 frames {};
+	u32 actions {};
+	u32 flags {};
+};
+
+struct animation_file : public not_copyable {
+public:
+	static constexpr u32 VERSION = 2;
+	static constexpr u32 REPEATING = 1 << 0;
+	static constexpr u32 REFLECTING = 1 << 1;
+	using header_vector = tracked_vector<animation_header, memory_tag::animations>;
+	using frame_vector = tracked_vector<animation_frame, memory_tag::animations>;
+	using point_vector = tracked_vector<glm::vec2, memory_tag::animations>;
+	bool compile(const nlohmann::json& data);
+	bool load(const std::vector<byte>& buffer);
+	std::vector<byte> dump() const;
+	void clear();
+	bool valid() const { return !headers_.empty(); }
+	const std::string& material() const { return material_; }
+	// hashed at compile time, so loading never has to hash the name again
+	u32 material_id() const { return material_id_; }
+	const header_vector& headers() const { return headers_; }
+	// frames and action points are handed over whole, sequences only point into them
+	frame_vector&& release_frames() { return std::move(frames_); }
+	point_vector&& release_action_points() { return std::move(action_points_); }
+private:
+	std::string material_ {};
+	u32 material_id_ {};
+	header_vector headers_ {};
+	frame_vector frames_ {};
+	point_vector action_points_ {};
+};
@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <spdlog/spdlog.h>
+
+#include "./asset-manifest.hpp"
+#include "./field-file.hpp"
+#include "./byte-stream.hpp"
+
+namespace {
+	constexpr char MAGIC[4] = { 'A', 'P', 'M', 'F' };
+	constexpr char SPAWN_CALL[] = "env.spawn(";
+	constexpr char SOUND_CALL[] = "sfx.sound(";
+	constexpr char MATERIAL_CALL[] = "sys.material(";
+	constexpr char SHOW_CALL[] = "hud.show(";
+
+	void append_(std::vector<std::string>& result, std::vector<std::string>&& values) {
+		result.insert(
+			result.end(),
+			std::make_move_iterator(values.begin()),
+			std::make_move_iterator(values.end())
+		);
+	}
+
+	void unique_(std::vector<std::string>& values) {
+		std::sort(values.begin(), values.end());
+		values.erase(std::unique(values.begin(), values.end()), values.end());
+	}
+
+	bool get_(byte_reader& stream, std::vector<std::string>& values) {
+		u32 length = 0;
+		if (!stream.count(length)) {
+			return false;
+		}
+		values.resize(length);
+		for (auto&& value : values) {
+			if (!stream.get(value)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void put_(byte_writer& stream, const std::vector<std::string>& values) {
+		stream.put(as<u32>(values.size()));
+		for (auto&& value : values) {
+			stream.put(value);
+		}
+	}
+}
+
+std::vector<std::string> asset_manifest::literals(const std::string& source, std::string_view call) {
+	// only string literals count, anything computed at runtime stays lazy
+	std::vector<std::string> result {};
+	auto cursor = source.find(call);
+	while (cursor != std::string::npos) {
+		cursor += call.size();
+		if (cursor < source.size() and (source[cursor] == '"' or source[cursor] == '\'')) {
+			const auto last = source.find(source[cursor], cursor + 1);
+			if (last != std::string::npos) {
+				result.push_back(source.substr(cursor + 1, last - cursor - 1));
+				cursor = last;
+			}
+		}
+		cursor = source.find(call, cursor);
+	}
+	return result;
+}
+
+udx asset_manifest::unresolved(const std::string& source, std::string_view call) {
+	// computed names and aliased functions can't be followed, so say where they are
+	const std::string_view callee = call.substr(0, call.size() - 1);
+	udx result = 0;
+	auto cursor = source.find(callee);
+	while (cursor != std::string::npos) {
+		const auto next = cursor + callee.size();
+		const bool calling = next < source.size() and source[next] == '(';
+		const bool literal = calling and next + 1 < source.size() and (
+			source[next + 1] == '"' or
+			source[next + 1] == '\''
+		);
+		if (!literal) {
+			const auto line = std::count(source.begin(), source.begin() + as<std::ptrdiff_t>(cursor), '\n') + 1;
+			if (calling) {
+				spdlog::warn("Line {}: {}) has a computed argument, it stays lazy.", line, call);
+			} else {
+				spdlog::warn("Line {}: {} is aliased, its calls stay lazy.", line, callee);
+			}
+			++result;
+		}
+		cursor = source.find(callee, next);
+	}
+	return result;
+}
+
+void asset_manifest::compile(const field_file& field, const std::vector<std::string>& sources) {
+	this->clear();
+	for (auto&& aktor : field.aktors()) {
+		aktors_.push_back(aktor.name);
+	}
+	if (!field.texture().empty()) {
+		materials_.push_back(field.texture());
+	}
+	for (auto&& pllx : field.parallaxes()) {
+		materials_.push_back(pllx.image);
+	}
+	for (auto&& source : sources) {
+		asset_manifest::unresolved(source, SOUND_CALL);
+		append_(aktors_, asset_manifest::literals(source, SPAWN_CALL));
+		append_(noises_, asset_manifest::literals(source, SOUND_CALL));
+		append_(materials_, asset_manifest::literals(source, MATERIAL_CALL));
+		append_(materials_, asset_manifest::literals(source, SHOW_CALL));
+	}
+	unique_(aktors_);
+	unique_(noises_);
+	unique_(materials_);
+}
+
+bool asset_manifest::load(const std::vector<byte>& buffer) {
+	this->clear();
+	byte_reader stream { buffer };
+
+	char magic[sizeof(MAGIC)] {};
+	u32 version = 0;
+	if (
+		!stream.get(magic) or
+		std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 or
+		!stream.get(version) or
+		version != VERSION
+	) {
+		spdlog::error("Asset manifest has wrong identifier or version!");
+		return false;
+	}
+
+	const bool result =
+		get_(stream, aktors_) and
+		get_(stream, noises_) and
+		get_(stream, materials_);
+	if (!result or stream.cursor != buffer.size()) {
+		spdlog::error("Asset manifest is truncated or malformed!");
+		this->clear();
+		return false;
+	}
+	return true;
+}
+
+std::vector<byte> asset_manifest::dump() const {
+	byte_writer stream {};
+	stream.put(MAGIC);
+	stream.put(VERSION);
+	put_(stream, aktors_);
+	put_(stream, noises_);
+	put_(stream, materials_);
+	return std::move(stream.buffer);
+}
+
+void asset_manifest::clear() {
+	aktors_.clear();
+	noises_.clear();
+	materials_.clear();
+}
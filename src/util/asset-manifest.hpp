@@ -0,0 +1,29 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <apostellein/def.hpp>
+
+struct field_file;
+
+// Everything a field might load during or after its transfer: aktors placed
+// in the description or spawned by its script, the field's own textures, and
+// the sounds and images the script names directly.
+struct asset_manifest {
+public:
+	static constexpr u32 VERSION = 1;
+	static std::vector<std::string> literals(const std::string& source, std::string_view call);
+	static udx unresolved(const std::string& source, std::string_view call);
+	void compile(const field_file& field, const std::vector<std::string>& sources);
+	bool load(const std::vector<byte>& buffer);
+	std::vector<byte> dump() const;
+	void clear();
+	const std::vector<std::string>& aktors() const { return aktors_; }
+	const std::vector<std::string>& noises() const { return noises_; }
+	const std::vector<std::string>& materials() const { return materials_; }
+private:
+	std::vector<std::string> aktors_ {};
+	std::vector<std::string> noises_ {};
+	std::vector<std::string> materials_ {};
+};
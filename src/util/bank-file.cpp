@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <spdlog/spdlog.h>
+#include <entt/core/hashed_string.hpp>
+#include <apostellein/cast.hpp>
+
+#include "./bank-file.hpp"
+#include "./byte-stream.hpp"
+
+namespace {
+	constexpr char MAGIC[4] = { 'A', 'P', 'N', 'B' };
+	constexpr char RIFF_CHUNK[4] = { 'R', 'I', 'F', 'F' };
+	constexpr char WAVE_FORMAT[4] = { 'W', 'A', 'V', 'E' };
+	constexpr char FORMAT_CHUNK[4] = { 'f', 'm', 't', ' ' };
+	constexpr char DATA_CHUNK[4] = { 'd', 'a', 't', 'a' };
+	constexpr udx RIFF_HEADER = 12;
+	constexpr udx CHUNK_HEADER = 8;
+	constexpr udx FORMAT_LENGTH = 16;
+	constexpr u16 PCM_FORMAT = 1;
+
+	// wave files are little-endian no matter what the host is
+	u16 little_u16_(const byte* data) {
+		return as<u16>(data[0] | (data[1] << 8));
+	}
+
+	u32 little_u32_(const byte* data) {
+		return
+			as<u32>(data[0]) |
+			(as<u32>(data[1]) << 8) |
+			(as<u32>(data[2]) << 16) |
+			(as<u32>(data[3]) << 24);
+	}
+}
+
+bool bank_file::append(const std::string& name, const std::vector<byte>& wav) {
+	// only plain pcm is baked, anything compressed is left to SDL at runtime
+	if (
+		wav.size() < RIFF_HEADER or
+		std::memcmp(wav.data(), RIFF_CHUNK, sizeof(RIFF_CHUNK)) != 0 or
+		std::memcmp(wav.data() + 8, WAVE_FORMAT, sizeof(WAVE_FORMAT)) != 0
+	) {
+		return false;
+	}
+	bank_entry entry {};
+	const byte* data = nullptr;
+	udx cursor = RIFF_HEADER;
+	while (cursor + CHUNK_HEADER <= wav.size()) {
+		const byte* chunk = wav.data() + cursor;
+		const udx length = little_u32_(chunk + 4);
+		const byte* body = chunk + CHUNK_HEADER;
+		if (cursor + CHUNK_HEADER + length > wav.size()) {
+			return false;
+		}
+		if (std::memcmp(chunk, FORMAT_CHUNK, sizeof(FORMAT_CHUNK)) == 0) {
+			if (length < FORMAT_LENGTH or little_u16_(body) != PCM_FORMAT) {
+				return false;
+			}
+			entry.channels = little_u16_(body + 2);
+			entry.frequency = as<i32>(little_u32_(body + 4));
+			entry.bits = little_u16_(body + 14);
+		} else if (std::memcmp(chunk, DATA_CHUNK, sizeof(DATA_CHUNK)) == 0) {
+			data = body;
+			entry.length = as<u32>(length);
+		}
+		// chunks are padded out to an even length
+		cursor += CHUNK_HEADER + length + (length & 1);
+	}
+	if (
+		!data or
+		(entry.bits != 8 and entry.bits != 16) or
+		(entry.channels != 1 and entry.channels != 2)
+	) {
+		return false;
+	}
+	if (storage_.empty()) {
+		blob_ = 0;
+	}
+	entry.id = entt::hashed_string{ name.c_str() }.value();
+	entry.name = name;
+	entry.offset = as<u32>(this->bytes());
+	storage_.insert(storage_.end(), data, data + entry.length);
+	entries_.push_back(std::move(entry));
+	return true;
+}
+
+bool bank_file::load(std::vector<byte>&& buffer) {
+	this->clear();
+	byte_reader stream { buffer };
+
+	char magic[sizeof(MAGIC)] {};
+	u32 version = 0;
+	if (
+		!stream.get(magic) or
+		std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 or
+		!stream.get(version) or
+		version != VERSION
+	) {
+		spdlog::error("Noise bank has wrong identifier or version!");
+		return false;
+	}
+
+	u32 count = 0;
+	bool result = stream.count(count);
+	if (result) {
+		entries_.resize(count);
+		for (auto&& entry : entries_) {
+			result =
+				stream.get(entry.id) and
+				stream.get(entry.name) and
+				stream.get(entry.offset) and
+				stream.get(entry.length) and
+				stream.get(entry.bits) and
+				stream.get(entry.channels) and
+				stream.get(entry.frequency);
+			if (!result) {
+				break;
+			}
+		}
+	}
+	u32 length = 0;
+	if (!result or !stream.get(length) or stream.cursor + length != buffer.size()) {
+		spdlog::error("Noise bank is truncated or malformed!");
+		this->clear();
+		return false;
+	}
+	for (auto&& entry : entries_) {
+		if (as<udx>(entry.offset) + as<udx>(entry.length) > length) {
+			spdlog::error("Noise bank entry \"{}\" runs past its blob!", entry.name);
+			this->clear();
+			return false;
+		}
+	}
+	// the blob stays where it was read, so nothing gets copied
+	blob_ = stream.cursor;
+	storage_ = std::move(buffer);
+	return true;
+}
+
+std::vector<byte> bank_file::dump() const {
+	byte_writer stream {};
+	stream.put(MAGIC);
+	stream.put(VERSION);
+	stream.put(as<u32>(entries_.size()));
+	for (auto&& entry : entries_) {
+		stream.put(entry.id);
+		stream.put(entry.name);
+		stream.put(entry.offset);
+		stream.put(entry.length);
+		stream.put(entry.bits);
+		stream.put(entry.channels);
+		stream.put(entry.frequency);
+	}
+	stream.put(as<u32>(this->bytes()));
+	stream.buffer.insert(
+		stream.buffer.end(),
+		storage_.begin() + as<std::ptrdiff_t>(blob_),
+		storage_.end()
+	);
+	return std::move(stream.buffer);
+}
+
+void bank_file::clear() {
+	entries_.clear();
+	storage_.clear();
+	blob_ = 0;
+}
+
+bool bank_file::contains(u32 id) const {
+	return std::any_of(entries_.begin(), entries_.end(), [id](const bank_entry& entry) {
+		return entry.id == id;
+	});
+}
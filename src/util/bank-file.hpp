@@ -0,0 +1,36 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <apostellein/def.hpp>
+
+struct bank_entry {
+	u32 id {};
+	std::string name {};
+	u32 offset {};
+	u32 length {};
+	u16 bits {};
+	u16 channels {};
+	i32 frequency {};
+};
+
+// Every noise a field can play, baked offline: a header, a table of where each
+// noise sits, then one blob of PCM. Loading takes one read and nothing gets
+// decoded, since the blob is kept exactly as it was read.
+struct bank_file {
+public:
+	static constexpr u32 VERSION = 1;
+	bool append(const std::string& name, const std::vector<byte>& wav);
+	bool load(std::vector<byte>&& buffer);
+	std::vector<byte> dump() const;
+	void clear();
+	bool contains(u32 id) const;
+	bool empty() const { return entries_.empty(); }
+	udx bytes() const { return storage_.size() - blob_; }
+	const std::vector<bank_entry>& entries() const { return entries_; }
+	const byte* pcm(const bank_entry& entry) const { return storage_.data() + blob_ + entry.offset; }
+private:
+	std::vector<bank_entry> entries_ {};
+	std::vector<byte> storage_ {};
+	udx blob_ {};
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstring>
+#include <type_traits>
+#include <apostellein/cast.hpp>
+
+// Raw host-endian serialization shared by the compiled binary formats.
+struct byte_writer {
+public:
+	template<typename T>
+	void put(const T& value) {
+		static_assert(std::is_trivially_copyable<T>::value);
+		const auto ptr = reinterpret_cast<const byte*>(&value);
+		buffer.insert(buffer.end(), ptr, ptr + sizeof(T));
+	}
+	template<typename T, typename A>
+	void put(const std::vector<T, A>& values) {
+		static_assert(std::is_trivially_copyable<T>::value);
+		this->put(as<u32>(values.size()));
+		const auto ptr = reinterpret_cast<const byte*>(values.data());
+		buffer.insert(buffer.end(), ptr, ptr + values.size() * sizeof(T));
+	}
+	void put(const std::string& value) {
+		this->put(as<u32>(value.size()));
+		buffer.insert(buffer.end(), value.begin(), value.end());
+	}
+	std::vector<byte> buffer {};
+};
+
+struct byte_reader {
+public:
+	byte_reader(const std::vector<byte>& _buffer) noexcept :
+		buffer{ _buffer } {}
+	template<typename T>
+	bool get(T& value) {
+		static_assert(std::is_trivially_copyable<T>::value);
+		if (cursor + sizeof(T) > buffer.size()) {
+			return false;
+		}
+		std::memcpy(&value, buffer.data() + cursor, sizeof(T));
+		cursor += sizeof(T);
+		return true;
+	}
+	template<typename T, typename A>
+	bool get(std::vector<T, A>& values) {
+		static_assert(std::is_trivially_copyable<T>::value);
+		u32 length = 0;
+		if (!this->get(length) or cursor + length * sizeof(T) > buffer.size()) {
+			return false;
+		}
+		values.resize(length);
+		std::memcpy(values.data(), buffer.data() + cursor, length * sizeof(T));
+		cursor += length * sizeof(T);
+		return true;
+	}
+	bool get(std::string& value) {
+		u32 length = 0;
+		if (!this->get(length) or cursor + length > buffer.size()) {
+			return false;
+		}
+		value.assign(reinterpret_cast<const char*>(buffer.data() + cursor), length);
+		cursor += length;
+		return true;
+	}
+	bool count(u32& value) {
+		// every record takes at least one byte, so this rejects absurd counts
+		return this->get(value) and value <= buffer.size() - cursor;
+	}
+	const std::vector<byte>& buffer;
+	udx cursor {};
+};
@@ -12,6 +12,9 @@ namespace {
 	constexpr char LOGGING_ENTRY[] = "Logging";
 	constexpr char SANDY_BRIDGE_ENTRY[] = "SandyBridge";
 	constexpr char LANGUAGE_ENTRY[] = "Language";
+	constexpr char COLLECTION_BUDGET_ENTRY[] = "CollectionBudget";
+	constexpr char EXPORT_SAVES_ENTRY[] = "ExportSaves";
+	constexpr char INPUT_LATENCY_ENTRY[] = "InputLatency";
 	constexpr char VIDEO_ENTRY[] = "Video";
 	constexpr char VERTICAL_SYNC_ENTRY[] = "VerticalSync";
 	constexpr char ADAPTIVE_SYNC_ENTRY[] = "AdaptiveSync";
@@ -20,9 +23,11 @@ namespace {
 	constexpr char HIGH_DPI_ENTRY[] = "HighDPI";
 	constexpr char YIELD_ENTRY[] = "Yield";
 	constexpr char FRAME_RATE_ENTRY[] = "FrameRate";
+	constexpr char EXTRAPOLATION_ENTRY[] = "Extrapolation";
 	constexpr char AUDIO_ENTRY[] = "Audio";
 	constexpr char MUSIC_ENTRY[] = "Music";
 	constexpr char VOLUME_ENTRY[] = "Volume";
+	constexpr char BACKEND_ENTRY[] = "Backend";
 	constexpr char CHANNELS_ENTRY[] = "Channels";
 	constexpr char SAMPLING_RATE_ENTRY[] = "SamplingRate";
 	constexpr char BUFFERING_TIME_ENTRY[] = "BufferingTime";
@@ -30,6 +35,8 @@ namespace {
 	constexpr char DEBUGGER_BINDING_ENTRY[] = "KeyDebugger";
 
 	constexpr char DEFAULT_LANGUAGE[] = "english";
+	constexpr char DEFAULT_AUDIO_BACKEND[] = "openal";
+	constexpr i32 DEFAULT_COLLECTION_BUDGET = 500;
 	constexpr i32 DEFAULT_SCALING = 2;
 	constexpr i32 DEFAULT_FRAME_RATE = 60;
 	constexpr r32 DEFAULT_AUDIO_VOLUME = 1.0f;
@@ -57,6 +64,7 @@ void config_file::create() {
 
 	data_[VERSION_ENTRY] = konst::IDENTIFIER;
 
+	data_[AUDIO_ENTRY][BACKEND_ENTRY] = DEFAULT_AUDIO_BACKEND;
 	data_[AUDIO_ENTRY][VOLUME_ENTRY] = DEFAULT_AUDIO_VOLUME;
 
 	data_[INPUT_ENTRY][DEBUGGER_BINDING_ENTRY] =
@@ -101,6 +109,9 @@ void config_file::create() {
 	data_[SETUP_ENTRY][LOGGING_ENTRY] = konst::DEBUG;
 	data_[SETUP_ENTRY][LANGUAGE_ENTRY] = DEFAULT_LANGUAGE;
 	data_[SETUP_ENTRY][SANDY_BRIDGE_ENTRY] = false;
+	data_[SETUP_ENTRY][COLLECTION_BUDGET_ENTRY] = DEFAULT_COLLECTION_BUDGET;
+	data_[SETUP_ENTRY][EXPORT_SAVES_ENTRY] = false;
+	data_[SETUP_ENTRY][INPUT_LATENCY_ENTRY] = false;
 
 	data_[VIDEO_ENTRY][FRAME_RATE_ENTRY] = DEFAULT_FRAME_RATE;
 	data_[VIDEO_ENTRY][FULL_SCREEN_ENTRY] = false;
@@ -109,6 +120,7 @@ void config_file::create() {
 	data_[VIDEO_ENTRY][VERTICAL_SYNC_ENTRY] = true;
 	data_[VIDEO_ENTRY][ADAPTIVE_SYNC_ENTRY] = false;
 	data_[VIDEO_ENTRY][YIELD_ENTRY] = false;
+	data_[VIDEO_ENTRY][EXTRAPOLATION_ENTRY] = true;
 }
 
 std::string config_file::dump() {
@@ -192,6 +204,51 @@ void config_file::language(const std::string& value) {
 	data_[SETUP_ENTRY][LANGUAGE_ENTRY] = value;
 }
 
+i32 config_file::collection_budget() const {
+	if (
+		data_.contains(SETUP_ENTRY) and
+		data_[SETUP_ENTRY].contains(COLLECTION_BUDGET_ENTRY) and
+		data_[SETUP_ENTRY][COLLECTION_BUDGET_ENTRY].is_number_unsigned()
+	) {
+		return data_[SETUP_ENTRY][COLLECTION_BUDGET_ENTRY].get<i32>();
+	}
+	return DEFAULT_COLLECTION_BUDGET;
+}
+
+void config_file::collection_budget(i32 value) {
+	data_[SETUP_ENTRY][COLLECTION_BUDGET_ENTRY] = value;
+}
+
+bool config_file::export_saves() const {
+	if (
+		data_.contains(SETUP_ENTRY) and
+		data_[SETUP_ENTRY].contains(EXPORT_SAVES_ENTRY) and
+		data_[SETUP_ENTRY][EXPORT_SAVES_ENTRY].is_boolean()
+	) {
+		return data_[SETUP_ENTRY][EXPORT_SAVES_ENTRY].get<bool>();
+	}
+	return false;
+}
+
+void config_file::export_saves(bool value) {
+	data_[SETUP_ENTRY][EXPORT_SAVES_ENTRY] = value;
+}
+
+bool config_file::input_latency() const {
+	if (
+		data_.contains(SETUP_ENTRY) and
+		data_[SETUP_ENTRY].contains(INPUT_LATENCY_ENTRY) and
+		data_[SETUP_ENTRY][INPUT_LATENCY_ENTRY].is_boolean()
+	) {
+		return data_[SETUP_ENTRY][INPUT_LATENCY_ENTRY].get<bool>();
+	}
+	return false;
+}
+
+void config_file::input_latency(bool value) {
+	data_[SETUP_ENTRY][INPUT_LATENCY_ENTRY] = value;
+}
+
 bool config_file::vertical_sync() const {
 	if (
 		data_.contains(VIDEO_ENTRY) and
@@ -297,6 +354,21 @@ void config_file::frame_rate(i32 value) {
 	data_[VIDEO_ENTRY][FRAME_RATE_ENTRY] = value;
 }
 
+bool config_file::extrapolation() const {
+	if (
+		data_.contains(VIDEO_ENTRY) and
+		data_[VIDEO_ENTRY].contains(EXTRAPOLATION_ENTRY) and
+		data_[VIDEO_ENTRY][EXTRAPOLATION_ENTRY].is_boolean()
+	) {
+		return data_[VIDEO_ENTRY][EXTRAPOLATION_ENTRY].get<bool>();
+	}
+	return true;
+}
+
+void config_file::extrapolation(bool value) {
+	data_[VIDEO_ENTRY][EXTRAPOLATION_ENTRY] = value;
+}
+
 r32 config_file::audio_volume() const {
 	if (
 		data_.contains(AUDIO_ENTRY) and
@@ -312,6 +384,21 @@ void config_file::audio_volume(r32 value) {
 	data_[AUDIO_ENTRY][VOLUME_ENTRY] = value;
 }
 
+std::string config_file::audio_backend() const {
+	if (
+		data_.contains(AUDIO_ENTRY) and
+		data_[AUDIO_ENTRY].contains(BACKEND_ENTRY) and
+		data_[AUDIO_ENTRY][BACKEND_ENTRY].is_string()
+	) {
+		return data_[AUDIO_ENTRY][BACKEND_ENTRY].get<std::string>();
+	}
+	return DEFAULT_AUDIO_BACKEND;
+}
+
+void config_file::audio_backend(const std::string& value) {
+	data_[AUDIO_ENTRY][BACKEND_ENTRY] = value;
+}
+
 r32 config_file::music_volume() const {
 	if (
 		data_.contains(MUSIC_ENTRY) and
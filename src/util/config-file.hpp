@@ -29,6 +29,12 @@ public:
 	void sandy_bridge(bool value);
 	std::string language() const;
 	void language(const std::string& value);
+	i32 collection_budget() const;
+	void collection_budget(i32 value);
+	bool export_saves() const;
+	void export_saves(bool value);
+	bool input_latency() const;
+	void input_latency(bool value);
 	bool vertical_sync() const;
 	void vertical_sync(bool value);
 	bool adaptive_sync() const;
@@ -43,8 +49,12 @@ public:
 	void yield(bool value);
 	i32 frame_rate() const;
 	void frame_rate(i32 value);
+	bool extrapolation() const;
+	void extrapolation(bool value);
 	r32 audio_volume() const;
 	void audio_volume(r32 value);
+	std::string audio_backend() const;
+	void audio_backend(const std::string& value);
 	r32 music_volume() const;
 	void music_volume(r32 value);
 	i32 channels() const;
@@ -0,0 +1,243 @@
+#include <cstring>
+#include <spdlog/spdlog.h>
+#include <tmxlite/Map.hpp>
+#include <tmxlite/TileLayer.hpp>
+#include <tmxlite/ImageLayer.hpp>
+#include <tmxlite/ObjectGroup.hpp>
+#include <entt/core/hashed_string.hpp>
+#include <apostellein/cast.hpp>
+
+#include "./field-file.hpp"
+#include "./byte-stream.hpp"
+#include "./tmx-convert.hpp"
+
+namespace {
+	constexpr char MAGIC[4] = { 'A', 'P', 'F', 'D' };
+	constexpr char AKTOR_TYPE[] = "aktor";
+	constexpr char WATER_TYPE[] = "water";
+	constexpr char DETER_PROPERTY[] = "deter";
+	constexpr char EVENT_PROPERTY[] = "event";
+	constexpr char FLAGS_PROPERTY[] = "flags";
+	constexpr char ID_PROPERTY[] = "id";
+	constexpr char COLLIDABLE_PROPERTY[] = "collide";
+	constexpr char PRIORITY_PROPERTY[] = "priority";
+	constexpr char SCROLL_X_PROPERTY[] = "scroll.x";
+	constexpr char SCROLL_Y_PROPERTY[] = "scroll.y";
+}
+
+std::string field_file::tileset(const tmx::Map& data) {
+	auto& tilesets = data.getTilesets();
+	if (tilesets.empty()) {
+		return {};
+	}
+	return tmx_convert::path_to_name(tilesets[0].getImagePath());
+}
+
+bool field_file::compile(const tmx::Map& data, const std::vector<u32>& key) {
+	this->clear();
+	bounds_ = tmx_convert::rect_to_rect(data);
+	texture_ = field_file::tileset(data);
+
+	for (auto&& layer : data.getLayers()) {
+		switch (layer->getType()) {
+		case tmx::Layer::Type::Tile: {
+			if (key.empty()) {
+				spdlog::warn("Can't load any tiles without loading tile attribute key!");
+				break;
+			}
+			auto& tiles = layer->getLayerAs<tmx::TileLayer>();
+			auto& recent = layers_.emplace_back();
+			for (auto&& prop : tiles.getProperties()) {
+				auto& name = prop.getName();
+				if (name == COLLIDABLE_PROPERTY) {
+					if (tmx_convert::prop_to_bool(prop)) {
+						recent.collidable = true;
+						recent.foreground = true;
+					}
+				} else if (name == PRIORITY_PROPERTY) {
+					recent.foreground = tmx_convert::prop_to_bool(prop);
+				}
+			}
+			auto& array = tiles.getTiles();
+			recent.indices.resize(array.size());
+			attributes_.resize(array.size());
+			for (udx idx = 0; idx < array.size(); ++idx) {
+				const auto type = as<i32>(array[idx].ID) - 1;
+				recent.indices[idx] = type;
+				if (recent.collidable and type >= 0 and as<udx>(type) < key.size()) {
+					attributes_[idx] = key[as<udx>(type)];
+				}
+			}
+			break;
+		}
+		case tmx::Layer::Type::Object: {
+			auto& objects = layer->getLayerAs<tmx::ObjectGroup>().getObjects();
+			for (auto&& obj : objects) {
+				if (auto& type = obj.getType(); type == AKTOR_TYPE) {
+					auto& recent = aktors_.emplace_back();
+					recent.name = obj.getName();
+					recent.type = entt::hashed_string::value(recent.name.c_str());
+					recent.position = tmx_convert::vec2_to_vec2(obj.getPosition());
+					for (auto&& prop : obj.getProperties()) {
+						auto& name = prop.getName();
+						if (name == DETER_PROPERTY) {
+							recent.deter = tmx_convert::prop_to_udx(prop);
+						} else if (name == EVENT_PROPERTY) {
+							recent.event = tmx_convert::prop_to_string(prop);
+						} else if (name == FLAGS_PROPERTY) {
+							recent.flags = tmx_convert::prop_to_uint(prop);
+						} else if (name == ID_PROPERTY) {
+							recent.id = tmx_convert::prop_to_int(prop);
+						}
+					}
+				} else if (type == WATER_TYPE) {
+					liquids_.push_back(field_liquid {
+						tmx_convert::rect_to_rect(obj.getAABB()),
+						as<u32>(aktors_.size())
+					});
+				}
+			}
+			break;
+		}
+		case tmx::Layer::Type::Image: {
+			auto& image = layer->getLayerAs<tmx::ImageLayer>();
+			auto& recent = parallaxes_.emplace_back();
+			recent.image = tmx_convert::path_to_name(image.getImagePath());
+			for (auto&& prop : image.getProperties()) {
+				auto& name = prop.getName();
+				if (name == SCROLL_X_PROPERTY) {
+					recent.scrolling.x = tmx_convert::prop_to_real(prop);
+				} else if (name == SCROLL_Y_PROPERTY) {
+					recent.scrolling.y = tmx_convert::prop_to_real(prop);
+				}
+			}
+			break;
+		}
+		default:
+			break;
+		}
+	}
+	return this->valid();
+}
+
+bool field_file::load(const std::vector<byte>& buffer) {
+	this->clear();
+	byte_reader stream { buffer };
+
+	char magic[sizeof(MAGIC)] {};
+	u32 version = 0;
+	if (
+		!stream.get(magic) or
+		std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 or
+		!stream.get(version) or
+		version != VERSION
+	) {
+		spdlog::error("Field file has wrong identifier or version!");
+		return false;
+	}
+
+	u32 layers = 0;
+	u32 parallaxes = 0;
+	u32 aktors = 0;
+	u32 liquids = 0;
+	bool result =
+		stream.get(bounds_) and
+		stream.get(texture_) and
+		stream.get(attributes_) and
+		stream.count(liquids);
+	if (result) {
+		liquids_.resize(liquids);
+		for (auto&& liquid : liquids_) {
+			result = result and
+				stream.get(liquid.hitbox) and
+				stream.get(liquid.order);
+		}
+	}
+	result = result and stream.count(layers);
+	if (result) {
+		layers_.resize(layers);
+		for (auto&& layer : layers_) {
+			result = result and
+				stream.get(layer.collidable) and
+				stream.get(layer.foreground) and
+				stream.get(layer.indices);
+		}
+	}
+	result = result and stream.count(parallaxes);
+	if (result) {
+		parallaxes_.resize(parallaxes);
+		for (auto&& pllx : parallaxes_) {
+			result = result and
+				stream.get(pllx.image) and
+				stream.get(pllx.scrolling);
+		}
+	}
+	result = result and stream.count(aktors);
+	if (result) {
+		aktors_.resize(aktors);
+		for (auto&& aktor : aktors_) {
+			u64 deter = 0;
+			result = result and
+				stream.get(aktor.type) and
+				stream.get(aktor.name) and
+				stream.get(aktor.position) and
+				stream.get(deter) and
+				stream.get(aktor.flags) and
+				stream.get(aktor.id) and
+				stream.get(aktor.event);
+			aktor.deter = as<udx>(deter);
+		}
+	}
+	if (!result or stream.cursor != buffer.size()) {
+		spdlog::error("Field file is truncated or malformed!");
+		this->clear();
+		return false;
+	}
+	return true;
+}
+
+std::vector<byte> field_file::dump() const {
+	byte_writer stream {};
+	stream.put(MAGIC);
+	stream.put(VERSION);
+	stream.put(bounds_);
+	stream.put(texture_);
+	stream.put(attributes_);
+	stream.put(as<u32>(liquids_.size()));
+	for (auto&& liquid : liquids_) {
+		stream.put(liquid.hitbox);
+		stream.put(liquid.order);
+	}
+	stream.put(as<u32>(layers_.size()));
+	for (auto&& layer : layers_) {
+		stream.put(layer.collidable);
+		stream.put(layer.foreground);
+		stream.put(layer.indices);
+	}
+	stream.put(as<u32>(parallaxes_.size()));
+	for (auto&& pllx : parallaxes_) {
+		stream.put(pllx.image);
+		stream.put(pllx.scrolling);
+	}
+	stream.put(as<u32>(aktors_.size()));
+	for (auto&& aktor : aktors_) {
+		stream.put(aktor.type);
+		stream.put(aktor.name);
+		stream.put(aktor.position);
+		stream.put(as<u64>(aktor.deter));
+		stream.put(aktor.flags);
+		stream.put(aktor.id);
+		stream.put(aktor.event);
+	}
+	return std::move(stream.buffer);
+}
+
+void field_file::clear() {
+	bounds_ = {};
+	texture_.clear();
+	attributes_.clear();
+	layers_.clear();
+	parallaxes_.clear();
+	aktors_.clear();
+	liquids_.clear();
+}
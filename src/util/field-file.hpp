@@ -0,0 +1,63 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <apostellein/rect.hpp>
+
+namespace tmx {
+	class Map;
+}
+
+struct field_tiles {
+	bool collidable {};
+	bool foreground {};
+	std::vector<i32> indices {};
+};
+
+struct field_parallax {
+	std::string image {};
+	glm::vec2 scrolling {};
+};
+
+struct field_aktor {
+	u32 type {};
+	std::string name {};
+	glm::vec2 position {};
+	udx deter {};
+	u32 flags {};
+	i32 id {};
+	std::string event {};
+};
+
+// order counts the aktors listed before the liquid, so the field spawns both
+// in the same order they sit in the description
+struct field_liquid {
+	rect hitbox {};
+	u32 order {};
+};
+
+struct field_file {
+public:
+	static constexpr u32 VERSION = 2;
+	static std::string tileset(const tmx::Map& data);
+	bool compile(const tmx::Map& data, const std::vector<u32>& key);
+	bool load(const std::vector<byte>& buffer);
+	std::vector<byte> dump() const;
+	void clear();
+	bool valid() const { return bounds_.w > 0.0f and bounds_.h > 0.0f; }
+	const rect& bounds() const { return bounds_; }
+	const std::string& texture() const { return texture_; }
+	const std::vector<u32>& attributes() const { return attributes_; }
+	const std::vector<field_tiles>& layers() const { return layers_; }
+	const std::vector<field_parallax>& parallaxes() const { return parallaxes_; }
+	const std::vector<field_aktor>& aktors() const { return aktors_; }
+	const std::vector<field_liquid>& liquids() const { return liquids_; }
+private:
+	rect bounds_ {};
+	std::string texture_ {};
+	std::vector<u32> attributes_ {};
+	std::vector<field_tiles> layers_ {};
+	std::vector<field_parallax> parallaxes_ {};
+	std::vector<field_aktor> aktors_ {};
+	std::vector<field_liquid> liquids_ {};
+};
@@ -3,44 +3,56 @@
 #include <entt/core/hashed_string.hpp>
 
 namespace img {
-	constexpr char Rough[] = "rough";
-	constexpr char Bullets[] = "bullets";
-	constexpr char Common[] = "common";
-	constexpr char Faces[] = "faces";
-	constexpr char Friends[] = "friends";
-	constexpr char Heads[] = "heads";
-	constexpr char Icon[] = "icon";
-	constexpr char Naomi[] = "naomi";
-	constexpr char Cave[] = "cave";
-	constexpr char House[] = "house";
-	constexpr char Silver[] = "silver";
+	constexpr entt::hashed_string Rough = "rough";
+	constexpr entt::hashed_string Bullets = "bullets";
+	constexpr entt::hashed_string Common = "common";
+	constexpr entt::hashed_string Faces = "faces";
+	constexpr entt::hashed_string Friends = "friends";
+	constexpr entt::hashed_string Heads = "heads";
+	constexpr entt::hashed_string Icon = "icon";
+	constexpr entt::hashed_string Naomi = "naomi";
+	constexpr entt::hashed_string Cave = "cave";
+	constexpr entt::hashed_string House = "house";
+	constexpr entt::hashed_string Silver = "silver";
 }
 
+// Every sound the engine plays by itself, listed once. Each one gets an id below,
+// and the field compiler bakes all of them into every field's noise bank.
+#define APOSTELLEIN_ENGINE_NOISES(X) \
+	X(Spark, "spark") \
+	X(Bwall, "bwall") \
+	X(Fan, "fan") \
+	X(Blade, "blade") \
+	X(Kannon, "kanon") \
+	X(Explode0, "explode_0") \
+	X(Explode1, "explode_1") \
+	X(Explode2, "explode_2") \
+	X(Beam, "beam") \
+	X(Drill, "drill") \
+	X(Spring, "spring") \
+	X(Splash, "splash") \
+	X(Text, "text") \
+	X(Select, "select") \
+	X(TitleBeg, "titlebeg") \
+	X(Inven, "inven") \
+	X(BrokenBarrier, "brokebarr") \
+	X(Damage, "damage") \
+	X(Walk, "walk") \
+	X(Landing, "land") \
+	X(Jump, "jump") \
+	X(Projectile0, "projectile_0") \
+	X(Razor, "razor") \
+	X(NpcDeath0, "npc_dth_0")
+
 namespace sfx {
-	constexpr entt::hashed_string Spark = "spark";
-	constexpr entt::hashed_string Bwall = "bwall";
-	constexpr entt::hashed_string Fan = "fan";
-	constexpr entt::hashed_string Blade = "blade";
-	constexpr entt::hashed_string Kannon = "kanon";
-	constexpr entt::hashed_string Explode0 = "explode_0";
-	constexpr entt::hashed_string Explode1 = "explode_1";
-	constexpr entt::hashed_string Explode2 = "explode_2";
-	constexpr entt::hashed_string Beam = "beam";
-	constexpr entt::hashed_string Drill = "drill";
-	constexpr entt::hashed_string Spring = "spring";
-	constexpr entt::hashed_string Splash = "splash";
-	constexpr entt::hashed_string Text = "text";
-	constexpr entt::hashed_string Select = "select";
-	constexpr entt::hashed_string TitleBeg = "titlebeg";
-	constexpr entt::hashed_string Inven = "inven";
-	constexpr entt::hashed_string BrokenBarrier = "brokebarr";
-	constexpr entt::hashed_string Damage = "damage";
-	constexpr entt::hashed_string Walk = "walk";
-	constexpr entt::hashed_string Landing = "land";
-	constexpr entt::hashed_string Jump = "jump";
-	constexpr entt::hashed_string Projectile0 = "projectile_0";
-	constexpr entt::hashed_string Razor = "razor";
-	constexpr entt::hashed_string NpcDeath0 = "npc_dth_0";
+#define APOSTELLEIN_NOISE_ID_(NAME, VALUE) constexpr entt::hashed_string NAME = VALUE;
+#define APOSTELLEIN_NOISE_ENTRY_(NAME, VALUE) NAME,
+	APOSTELLEIN_ENGINE_NOISES(APOSTELLEIN_NOISE_ID_)
+	constexpr entt::hashed_string Global[] {
+		APOSTELLEIN_ENGINE_NOISES(APOSTELLEIN_NOISE_ENTRY_)
+	};
+#undef APOSTELLEIN_NOISE_ENTRY_
+#undef APOSTELLEIN_NOISE_ID_
 }
 
 namespace anim {
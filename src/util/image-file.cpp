@@ -1,6 +1,7 @@
 #include <apostellein/cast.hpp>
 
 #include "./image-file.hpp"
+#include "./memory-tracker.hpp"
 
 #define STB_IMAGE_IMPLEMENTATION
 #define STBI_NO_STDIO
@@ -10,11 +11,12 @@
 #include <stb_image.h>
 
 void image_file::clear() {
-	dimensions_ = {};
 	if (pixels_) {
+		memory_tracker::release(memory_tag::images, this->length());
 		stbi_image_free(pixels_);
 		pixels_ = nullptr;
 	}
+	dimensions_ = {};
 }
 
 bool image_file::load(const std::vector<byte>& buffer) {
@@ -28,5 +30,10 @@ bool image_file::load(const std::vector<byte>& buffer) {
 		&components,
 		STBI_rgb_alpha
 	);
-	return pixels_ != nullptr;
+	if (!pixels_) {
+		dimensions_ = {};
+		return false;
+	}
+	memory_tracker::acquire(memory_tag::images, this->length());
+	return true;
 }
@@ -0,0 +1,120 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <spdlog/spdlog.h>
+
+#include "./lua-allocator.hpp"
+#include "./memory-tracker.hpp"
+
+namespace {
+	constexpr udx MAXIMUM_POOLED = lua_allocator::GRANULARITY * lua_allocator::SIZE_CLASSES;
+
+	// blocks larger than the biggest class come straight from the system
+	constexpr bool pooled_(udx length) noexcept {
+		return length <= MAXIMUM_POOLED;
+	}
+	constexpr udx class_of_(udx length) noexcept {
+		return (length + lua_allocator::GRANULARITY - 1) / lua_allocator::GRANULARITY - 1;
+	}
+}
+
+lua_allocator::~lua_allocator() {
+	for (auto&& chunk : chunks_) {
+		std::free(chunk);
+	}
+	memory_tracker::release(memory_tag::lua, stats_.reserved);
+}
+
+void* lua_allocator::allocate(void* user, void* pointer, udx previous, udx length) noexcept {
+	auto self = static_cast<lua_allocator*>(user);
+	if (length == 0) {
+		if (pointer) {
+			self->release_(pointer, previous);
+		}
+		return nullptr;
+	}
+	// when pointer is null, previous only describes the kind of object
+	if (!pointer) {
+		return self->acquire_(length);
+	}
+	if (pooled_(previous) and pooled_(length) and class_of_(previous) == class_of_(length)) {
+		self->stats_.bytes = self->stats_.bytes - previous + length;
+		self->stats_.peak = std::max(self->stats_.peak, self->stats_.bytes);
+		return pointer;
+	}
+	if (!pooled_(previous) and !pooled_(length)) {
+		auto result = std::realloc(pointer, length);
+		if (result) {
+			memory_tracker::release(memory_tag::lua, previous);
+			memory_tracker::acquire(memory_tag::lua, length);
+			self->stats_.bytes = self->stats_.bytes - previous + length;
+			self->stats_.peak = std::max(self->stats_.peak, self->stats_.bytes);
+		}
+		return result;
+	}
+	auto result = self->acquire_(length);
+	if (result) {
+		std::memcpy(result, pointer, std::min(previous, length));
+		self->release_(pointer, previous);
+	}
+	return result;
+}
+
+void* lua_allocator::acquire_(udx length) noexcept {
+	void* result = nullptr;
+	if (pooled_(length)) {
+		const udx index = class_of_(length);
+		if (!free_[index]) {
+			// carve a fresh chunk into blocks of this class
+			auto chunk = static_cast<byte*>(std::malloc(CHUNK_SIZE));
+			if (!chunk) {
+				spdlog::error("Lua allocator couldn't reserve another chunk!");
+				return nullptr;
+			}
+			// a null result lets lua run an emergency collection and try again
+			try {
+				chunks_.push_back(chunk);
+			} catch (const std::bad_alloc&) {
+				std::free(chunk);
+				return nullptr;
+			}
+			const udx size = (index + 1) * GRANULARITY;
+			for (udx offset = 0; offset + size <= CHUNK_SIZE; offset += size) {
+				auto block = reinterpret_cast<node*>(chunk + offset);
+				block->next = free_[index];
+				free_[index] = block;
+			}
+			stats_.reserved += CHUNK_SIZE;
+			memory_tracker::acquire(memory_tag::lua, CHUNK_SIZE);
+		}
+		auto block = free_[index];
+		free_[index] = block->next;
+		result = block;
+		++stats_.pooled;
+	} else {
+		result = std::malloc(length);
+		if (!result) {
+			return nullptr;
+		}
+		memory_tracker::acquire(memory_tag::lua, length);
+	}
+	++stats_.allocations;
+	stats_.bytes += length;
+	stats_.peak = std::max(stats_.peak, stats_.bytes);
+	return result;
+}
+
+void lua_allocator::release_(void* pointer, udx length) noexcept {
+	if (pooled_(length)) {
+		const udx index = class_of_(length);
+		auto block = static_cast<node*>(pointer);
+		block->next = free_[index];
+		free_[index] = block;
+	} else {
+		std::free(pointer);
+		memory_tracker::release(memory_tag::lua, length);
+	}
+	++stats_.frees;
+	stats_.bytes -= length;
+}
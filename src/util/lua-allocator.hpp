@@ -0,0 +1,34 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <apostellein/struct.hpp>
+
+struct lua_allocator : public not_copyable, public not_moveable {
+public:
+	static constexpr udx GRANULARITY = 16;
+	static constexpr udx SIZE_CLASSES = 16;
+	static constexpr udx CHUNK_SIZE = 64 * 1024;
+	struct stats_type {
+		udx allocations {};
+		udx pooled {};
+		udx frees {};
+		udx bytes {};
+		udx peak {};
+		udx reserved {};
+	};
+	lua_allocator() noexcept = default;
+	~lua_allocator();
+public:
+	static void* allocate(void* user, void* pointer, udx previous, udx length) noexcept;
+	const stats_type& stats() const { return stats_; }
+private:
+	struct node {
+		node* next;
+	};
+	void* acquire_(udx length) noexcept;
+	void release_(void* pointer, udx length) noexcept;
+	std::array<node*, SIZE_CLASSES> free_ {};
+	std::vector<byte*> chunks_ {};
+	stats_type stats_ {};
+};
@@ -0,0 +1,62 @@
+#include <cstring>
+#include <lua.hpp>
+
+#include "./lua-bytecode.hpp"
+
+namespace {
+	constexpr char MAGIC[4] = { 'A', 'P', 'L', 'B' };
+	constexpr u32 VERSION = 1;
+	constexpr u64 FNV_OFFSET = 0xCBF29CE484222325;
+	constexpr u64 FNV_PRIME = 0x100000001B3;
+	constexpr udx HEADER_SIZE = sizeof(MAGIC) + sizeof(u32) + sizeof(u64);
+	constexpr char BINARY_MODE[] = "b";
+
+	i32 writer_(lua_State*, const void* data, udx length, void* user) {
+		auto buffer = reinterpret_cast<std::vector<byte>*>(user);
+		auto ptr = reinterpret_cast<const byte*>(data);
+		buffer->insert(buffer->end(), ptr, ptr + length);
+		return 0;
+	}
+}
+
+u64 lua_bytecode::hash(const std::string& source) {
+	u64 result = FNV_OFFSET;
+	for (auto&& c : source) {
+		result ^= static_cast<u64>(static_cast<byte>(c));
+		result *= FNV_PRIME;
+	}
+	return result;
+}
+
+bool lua_bytecode::load(lua_State* state, const std::vector<byte>& buffer, u64 hash, const std::string& name) {
+	// header must match exactly, otherwise source is newer than the cache
+	if (buffer.size() <= HEADER_SIZE or std::memcmp(buffer.data(), MAGIC, sizeof(MAGIC)) != 0) {
+		return false;
+	}
+	u32 version = 0;
+	std::memcpy(&version, buffer.data() + sizeof(MAGIC), sizeof(u32));
+	u64 stored = 0;
+	std::memcpy(&stored, buffer.data() + sizeof(MAGIC) + sizeof(u32), sizeof(u64));
+	if (version != VERSION or stored != hash) {
+		return false;
+	}
+	const auto chunk = reinterpret_cast<const char*>(buffer.data() + HEADER_SIZE);
+	if (luaL_loadbufferx(state, chunk, buffer.size() - HEADER_SIZE, name.c_str(), BINARY_MODE) != LUA_OK) {
+		// lua rejects bytecode from other versions & builds here
+		lua_pop(state, 1);
+		return false;
+	}
+	return true;
+}
+
+std::vector<byte> lua_bytecode::dump(lua_State* state, u64 hash) {
+	std::vector<byte> result(HEADER_SIZE);
+	std::memcpy(result.data(), MAGIC, sizeof(MAGIC));
+	std::memcpy(result.data() + sizeof(MAGIC), &VERSION, sizeof(u32));
+	std::memcpy(result.data() + sizeof(MAGIC) + sizeof(u32), &hash, sizeof(u64));
+	// keep debug info so script errors still report line numbers
+	if (lua_dump(state, writer_, &result, 0) != 0) {
+		return {};
+	}
+	return result;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <apostellein/def.hpp>
+
+struct lua_State;
+
+namespace lua_bytecode {
+	u64 hash(const std::string& source);
+	bool load(lua_State* state, const std::vector<byte>& buffer, u64 hash, const std::string& name);
+	std::vector<byte> dump(lua_State* state, u64 hash);
+}
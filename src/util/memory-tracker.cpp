@@ -0,0 +1,81 @@
+#include <array>
+#include <atomic>
+#include <fmt/format.h>
+
+#include "./memory-tracker.hpp"
+
+namespace {
+	constexpr udx TOTAL_TAGS = static_cast<udx>(memory_tag::total_);
+	constexpr char REPORT_HEADER[] = "subsystem,bytes,peak,allocations\n";
+	constexpr std::array<const char*, TOTAL_TAGS> TAG_NAMES {
+		"Images",
+		"Animations",
+		"Noises",
+		"Fonts",
+		"I18N",
+		"Tiles",
+		"Registry",
+		"Renderer",
+		"Lua",
+		"Textures (GL)",
+		"Buffers (GL)",
+		"Sounds (AL)"
+	};
+
+	struct counter {
+		std::atomic<udx> bytes {};
+		std::atomic<udx> peak {};
+		std::atomic<udx> allocations {};
+	};
+
+	std::array<counter, TOTAL_TAGS> counters_ {};
+
+	counter& counter_of_(memory_tag tag) noexcept {
+		return counters_[static_cast<udx>(tag)];
+	}
+}
+
+void memory_tracker::acquire(memory_tag tag, udx length) noexcept {
+	auto& recent = counter_of_(tag);
+	const udx bytes = recent.bytes.fetch_add(length, std::memory_order_relaxed) + length;
+	recent.allocations.fetch_add(1, std::memory_order_relaxed);
+	udx peak = recent.peak.load(std::memory_order_relaxed);
+	while (bytes > peak) {
+		if (recent.peak.compare_exchange_weak(peak, bytes, std::memory_order_relaxed)) {
+			break;
+		}
+	}
+}
+
+void memory_tracker::release(memory_tag tag, udx length) noexcept {
+	counter_of_(tag).bytes.fetch_sub(length, std::memory_order_relaxed);
+}
+
+memory_tracker::stats_type memory_tracker::stats(memory_tag tag) noexcept {
+	auto& recent = counter_of_(tag);
+	return {
+		recent.bytes.load(std::memory_order_relaxed),
+		recent.peak.load(std::memory_order_relaxed),
+		recent.allocations.load(std::memory_order_relaxed)
+	};
+}
+
+const char* memory_tracker::name(memory_tag tag) noexcept {
+	return TAG_NAMES[static_cast<udx>(tag)];
+}
+
+std::string memory_tracker::report() {
+	std::string result { REPORT_HEADER };
+	for (udx idx = 0; idx < TOTAL_TAGS; ++idx) {
+		const auto tag = static_cast<memory_tag>(idx);
+		const auto info = memory_tracker::stats(tag);
+		result += fmt::format(
+			"{},{},{},{}\n",
+			memory_tracker::name(tag),
+			info.bytes,
+			info.peak,
+			info.allocations
+		);
+	}
+	return result;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <apostellein/def.hpp>
+
+enum class memory_tag : u32 {
+	images,
+	animations,
+	noises,
+	fonts,
+	i18n,
+	tiles,
+	registry,
+	renderer,
+	lua,
+	textures,
+	buffers,
+	sounds,
+	total_
+};
+
+namespace memory_tracker {
+	struct stats_type {
+		udx bytes {};
+		udx peak {};
+		udx allocations {};
+	};
+	// Counters are atomic, since some of these allocations happen off the main thread
+	void acquire(memory_tag tag, udx length) noexcept;
+	void release(memory_tag tag, udx length) noexcept;
+	stats_type stats(memory_tag tag) noexcept;
+	const char* name(memory_tag tag) noexcept;
+	std::string report();
+}
+
+template<typename T, memory_tag Tag>
+struct tracked_allocator {
+public:
+	using value_type = T;
+	template<typename U>
+	struct rebind {
+		using other = tracked_allocator<U, Tag>;
+	};
+	tracked_allocator() noexcept = default;
+	template<typename U>
+	tracked_allocator(const tracked_allocator<U, Tag>&) noexcept {}
+public:
+	T* allocate(udx count) {
+		T* result = std::allocator<T>{}.allocate(count);
+		memory_tracker::acquire(Tag, count * sizeof(T));
+		return result;
+	}
+	void deallocate(T* pointer, udx count) noexcept {
+		memory_tracker::release(Tag, count * sizeof(T));
+		std::allocator<T>{}.deallocate(pointer, count);
+	}
+	template<typename U>
+	bool operator==(const tracked_allocator<U, Tag>&) const noexcept { return true; }
+	template<typename U>
+	bool operator!=(const tracked_allocator<U, Tag>&) const noexcept { return false; }
+};
+
+template<typename T, memory_tag Tag>
+using tracked_vector = std::vector<T, tracked_allocator<T, Tag>>;
+
+template<typename K, typename V, memory_tag Tag>
+using tracked_map = std::map<K, V, std::less<K>, tracked_allocator<std::pair<const K, V>, Tag>>;
+
+template<typename K, typename V, memory_tag Tag>
+using tracked_unordered_map = std::unordered_map<
+	K, V,
+	std::hash<K>,
+	std::equal_to<K>,
+	tracked_allocator<std::pair<const K, V>, Tag>
+>;
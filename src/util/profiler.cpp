@@ -0,0 +1,209 @@
+#if defined(APOSTELLEIN_IMGUI_DEBUGGER)
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <algorithm>
+#include <nlohmann/json.hpp>
+#include <apostellein/cast.hpp>
+
+#include "./profiler.hpp"
+
+namespace {
+	constexpr u32 RING_CAPACITY = 4096;
+	constexpr udx MAXIMUM_FRAMES = 120;
+	constexpr r64 NANOSECONDS_PER_MICROSECOND = 1000.0;
+	constexpr char UNNAMED_THREAD[] = "thread";
+
+	// Single producer (the owning thread), single consumer (the main thread)
+	struct ring : public not_copyable {
+		std::array<profiler::event, RING_CAPACITY> events {};
+		std::atomic<u32> head {};
+		std::atomic<u32> tail {};
+		std::atomic<bool> vacant {};
+		const char* name { UNNAMED_THREAD };
+		u32 thread {};
+		u32 depth {};
+	};
+
+	// Hands the ring back when its thread exits, so short-lived threads
+	// (like each tune's music thread) don't pile up new ones.
+	struct owner : public not_copyable {
+		ring* ptr {};
+		~owner() {
+			if (ptr) {
+				ptr->vacant.store(true, std::memory_order_release);
+			}
+		}
+	};
+
+	std::mutex registry_ {};
+	std::vector<std::unique_ptr<ring>> rings_ {};
+	std::atomic<udx> dropped_ {};
+	std::array<profiler::frame_type, MAXIMUM_FRAMES> frames_ {};
+	udx cursor_ {};
+	udx recorded_ {};
+	i64 marker_ {};
+	bool paused_ {};
+	thread_local owner owner_ {};
+
+	i64 now_() {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()
+		).count();
+	}
+
+	ring* acquire_() {
+		if (owner_.ptr) {
+			return owner_.ptr;
+		}
+		const std::lock_guard<std::mutex> lock { registry_ };
+		auto iter = std::find_if(rings_.begin(), rings_.end(), [](const auto& that) {
+			return that->vacant.load(std::memory_order_acquire);
+		});
+		if (iter != rings_.end()) {
+			auto ptr = iter->get();
+			ptr->name = UNNAMED_THREAD;
+			ptr->depth = 0;
+			ptr->vacant.store(false, std::memory_order_relaxed);
+			owner_.ptr = ptr;
+		} else {
+			auto& recent = rings_.emplace_back(std::make_unique<ring>());
+			recent->thread = as<u32>(rings_.size() - 1);
+			owner_.ptr = recent.get();
+		}
+		return owner_.ptr;
+	}
+
+	void drain_(std::vector<profiler::event>& output) {
+		const std::lock_guard<std::mutex> lock { registry_ };
+		for (auto&& ptr : rings_) {
+			const u32 tail = ptr->tail.load(std::memory_order_relaxed);
+			const u32 head = ptr->head.load(std::memory_order_acquire);
+			for (u32 idx = tail; idx != head; ++idx) {
+				output.push_back(ptr->events[idx % RING_CAPACITY]);
+			}
+			ptr->tail.store(head, std::memory_order_release);
+		}
+	}
+}
+
+profiler::zone::zone(const char* name) noexcept {
+	auto ptr = acquire_();
+	name_ = name;
+	ring_ = ptr;
+	depth_ = ptr->depth++;
+	begin_ = now_();
+}
+
+profiler::zone::~zone() noexcept {
+	const i64 end = now_();
+	auto ptr = reinterpret_cast<ring*>(ring_);
+	--ptr->depth;
+	const u32 head = ptr->head.load(std::memory_order_relaxed);
+	const u32 tail = ptr->tail.load(std::memory_order_acquire);
+	if (head - tail >= RING_CAPACITY) {
+		dropped_.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+	ptr->events[head % RING_CAPACITY] = { name_, begin_, end, ptr->thread, depth_ };
+	ptr->head.store(head + 1, std::memory_order_release);
+}
+
+void profiler::thread(const char* name) {
+	acquire_()->name = name;
+}
+
+void profiler::frame() {
+	const i64 now = now_();
+	if (paused_) {
+		// keep the rings from filling up while the timeline is held
+		static std::vector<event> discard {};
+		discard.clear();
+		drain_(discard);
+		marker_ = now;
+		return;
+	}
+	cursor_ = (cursor_ + 1) % MAXIMUM_FRAMES;
+	auto& recent = frames_[cursor_];
+	recent.begin = marker_ > 0 ? marker_ : now;
+	recent.end = now;
+	recent.events.clear();
+	drain_(recent.events);
+	std::sort(recent.events.begin(), recent.events.end(), [](const auto& lhv, const auto& rhv) {
+		if (lhv.thread != rhv.thread) {
+			return lhv.thread < rhv.thread;
+		}
+		return lhv.begin < rhv.begin;
+	});
+	recorded_ = std::min(recorded_ + 1, MAXIMUM_FRAMES);
+	marker_ = now;
+}
+
+void profiler::pause(bool value) {
+	paused_ = value;
+}
+
+bool profiler::paused() {
+	return paused_;
+}
+
+const profiler::frame_type& profiler::latest() {
+	return frames_[cursor_];
+}
+
+udx profiler::threads() {
+	const std::lock_guard<std::mutex> lock { registry_ };
+	return rings_.size();
+}
+
+const char* profiler::thread_name(u32 index) {
+	const std::lock_guard<std::mutex> lock { registry_ };
+	if (index < rings_.size()) {
+		return rings_[index]->name;
+	}
+	return UNNAMED_THREAD;
+}
+
+udx profiler::dropped() {
+	return dropped_.load(std::memory_order_relaxed);
+}
+
+nlohmann::json profiler::trace() {
+	// chrome://tracing and perfetto both read this
+	auto events = nlohmann::json::array();
+	{
+		const std::lock_guard<std::mutex> lock { registry_ };
+		for (auto&& ptr : rings_) {
+			events.push_back({
+				{ "name", "thread_name" },
+				{ "ph", "M" },
+				{ "pid", 0 },
+				{ "tid", ptr->thread },
+				{ "args", { { "name", ptr->name } } }
+			});
+		}
+	}
+	const auto first = (cursor_ + MAXIMUM_FRAMES + 1 - recorded_) % MAXIMUM_FRAMES;
+	for (udx it = 0; it < recorded_; ++it) {
+		auto& frame = frames_[(first + it) % MAXIMUM_FRAMES];
+		for (auto&& e : frame.events) {
+			events.push_back({
+				{ "name", e.name },
+				{ "ph", "X" },
+				{ "pid", 0 },
+				{ "tid", e.thread },
+				{ "ts", as<r64>(e.begin) / NANOSECONDS_PER_MICROSECOND },
+				{ "dur", as<r64>(e.end - e.begin) / NANOSECONDS_PER_MICROSECOND }
+			});
+		}
+	}
+	nlohmann::json result {};
+	result["traceEvents"] = events;
+	result["displayTimeUnit"] = "ms";
+	return result;
+}
+
+#endif
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <apostellein/def.hpp>
+
+#if defined(APOSTELLEIN_IMGUI_DEBUGGER)
+
+#include <vector>
+#include <nlohmann/json_fwd.hpp>
+#include <apostellein/struct.hpp>
+
+namespace profiler {
+	struct event {
+		const char* name {};
+		i64 begin {};
+		i64 end {};
+		u32 thread {};
+		u32 depth {};
+	};
+
+	struct frame_type {
+		i64 begin {};
+		i64 end {};
+		std::vector<event> events {};
+	};
+
+	// Zone names have to be string literals, since they're only read
+	// after the zone is gone.
+	struct zone : public not_copyable {
+		zone(const char* name) noexcept;
+		~zone() noexcept;
+	private:
+		const char* name_ {};
+		void* ring_ {};
+		i64 begin_ {};
+		u32 depth_ {};
+	};
+
+	void thread(const char* name);
+	void frame();
+	void pause(bool value);
+	bool paused();
+	const frame_type& latest();
+	udx threads();
+	const char* thread_name(u32 index);
+	udx dropped();
+	nlohmann::json trace();
+}
+
+#define APOSTELLEIN_ZONE_CONCAT_(LHV, RHV) LHV##RHV
+#define APOSTELLEIN_ZONE_SYMBOL_(LINE) APOSTELLEIN_ZONE_CONCAT_(apostellein_zone_, LINE)
+#define APOSTELLEIN_ZONE(NAME) const profiler::zone APOSTELLEIN_ZONE_SYMBOL_(__LINE__) { NAME }
+#define APOSTELLEIN_THREAD(NAME) profiler::thread(NAME)
+#define APOSTELLEIN_FRAME() profiler::frame()
+
+#else
+
+#define APOSTELLEIN_ZONE(NAME) static_cast<void>(0)
+#define APOSTELLEIN_THREAD(NAME) static_cast<void>(0)
+#define APOSTELLEIN_FRAME() static_cast<void>(0)
+
+#endif
@@ -0,0 +1,271 @@
+#include <cstdlib>
+#include <cstring>
+#include <spdlog/spdlog.h>
+#include <nlohmann/json.hpp>
+#include <apostellein/cast.hpp>
+
+#include "./save-file.hpp"
+#include "./byte-stream.hpp"
+
+namespace {
+	constexpr char MAGIC[4] = { 'A', 'P', 'S', 'V' };
+	constexpr char FIELD_ENTRY[] = "Field";
+	constexpr char TICKS_ENTRY[] = "Ticks";
+	constexpr char CURSOR_ENTRY[] = "Cursor";
+	constexpr char PROVISION_ENTRY[] = "Provision";
+	constexpr char ITEMS_ENTRY[] = "Items";
+	constexpr char FLAGS_ENTRY[] = "Flags";
+	constexpr char BARRIER_ENTRY[] = "Barrier";
+	constexpr char POISON_ENTRY[] = "Poison";
+	constexpr char EQUIPMENT_ENTRY[] = "Equipment";
+	constexpr char POSITION_ENTRY[] = "Position";
+	constexpr u64 FNV_OFFSET = 0xCBF29CE484222325ULL;
+	constexpr u64 FNV_PRIME = 0x100000001B3ULL;
+
+	u64 checksum_(const byte* data, udx length) {
+		u64 result = FNV_OFFSET;
+		for (udx idx = 0; idx < length; ++idx) {
+			result ^= data[idx];
+			result *= FNV_PRIME;
+		}
+		return result;
+	}
+}
+
+bool save_file::load(const std::vector<byte>& buffer) {
+	this->clear();
+	// checksum covers everything before it
+	if (buffer.size() < sizeof(MAGIC) + sizeof(u32) + sizeof(u64)) {
+		spdlog::error("Save file is truncated!");
+		return false;
+	}
+	const udx length = buffer.size() - sizeof(u64);
+	{
+		u64 expected = 0;
+		std::memcpy(&expected, buffer.data() + length, sizeof(u64));
+		if (checksum_(buffer.data(), length) != expected) {
+			spdlog::error("Save file checksum doesn't match!");
+			return false;
+		}
+	}
+	byte_reader stream { buffer };
+	char magic[sizeof(MAGIC)] {};
+	u32 version = 0;
+	if (
+		!stream.get(magic) or
+		std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 or
+		!stream.get(version) or
+		version != VERSION
+	) {
+		spdlog::error("Save file has wrong identifier or version!");
+		return false;
+	}
+
+	u32 count = 0;
+	bool result =
+		stream.get(field) and
+		stream.get(ticks) and
+		stream.get(cursor) and
+		stream.get(provision) and
+		stream.count(count);
+	if (result) {
+		items.resize(count);
+		for (auto&& slot : items) {
+			result = result and
+				stream.get(slot.type) and
+				stream.get(slot.count) and
+				stream.get(slot.limit) and
+				stream.get(slot.weapon);
+		}
+	}
+	result = result and
+		stream.get(flags) and
+		stream.get(maximum) and
+		stream.get(barrier) and
+		stream.get(poison) and
+		stream.get(position) and
+		stream.get(equipment);
+	if (!result or stream.cursor != length) {
+		spdlog::error("Save file is malformed!");
+		this->clear();
+		return false;
+	}
+	return true;
+}
+
+std::vector<byte> save_file::dump() const {
+	byte_writer stream {};
+	stream.put(MAGIC);
+	stream.put(VERSION);
+	stream.put(field);
+	stream.put(ticks);
+	stream.put(cursor);
+	stream.put(provision);
+	// fields one by one so padding never reaches the checksum
+	stream.put(as<u32>(items.size()));
+	for (auto&& slot : items) {
+		stream.put(slot.type);
+		stream.put(slot.count);
+		stream.put(slot.limit);
+		stream.put(slot.weapon);
+	}
+	stream.put(flags);
+	stream.put(maximum);
+	stream.put(barrier);
+	stream.put(poison);
+	stream.put(position);
+	stream.put(equipment);
+	stream.put(checksum_(stream.buffer.data(), stream.buffer.size()));
+	return std::move(stream.buffer);
+}
+
+void save_file::read(const nlohmann::json& data) {
+	this->clear();
+	if (
+		data.contains(FIELD_ENTRY) and
+		data[FIELD_ENTRY].is_string()
+	) {
+		field = data[FIELD_ENTRY].get<std::string>();
+	}
+	if (
+		data.contains(TICKS_ENTRY) and
+		data[TICKS_ENTRY].is_number_unsigned()
+	) {
+		ticks = data[TICKS_ENTRY].get<i64>();
+	}
+	if (
+		data.contains(CURSOR_ENTRY) and
+		data[CURSOR_ENTRY].is_number_unsigned()
+	) {
+		cursor = data[CURSOR_ENTRY].get<u64>();
+	}
+	if (
+		data.contains(PROVISION_ENTRY) and
+		data[PROVISION_ENTRY].is_number_unsigned()
+	) {
+		provision = data[PROVISION_ENTRY].get<i64>();
+	}
+	if (
+		data.contains(ITEMS_ENTRY) and
+		data[ITEMS_ENTRY].is_array()
+	) {
+		auto& list = data[ITEMS_ENTRY];
+		items.resize(list.size());
+		for (udx x = 0; x < list.size(); ++x) {
+			if (
+				list[x].is_array() and
+				list[x].size() == 4 and
+				list[x][0].is_number_integer() and
+				list[x][1].is_number_integer() and
+				list[x][2].is_number_integer() and
+				list[x][3].is_boolean()
+			) {
+				items[x].type = list[x][0].get<i32>();
+				items[x].count = list[x][1].get<i32>();
+				items[x].limit = list[x][2].get<i32>();
+				items[x].weapon = list[x][3].get<bool>();
+			}
+		}
+	}
+	if (
+		data.contains(FLAGS_ENTRY) and
+		data[FLAGS_ENTRY].is_array()
+	) {
+		auto& list = data[FLAGS_ENTRY];
+		flags.resize(list.size());
+		for (udx idx = 0; idx < list.size(); ++idx) {
+			if (list[idx].is_number_unsigned()) {
+				flags[idx] = list[idx].get<u64>();
+			}
+		}
+	}
+	if (
+		data.contains(BARRIER_ENTRY) and
+		data[BARRIER_ENTRY].is_array() and
+		data[BARRIER_ENTRY].size() == 2 and
+		data[BARRIER_ENTRY][0].is_number_unsigned() and
+		data[BARRIER_ENTRY][1].is_number_unsigned()
+	) {
+		maximum = data[BARRIER_ENTRY][0].get<i32>();
+		barrier = data[BARRIER_ENTRY][1].get<i32>();
+	}
+	if (
+		data.contains(POISON_ENTRY) and
+		data[POISON_ENTRY].is_number_unsigned()
+	) {
+		poison = data[POISON_ENTRY].get<i32>();
+	}
+	if (
+		data.contains(POSITION_ENTRY) and
+		data[POSITION_ENTRY].is_array() and
+		data[POSITION_ENTRY].size() == 2 and
+		data[POSITION_ENTRY][0].is_number() and
+		data[POSITION_ENTRY][1].is_number()
+	) {
+		position = {
+			data[POSITION_ENTRY][0].get<r32>(),
+			data[POSITION_ENTRY][1].get<r32>()
+		};
+	}
+	if (
+		data.contains(EQUIPMENT_ENTRY) and
+		data[EQUIPMENT_ENTRY].is_string()
+	) {
+		const std::string hex = data[EQUIPMENT_ENTRY].get<std::string>();
+		equipment = as<u32>(std::strtoul(hex.c_str(), nullptr, 0));
+	}
+}
+
+void save_file::write(nlohmann::json& data) const {
+	data[FIELD_ENTRY] = field;
+	data[TICKS_ENTRY] = ticks;
+	data[CURSOR_ENTRY] = cursor;
+	data[PROVISION_ENTRY] = provision;
+	{
+		auto entry = nlohmann::json::array();
+		for (auto&& slot : items) {
+			auto details = nlohmann::json::array({
+				slot.type,
+				slot.count,
+				slot.limit,
+				slot.weapon
+			});
+			entry.push_back(details);
+		}
+		data[ITEMS_ENTRY] = entry;
+	}
+	{
+		auto entry = nlohmann::json::array();
+		for (auto&& flag : flags) {
+			entry.push_back(flag);
+		}
+		data[FLAGS_ENTRY] = entry;
+	}
+	data[BARRIER_ENTRY] = nlohmann::json::array({
+		maximum,
+		barrier
+	});
+	data[POISON_ENTRY] = poison;
+	data[POSITION_ENTRY] = nlohmann::json::array({
+		position.x,
+		position.y
+	});
+	data[EQUIPMENT_ENTRY] = fmt::format(
+		"{:#010x}", // 0x00000000
+		equipment
+	);
+}
+
+void save_file::clear() {
+	field.clear();
+	ticks = 0;
+	cursor = 0;
+	provision = -1;
+	items.clear();
+	flags.clear();
+	maximum = 0;
+	barrier = 0;
+	poison = 0;
+	position = {};
+	equipment = 0;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <nlohmann/json_fwd.hpp>
+#include <glm/vec2.hpp>
+#include <apostellein/def.hpp>
+
+#include "./item-slot.hpp"
+
+struct save_file {
+public:
+	static constexpr u32 VERSION = 1;
+	bool load(const std::vector<byte>& buffer);
+	std::vector<byte> dump() const;
+	void read(const nlohmann::json& data);
+	void write(nlohmann::json& data) const;
+	void clear();
+public:
+	// controller
+	std::string field {};
+	i64 ticks {};
+	u64 cursor {};
+	i64 provision { -1 };
+	std::vector<item_slot> items {};
+	std::vector<u64> flags {};
+	// player
+	i32 maximum {};
+	i32 barrier {};
+	i32 poison {};
+	glm::vec2 position {};
+	u32 equipment {};
+};
@@ -0,0 +1,41 @@
+#include <algorithm>
+#include <apostellein/konst.hpp>
+#include <apostellein/cast.hpp>
+
+#include "./tick-clock.hpp"
+
+udx tick_clock::advance(i64 now) {
+	const i64 start = current_;
+	ticks_ = 0;
+	while (now >= current_ and ticks_ < MAXIMUM_TICKS) {
+		current_ += konst::NANOSECONDS_PER_TICK();
+		++ticks_;
+	}
+	if (ticks_ > 0) {
+		previous_ = start;
+	}
+	return ticks_;
+}
+
+i64 tick_clock::drop(i64 now) {
+	// only a capped batch can leave a backlog behind
+	if (ticks_ < MAXIMUM_TICKS or now < current_) {
+		return 0;
+	}
+	const i64 backlog = now - current_;
+	previous_ = now;
+	current_ = now + konst::NANOSECONDS_PER_TICK();
+	ticks_ = 0;
+	return backlog;
+}
+
+r32 tick_clock::ratio(i64 now, r32 maximum) const {
+	if (current_ > previous_) {
+		return std::clamp(
+			as<r32>(now - previous_) /
+			as<r32>(current_ - previous_),
+			0.0f, maximum
+		);
+	}
+	return 1.0f;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <apostellein/def.hpp>
+
+// Turns elapsed time into whole simulation ticks. Time is always passed in,
+// so the catch-up rules can be driven without a real clock.
+struct tick_clock {
+public:
+	static constexpr udx MAXIMUM_TICKS = 10;
+	udx advance(i64 now);
+	i64 drop(i64 now);
+	r32 ratio(i64 now, r32 maximum) const;
+	i64 previous() const { return previous_; }
+	i64 current() const { return current_; }
+private:
+	i64 previous_ {};
+	i64 current_ {};
+	udx ticks_ {};
+};
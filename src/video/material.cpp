@@ -3,6 +3,7 @@
 #include <array>
 #include <set>
 #include <spdlog/spdlog.h>
+#include <glm/vec3.hpp>
 #include <apostellein/cast.hpp>
 
 #define STB_RECT_PACK_IMPLEMENTATION
@@ -10,11 +11,18 @@
 
 #include "./material.hpp"
 #include "./opengl.hpp"
+#include "../util/memory-tracker.hpp"
 
 namespace {
 	constexpr u32 DEFAULT_FORMAT = GL_RGBA2;
 	constexpr i32 DEFAULT_LAYERS = 3;
 	constexpr i32 DEFAULT_MIPMAP = 1;
+	// drivers rarely keep GL_RGBA2 at two bits per channel
+	constexpr udx RESIDENT_BYTES =
+		static_cast<udx>(image_file::MAXIMUM_LENGTH) *
+		static_cast<udx>(image_file::MAXIMUM_LENGTH) *
+		static_cast<udx>(DEFAULT_LAYERS) *
+		sizeof(chroma);
 	constexpr i32 FURTHER_HEIGHT = 1 << 30;
 	constexpr i32 TOTAL_SEGMENTS =
 		(image_file::MAXIMUM_LENGTH / image_file::MINIMUM_LENGTH) *
@@ -30,6 +38,7 @@ struct virtual_texture_layer : public not_moveable {
 		context.num_nodes = TOTAL_SEGMENTS;
 		context.align = (context.width + context.num_nodes - 1) / context.num_nodes;
 		nodes.resize(as<udx>(TOTAL_SEGMENTS));
+		this->reset();
 	}
 	void reset() {
 		context.active_head = &context.extra[0];
@@ -101,11 +110,13 @@ struct virtual_texture : public not_moveable {
 			glCheck(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
 			glCheck(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
 		}
+		memory_tracker::acquire(memory_tag::textures, RESIDENT_BYTES);
 	}
 	~virtual_texture() {
 		if (handle_ != 0) {
 			glCheck(glDeleteTextures(1, &handle_));
 		}
+		memory_tracker::release(memory_tag::textures, RESIDENT_BYTES);
 	}
 public:
 	static i32 generate_id() {
@@ -115,7 +126,23 @@ public:
 	bool append(const glm::ivec2& dimensions, i32& id, i32& atlas) {
 		invalidated = true;
 		id = virtual_texture::generate_id();
-		// Find viable space
+		// Packing into the current skyline leaves every resident material where it is
+		for (auto&& layer : layers_) {
+			stbrp_rect space {
+				id, // id
+				as<stbrp_coord>(dimensions.x), // w
+				as<stbrp_coord>(dimensions.y), // h
+				0, 0, // x, y
+				0 // was_packed
+			};
+			if (stbrp_pack_rects(&layer.context, &space, 1)) {
+				layer.spaces.push_back(space);
+				const auto diff = std::distance(layers_.data(), &layer);
+				atlas = as<i32>(diff);
+				return true;
+			}
+		}
+		// Otherwise repack whole layers, which may move resident materials
 		for (auto&& layer : layers_) {
 			layer.reset();
 			layer.spaces.push_back({
@@ -173,26 +200,117 @@ public:
 		const auto target = ogl::direct_state_available() ?
 			handle_ :
 			GL_TEXTURE_2D_ARRAY;
+		// Resident materials only move when a layer had to be repacked, and
+		// their pixels are already on the GPU, so they're copied over there
+		std::vector<relocation> relocations {};
 		for (auto&& iter : cache) {
 			i32 atlas = 0;
-			if (const auto space = this->remember(iter->id(), atlas); space) {
-				glCheck(glReceiveTexture(
-					target, 0,
-					space->x, space->y, atlas,
-					space->w, space->h, 1,
-					GL_RGBA, GL_UNSIGNED_BYTE,
-					iter->pixels()
-				));
-				iter->offset(atlas, space->x, space->y);
+			if (const auto space = this->remember(iter->id_, atlas); space) {
+				if (!iter->image_.valid() and (
+					atlas != iter->atlas_ or
+					space->x != iter->offset_.x or
+					space->y != iter->offset_.y
+				)) {
+					relocations.push_back({
+						glm::ivec3{ iter->offset_, iter->atlas_ },
+						glm::ivec3{ space->x, space->y, atlas },
+						iter->dimensions_
+					});
+				}
 			} else {
 				throw std::runtime_error("Virtual texture layer cannot remember atlases or offsets!");
 			}
 		}
+		if (!relocations.empty()) {
+			this->relocate_(relocations);
+		}
+		for (auto&& iter : cache) {
+			i32 atlas = 0;
+			if (const auto space = this->remember(iter->id_, atlas); space) {
+				if (iter->image_.valid()) {
+					glCheck(glReceiveTexture(
+						target, 0,
+						space->x, space->y, atlas,
+						space->w, space->h, 1,
+						GL_RGBA, GL_UNSIGNED_BYTE,
+						iter->image_.pixels()
+					));
+					iter->image_.clear();
+				}
+				iter->offset(atlas, space->x, space->y);
+			}
+		}
 		invalidated = false;
 	}
 	bool invalidated {};
 	std::set<material*> cache {};
 private:
+	struct relocation {
+		glm::ivec3 source {};
+		glm::ivec3 destination {};
+		glm::ivec2 dimensions {};
+	};
+	void relocate_(const std::vector<relocation>& relocations) {
+		// Old and new spaces can overlap, so every source is read before
+		// anything gets written
+		if (ogl::copy_image_available()) {
+			u32 staging = 0;
+			glCheck(glGenTextures(1, &staging));
+			glCheck(glBindTexture(GL_TEXTURE_2D_ARRAY, staging));
+			glCheck(glTexStorage3D(
+				GL_TEXTURE_2D_ARRAY,
+				DEFAULT_MIPMAP,
+				DEFAULT_FORMAT,
+				image_file::MAXIMUM_LENGTH,
+				image_file::MAXIMUM_LENGTH,
+				DEFAULT_LAYERS
+			));
+			for (auto&& move : relocations) {
+				glCheck(glCopyImageSubData(
+					handle_, GL_TEXTURE_2D_ARRAY, 0,
+					move.source.x, move.source.y, move.source.z,
+					staging, GL_TEXTURE_2D_ARRAY, 0,
+					move.source.x, move.source.y, move.source.z,
+					move.dimensions.x, move.dimensions.y, 1
+				));
+			}
+			for (auto&& move : relocations) {
+				glCheck(glCopyImageSubData(
+					staging, GL_TEXTURE_2D_ARRAY, 0,
+					move.source.x, move.source.y, move.source.z,
+					handle_, GL_TEXTURE_2D_ARRAY, 0,
+					move.destination.x, move.destination.y, move.destination.z,
+					move.dimensions.x, move.dimensions.y, 1
+				));
+			}
+			glCheck(glDeleteTextures(1, &staging));
+			// unit zero has to go back to sampling the atlas
+			glCheck(glBindTexture(GL_TEXTURE_2D_ARRAY, handle_));
+		} else {
+			// without copy_image, the atlas makes a short round trip through memory
+			constexpr udx LAYER_PIXELS =
+				static_cast<udx>(image_file::MAXIMUM_LENGTH) *
+				static_cast<udx>(image_file::MAXIMUM_LENGTH);
+			std::vector<chroma> pixels(LAYER_PIXELS * as<udx>(DEFAULT_LAYERS));
+			glCheck(glBindTexture(GL_TEXTURE_2D_ARRAY, handle_));
+			glCheck(glGetTexImage(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data()));
+			glCheck(glPixelStorei(GL_UNPACK_ROW_LENGTH, image_file::MAXIMUM_LENGTH));
+			for (auto&& move : relocations) {
+				const udx first =
+					as<udx>(move.source.z) * LAYER_PIXELS +
+					as<udx>(move.source.y) * as<udx>(image_file::MAXIMUM_LENGTH) +
+					as<udx>(move.source.x);
+				glCheck(glTexSubImage3D(
+					GL_TEXTURE_2D_ARRAY, 0,
+					move.destination.x, move.destination.y, move.destination.z,
+					move.dimensions.x, move.dimensions.y, 1,
+					GL_RGBA, GL_UNSIGNED_BYTE,
+					pixels.data() + first
+				));
+			}
+			glCheck(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+		}
+	}
 	std::array<virtual_texture_layer, DEFAULT_LAYERS> layers_ {};
 	u32 handle_ {};
 };
@@ -2,6 +2,8 @@
 
 #include "../util/image-file.hpp"
 
+struct virtual_texture;
+
 struct material : public not_copyable {
 	material() noexcept = default;
 	material(material&& that) noexcept {
@@ -60,14 +62,14 @@ public:
 		}
 		return {};
 	}
-	byte* pixels() { return image_.pixels(); }
-	const byte* pixels() const { return image_.pixels(); }
 	static i32 binding();
 	static bool recalibrate();
 private:
+	friend struct virtual_texture;
 	i32 id_ {};
 	i32 atlas_ {};
 	glm::ivec2 dimensions_ {};
 	glm::ivec2 offset_ {};
+	// only held until the next recalibration uploads it
 	image_file image_ {};
 };
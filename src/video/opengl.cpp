@@ -78,10 +78,18 @@ bool ogl::direct_state_available() noexcept {
 	return ogl::version >= ogl::context_type::v45;
 }
 
+bool ogl::timer_query_available() noexcept {
+	return ogl::version >= ogl::context_type::v33;
+}
+
 bool ogl::texture_storage_available() noexcept {
 	return ogl::binding_points_available();
 }
 
+bool ogl::copy_image_available() noexcept {
+	return ogl::version >= ogl::context_type::v43;
+}
+
 void ogl::check_errors(const char* path, u32 line, const char* expr) {
 	if (const auto code = glGetError(); code != GL_NO_ERROR) {
 		const char* error = "Unknown OpenGL error";
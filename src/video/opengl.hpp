@@ -28,6 +28,8 @@ namespace ogl {
 	bool buffer_storage_available() noexcept;
 	bool direct_state_available() noexcept;
 	bool texture_storage_available() noexcept;
+	bool copy_image_available() noexcept;
+	bool timer_query_available() noexcept;
 	void check_errors(const char* path, u32 line, const char* expr);
 	void APIENTRY debug_callback(
 		GLenum source,
@@ -6,6 +6,7 @@
 #include "./index-buffer.hpp"
 #include "./shader.hpp"
 #include "./opengl.hpp"
+#include "../util/memory-tracker.hpp"
 
 namespace {
 	constexpr udx MAXIMUM_SECTORS = 3;
@@ -16,6 +17,18 @@ quad_buffer::quad_buffer(const index_buffer& indices, const vertex_format& forma
 	length_ = INDICES_TO_VERTICES(indices.length());
 }
 
+quad_buffer::~quad_buffer() {
+	memory_tracker::release(memory_tag::renderer, staging_bytes_);
+	memory_tracker::release(memory_tag::buffers, resident_bytes_);
+}
+
+void quad_buffer::account(udx staging, udx resident) noexcept {
+	staging_bytes_ = staging;
+	resident_bytes_ = resident;
+	memory_tracker::acquire(memory_tag::renderer, staging_bytes_);
+	memory_tracker::acquire(memory_tag::buffers, resident_bytes_);
+}
+
 struct binding_quad_buffer : public quad_buffer {
 	binding_quad_buffer(const index_buffer& indices, const vertex_format& format) : quad_buffer{ indices, format } {
 		// allocated up here for exception safety since
@@ -53,6 +66,7 @@ struct binding_quad_buffer : public quad_buffer {
 		glCheck(glBindVertexArray(0));
 		glCheck(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
 		glCheck(glBindBuffer(GL_ARRAY_BUFFER, 0));
+		this->account(format_.size * length_, format_.size * length_);
 	}
 	virtual ~binding_quad_buffer() {
 		if (buffer_ != 0) {
@@ -68,6 +82,7 @@ public:
 			spdlog::error("Cannot draw quad buffer! Reason: Too many vertices");
 			return false;
 		}
+		uploaded_ = invalidated_ ? count * format_.size : 0;
 		if (invalidated_) {
 			glCheck(glBindBuffer(GL_ARRAY_BUFFER, buffer_));
 			glCheck(glBufferSubData(
@@ -85,15 +100,16 @@ public:
 			nullptr
 		));
 		invalidated_ = false;
+		this->invalidate();
 		return true;
 	}
 	bool valid() const noexcept override {
 		return true;
 	}
 protected:
-	char* staging(udx index) noexcept override {
+	char* staging() noexcept override {
 		invalidated_ = true;
-		return staging_.get() + (index * format_.size);
+		return staging_.get();
 	}
 private:
 	u32 handle_ {};
@@ -136,6 +152,8 @@ struct binding_quad_stream : public quad_buffer {
 		glCheck(glBindVertexArray(0));
 		glCheck(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
 		glCheck(glBindBuffer(GL_ARRAY_BUFFER, 0));
+		// the persistent mapping is the staging area
+		this->account(0, format_.size * length_ * MAXIMUM_SECTORS);
 	}
 	virtual ~binding_quad_stream() {
 		for (auto&& fence : fences_) {
@@ -160,6 +178,8 @@ public:
 			spdlog::error("Cannot draw quad buffer! Reason: Too many vertices");
 			return false;
 		}
+		// persistent mappings are written straight through every frame
+		uploaded_ = count * format_.size;
 		glCheck(glBindVertexArray(handle_));
 		program.bind();
 		glCheck(glDrawElementsBaseVertex(
@@ -175,13 +195,14 @@ public:
 		glCheck(fences_[sector_] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
 		sector_ = (sector_ + 1) % MAXIMUM_SECTORS;
 		flags_ = GL_SYNC_FLUSH_COMMANDS_BIT;
+		this->invalidate();
 		return true;
 	}
 	bool valid() const noexcept override {
 		return staging_ != nullptr;
 	}
 protected:
-	char* staging(udx index) noexcept override {
+	char* staging() noexcept override {
 		if (flags_ and fences_[sector_]) {
 			u32 result = GL_UNSIGNALED;
 			do {
@@ -190,8 +211,7 @@ protected:
 			} while (result != GL_CONDITION_SATISFIED and result != GL_ALREADY_SIGNALED);
 		}
 		return reinterpret_cast<char*>(staging_) +
-			(sector_ * length_ * format_.size) +
-			(index * format_.size);
+			(sector_ * length_ * format_.size);
 	}
 private:
 	u32 handle_ {};
@@ -229,6 +249,7 @@ struct direct_quad_buffer : public quad_buffer {
 		glCheck(glBindVertexArray(0));
 		glCheck(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
 		glCheck(glBindBuffer(GL_ARRAY_BUFFER, 0));
+		this->account(format_.size * length_, format_.size * length_);
 	}
 	virtual ~direct_quad_buffer() {
 		if (buffer_ != 0) {
@@ -244,6 +265,7 @@ public:
 			spdlog::error("Cannot draw quad buffer! Reason: Too many vertices");
 			return false;
 		}
+		uploaded_ = invalidated_ ? count * format_.size : 0;
 		if (invalidated_) {
 			glCheck(glNamedBufferSubData(
 				buffer_, 0,
@@ -260,15 +282,16 @@ public:
 			nullptr
 		));
 		invalidated_ = false;
+		this->invalidate();
 		return true;
 	}
 	bool valid() const noexcept override {
 		return true;
 	}
 protected:
-	char* staging(udx index) noexcept override {
+	char* staging() noexcept override {
 		invalidated_ = true;
-		return staging_.get() + (index * format_.size);
+		return staging_.get();
 	}
 private:
 	u32 handle_ {};
@@ -310,6 +333,7 @@ struct direct_quad_stream : public quad_buffer {
 		glCheck(glBindVertexArray(0));
 		glCheck(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
 		glCheck(glBindBuffer(GL_ARRAY_BUFFER, 0));
+		this->account(0, format_.size * length_ * MAXIMUM_SECTORS);
 	}
 	virtual ~direct_quad_stream() {
 		for (auto&& fence : fences_) {
@@ -332,6 +356,8 @@ struct direct_quad_stream : public quad_buffer {
 			spdlog::error("Cannot draw quad buffer! Reason: Too many vertices");
 			return false;
 		}
+		// persistent mappings are written straight through every frame
+		uploaded_ = count * format_.size;
 		glCheck(glBindVertexArray(handle_));
 		program.bind();
 		glCheck(glDrawElementsBaseVertex(
@@ -347,13 +373,14 @@ struct direct_quad_stream : public quad_buffer {
 		glCheck(fences_[sector_] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
 		sector_ = (sector_ + 1) % MAXIMUM_SECTORS;
 		flags_ = GL_SYNC_FLUSH_COMMANDS_BIT;
+		this->invalidate();
 		return true;
 	}
 	bool valid() const noexcept override {
 		return staging_ != nullptr;
 	}
 protected:
-	char* staging(udx index) noexcept override {
+	char* staging() noexcept override {
 		if (flags_ and fences_[sector_]) {
 			u32 result = GL_UNSIGNALED;
 			do {
@@ -362,8 +389,7 @@ protected:
 			} while (result != GL_CONDITION_SATISFIED and result != GL_ALREADY_SIGNALED);
 		}
 		return reinterpret_cast<char*>(staging_) +
-			(sector_ * length_ * format_.size) +
-			(index * format_.size);
+			(sector_ * length_ * format_.size);
 	}
 private:
 	u32 handle_ {};
@@ -385,7 +411,7 @@ std::unique_ptr<quad_buffer> quad_buffer::allocate(
 		spdlog::critical(message);
 		throw std::runtime_error(message);
 	}
-	if (!format.detail or format.size == 0) {
+	if (!format) {
 		static constexpr char message[] = "Cannot allocate quad buffer! Reason: Passed format is invalid!";
 		spdlog::critical(message);
 		throw std::runtime_error(message);
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <memory>
@@ -9,9 +10,30 @@
 struct index_buffer;
 struct shader_program;
 
+template<typename V>
+struct typed_quad_buffer {
+	static_assert(std::is_base_of<vtx_type, V>::value);
+public:
+	V* at(udx index) const noexcept {
+		assert(index < length);
+		return vertices + index;
+	}
+	template<typename A>
+	void copy(const std::vector<V, A>& source, udx index, udx count) const noexcept {
+		assert((index + count) <= length);
+#if defined(APOSTELLEIN_PLATFORM_WINDOWS)
+		std::memcpy(vertices + index, source.data(), count * sizeof(V));
+#else
+		std::copy(source.begin(), source.begin() + count, vertices + index);
+#endif
+	}
+	V* vertices {};
+	udx length {};
+};
+
 struct quad_buffer : public not_moveable {
 	quad_buffer(const index_buffer& indices, const vertex_format& format);
-	virtual ~quad_buffer() = default;
+	virtual ~quad_buffer();
 public:
 	static std::unique_ptr<quad_buffer> allocate(
 		const index_buffer& indices,
@@ -31,37 +53,31 @@ public:
 		const auto vertices = count * 4;
 		return VERTICES_TO_INDICES<T>(vertices);
 	}
+	// The format is checked once per batch instead of once per vertex, and the
+	// staging area is only looked up again after it gets drawn.
 	template<typename V>
-	V* at(udx index) {
-		static_assert(std::is_base_of<vtx_type, V>::value);
-		assert(format_.id == V::id());
-		assert(index < length_);
-		return reinterpret_cast<V*>(this->staging(index));
-	}
-	template<typename V>
-	void copy(const std::vector<V>& source, udx index, udx count) {
+	typed_quad_buffer<V> typed() noexcept {
 		static_assert(std::is_base_of<vtx_type, V>::value);
-		assert(format_.id == V::id());
-		assert((index + count) < length_);
-#if defined(APOSTELLEIN_PLATFORM_WINDOWS)
-		std::memcpy(
-			this->staging(index),
-			source.data(),
-			count * sizeof(V)
-		);
-#else
-		std::copy(
-			source.begin(),
-			source.begin() + count,
-			reinterpret_cast<V*>(this->staging(index))
-		);
-#endif
+		assert(format_ == vertex_format::of<V>());
+		if (!vertices_) {
+			vertices_ = this->staging();
+		}
+		return { reinterpret_cast<V*>(vertices_), length_ };
 	}
 	udx length() const { return length_; }
+	udx uploaded() const { return uploaded_; }
 	virtual bool draw(const shader_program& program, udx count) noexcept = 0;
 	virtual bool valid() const noexcept = 0;
 protected:
-	virtual char* staging(udx index) noexcept = 0;
+	virtual char* staging() noexcept = 0;
+	void account(udx staging, udx resident) noexcept;
+	// called after drawing, since that can move or invalidate the staging area
+	void invalidate() noexcept { vertices_ = nullptr; }
 	vertex_format format_ {};
 	udx length_ {};
+	udx uploaded_ {};
+private:
+	char* vertices_ {};
+	udx staging_bytes_ {};
+	udx resident_bytes_ {};
 };
@@ -0,0 +1,39 @@
+#include <apostellein/cast.hpp>
+
+#include "./timer-query.hpp"
+#include "./opengl.hpp"
+
+void timer_query::begin() {
+	if (handles_[0] == 0) {
+		glCheck(glGenQueries(as<i32>(handles_.size()), handles_.data()));
+	}
+	// collect whatever the other query measured last frame
+	const udx previous = current_ ^ 1;
+	if (pending_[previous]) {
+		i32 available = 0;
+		glCheck(glGetQueryObjectiv(handles_[previous], GL_QUERY_RESULT_AVAILABLE, &available));
+		if (available) {
+			u64 result = 0;
+			glCheck(glGetQueryObjectui64v(handles_[previous], GL_QUERY_RESULT, &result));
+			elapsed_ = as<i64>(result);
+			pending_[previous] = false;
+		}
+	}
+	glCheck(glBeginQuery(GL_TIME_ELAPSED, handles_[current_]));
+}
+
+void timer_query::end() {
+	glCheck(glEndQuery(GL_TIME_ELAPSED));
+	pending_[current_] = true;
+	current_ ^= 1;
+}
+
+void timer_query::destroy() {
+	if (handles_[0] != 0) {
+		glCheck(glDeleteQueries(as<i32>(handles_.size()), handles_.data()));
+		handles_ = {};
+	}
+	pending_ = {};
+	current_ = 0;
+	elapsed_ = 0;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <array>
+#include <utility>
+#include <apostellein/struct.hpp>
+
+// Double-buffered GL_TIME_ELAPSED query. Results are read a frame late so
+// the CPU never waits on the GPU to finish.
+struct timer_query : public not_copyable {
+	timer_query() noexcept = default;
+	timer_query(timer_query&& that) noexcept {
+		*this = std::move(that);
+	}
+	timer_query& operator=(timer_query&& that) noexcept {
+		if (this != &that) {
+			handles_ = that.handles_;
+			that.handles_ = {};
+			pending_ = that.pending_;
+			that.pending_ = {};
+			current_ = that.current_;
+			that.current_ = 0;
+			elapsed_ = that.elapsed_;
+			that.elapsed_ = 0;
+		}
+		return *this;
+	}
+	~timer_query() { this->destroy(); }
+public:
+	void begin();
+	void end();
+	void destroy();
+	i64 elapsed() const { return elapsed_; }
+private:
+	std::array<u32, 2> handles_ {};
+	std::array<bool, 2> pending_ {};
+	udx current_ {};
+	i64 elapsed_ {};
+};
@@ -9,21 +9,6 @@
 namespace {
 	constexpr u32 INVALID_VERTEX_FORMAT_ID = 0xFFFFFFFF;
 
-	template<typename A, typename B>
-	struct address_offset_calculator {
-		static constexpr B detail {};
-		static constexpr udx value(A B::*member) noexcept {
-			return
-				reinterpret_cast<udx>(&(address_offset_calculator<A, B>::detail.*member)) -
-				reinterpret_cast<udx>(&(address_offset_calculator<A, B>::detail));
-		}
-	};
-	template<typename A, typename B>
-	constexpr B address_offset_calculator<A, B>::detail;
-	template<typename A, typename B>
-	constexpr const void* ADDRESS_OFFSET(A B::*member) noexcept {
-		return reinterpret_cast<const void*>(address_offset_calculator<A, B>::value(member));
-	}
 	constexpr std::array LIGHT_TYPES {
 		as<u32>(GL_FLOAT_VEC2)
 	};
@@ -44,75 +29,53 @@ vertex_format vertex_format::none() {
 	vertex_format result {};
 	result.id = INVALID_VERTEX_FORMAT_ID;
 	result.size = 0;
-	result.detail = []{};
 	return result;
 }
 
-vertex_format vertex_format::from(u32 id) {
-	vertex_format result {};
-	if (id == vtx_light::id()) {
-		result.id = vtx_light::id();
-		result.size = sizeof(vtx_light);
-		result.detail = []() {
-			glCheck(glEnableVertexAttribArray(0));
-			glCheck(glVertexAttribPointer(
-				0, 2, GL_FLOAT,
-				GL_FALSE, sizeof(vtx_light),
-				ADDRESS_OFFSET(&vtx_light::position)
-			));
-		};
-	} else if (id == vtx_blank::id()) {
-		result.id = vtx_blank::id();
-		result.size = sizeof(vtx_blank);
-		result.detail = []() {
-			glCheck(glEnableVertexAttribArray(0));
-			glCheck(glEnableVertexAttribArray(1));
-			glCheck(glEnableVertexAttribArray(2));
-			glCheck(glVertexAttribPointer(
-				0, 2, GL_FLOAT,
-				GL_FALSE, sizeof(vtx_blank),
-				ADDRESS_OFFSET(&vtx_blank::position)
-			));
+void vertex_format::detail() const {
+	const auto stride = as<i32>(size);
+	for (udx idx = 0; idx < length; ++idx) {
+		const auto& attribute = attributes[idx];
+		const auto location = as<u32>(idx);
+		const auto offset = reinterpret_cast<const void*>(attribute.offset);
+		glCheck(glEnableVertexAttribArray(location));
+		switch (attribute.type) {
+		case attribute_type::integral:
 			glCheck(glVertexAttribIPointer(
-				1, 1, GL_INT,
-				sizeof(vtx_blank),
-				ADDRESS_OFFSET(&vtx_blank::index)
+				location, attribute.count, GL_INT,
+				stride, offset
 			));
+			break;
+		case attribute_type::normalized:
 			glCheck(glVertexAttribPointer(
-				2, 4, GL_UNSIGNED_BYTE,
-				GL_TRUE, sizeof(vtx_blank),
-				ADDRESS_OFFSET(&vtx_blank::color)
+				location, attribute.count, GL_UNSIGNED_BYTE,
+				GL_TRUE, stride, offset
 			));
-		};
-	} else if (id == vtx_sprite::id()) {
-		result.id = vtx_sprite::id();
-		result.size = sizeof(vtx_sprite);
-		result.detail = []() {
-			glCheck(glEnableVertexAttribArray(0));
-			glCheck(glEnableVertexAttribArray(1));
-			glCheck(glEnableVertexAttribArray(2));
-			glCheck(glEnableVertexAttribArray(3));
+			break;
+		default:
 			glCheck(glVertexAttribPointer(
-				0, 2, GL_FLOAT,
-				GL_FALSE, sizeof(vtx_sprite),
-				ADDRESS_OFFSET(&vtx_sprite::position)
-			));
-			glCheck(glVertexAttribIPointer(
-				1, 1, GL_INT,
-				sizeof(vtx_sprite),
-				ADDRESS_OFFSET(&vtx_sprite::index)
+				location, attribute.count, GL_FLOAT,
+				GL_FALSE, stride, offset
 			));
-			glCheck(glVertexAttribPointer(
-				2, 3, GL_FLOAT,
-				GL_FALSE, sizeof(vtx_sprite),
-				ADDRESS_OFFSET(&vtx_sprite::uvs)
-			));
-			glCheck(glVertexAttribPointer(
-				3, 4, GL_UNSIGNED_BYTE,
-				GL_TRUE, sizeof(vtx_sprite),
-				ADDRESS_OFFSET(&vtx_sprite::color)
-			));
-		};
+			break;
+		}
+	}
+}
+
+vertex_format vertex_format::from(u32 id) {
+	vertex_format result {};
+	switch (id) {
+	case vtx_light::id():
+		result = vertex_format::of<vtx_light>();
+		break;
+	case vtx_blank::id():
+		result = vertex_format::of<vtx_blank>();
+		break;
+	case vtx_sprite::id():
+		result = vertex_format::of<vtx_sprite>();
+		break;
+	default:
+		break;
 	}
 	if (!result) {
 		spdlog::critical("Vertex declaration was generated incorrectly!");
@@ -125,13 +88,13 @@ vertex_format vertex_format::from(const std::vector<u32>& types) {
 		return std::equal(lhv.begin(), lhv.end(), rhv.begin(), rhv.end());
 	};
 	if (compare(types, LIGHT_TYPES)) {
-		return vertex_format::from(vtx_light::id());
+		return vertex_format::of<vtx_light>();
 	}
 	else if (compare(types, BLANK_TYPES)) {
-		return vertex_format::from(vtx_blank::id());
+		return vertex_format::of<vtx_blank>();
 	}
 	else if (compare(types, SPRITE_TYPES)) {
-		return vertex_format::from(vtx_sprite::id());
+		return vertex_format::of<vtx_sprite>();
 	}
 	return {};
 }
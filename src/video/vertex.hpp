@@ -1,25 +1,45 @@
 #pragma once
 
+#include <array>
 #include <vector>
+#include <cstddef>
+#include <type_traits>
 #include <glm/vec2.hpp>
 #include <apostellein/struct.hpp>
 
+enum class attribute_type : u32 {
+	floating,
+	integral,
+	normalized
+};
+
+struct vertex_attribute {
+	attribute_type type {};
+	i32 count {};
+	udx offset {};
+public:
+	constexpr udx size() const noexcept {
+		if (type == attribute_type::normalized) {
+			return static_cast<udx>(count);
+		}
+		return static_cast<udx>(count) * 4;
+	}
+};
+
+// Specialized next to each vertex with its id and one attribute per location
+template<typename V>
+struct vertex_layout;
+
 struct vtx_type {
 	constexpr vtx_type() noexcept = default;
-protected:
-	static u32 generate_id() {
-		static u32 id_ = 0;
-		return ++id_;
-	}
 };
 
 template<typename V>
 struct vertex_template : public vtx_type {
 	constexpr vertex_template() noexcept = default;
 public:
-	static u32 id() {
-		static u32 id_ = vtx_type::generate_id();
-		return id_;
+	static constexpr u32 id() noexcept {
+		return vertex_layout<V>::ID;
 	}
 };
 
@@ -28,13 +48,15 @@ struct vertex_format {
 
 	u32 id {};
 	udx size {};
-	void(*detail)() {};
+	const vertex_attribute* attributes {};
+	udx length {};
 public:
 	constexpr operator bool() const {
 		return (
 			id > 0 and
 			size > 0 and
-			detail != nullptr
+			attributes != nullptr and
+			length > 0
 		);
 	}
 	constexpr bool operator==(const vertex_format& that) const {
@@ -43,9 +65,37 @@ public:
 	constexpr bool operator!=(const vertex_format& that) const {
 		return !(*this == that);
 	}
+	void detail() const;
+	template<typename V>
+	static constexpr vertex_format of() noexcept {
+		static_assert(std::is_base_of<vtx_type, V>::value);
+		static_assert(std::is_standard_layout<V>::value);
+		static_assert(
+			vertex_format::packed_<V>(),
+			"Vertex attributes have to cover every member in order!"
+		);
+		vertex_format result {};
+		result.id = V::id();
+		result.size = sizeof(V);
+		result.attributes = vertex_layout<V>::ATTRIBUTES.data();
+		result.length = vertex_layout<V>::ATTRIBUTES.size();
+		return result;
+	}
 	static vertex_format none();
 	static vertex_format from(u32 id);
 	static vertex_format from(const std::vector<u32>& types);
+private:
+	template<typename V>
+	static constexpr bool packed_() noexcept {
+		udx offset = 0;
+		for (auto&& attribute : vertex_layout<V>::ATTRIBUTES) {
+			if (attribute.offset != offset) {
+				return false;
+			}
+			offset += attribute.size();
+		}
+		return offset == sizeof(V);
+	}
 };
 
 struct vtx_light : public vertex_template<vtx_light> {
@@ -54,6 +104,14 @@ struct vtx_light : public vertex_template<vtx_light> {
 	glm::vec2 position {};
 };
 
+template<>
+struct vertex_layout<vtx_light> {
+	static constexpr u32 ID = 1;
+	static constexpr std::array ATTRIBUTES {
+		vertex_attribute{ attribute_type::floating, 2, offsetof(vtx_light, position) }
+	};
+};
+
 struct vtx_blank : public vertex_template<vtx_blank> {
 	constexpr vtx_blank() noexcept = default;
 
@@ -62,6 +120,16 @@ struct vtx_blank : public vertex_template<vtx_blank> {
 	chroma color { chroma::WHITE() };
 };
 
+template<>
+struct vertex_layout<vtx_blank> {
+	static constexpr u32 ID = 2;
+	static constexpr std::array ATTRIBUTES {
+		vertex_attribute{ attribute_type::floating, 2, offsetof(vtx_blank, position) },
+		vertex_attribute{ attribute_type::integral, 1, offsetof(vtx_blank, index) },
+		vertex_attribute{ attribute_type::normalized, 4, offsetof(vtx_blank, color) }
+	};
+};
+
 struct vtx_sprite : public vertex_template<vtx_sprite> {
 	constexpr vtx_sprite() noexcept = default;
 
@@ -71,3 +139,15 @@ struct vtx_sprite : public vertex_template<vtx_sprite> {
 	r32 atlas {};
 	chroma color { chroma::WHITE() };
 };
+
+template<>
+struct vertex_layout<vtx_sprite> {
+	static constexpr u32 ID = 3;
+	// uvs and atlas are read together as one vec3
+	static constexpr std::array ATTRIBUTES {
+		vertex_attribute{ attribute_type::floating, 2, offsetof(vtx_sprite, position) },
+		vertex_attribute{ attribute_type::integral, 1, offsetof(vtx_sprite, index) },
+		vertex_attribute{ attribute_type::floating, 3, offsetof(vtx_sprite, uvs) },
+		vertex_attribute{ attribute_type::normalized, 4, offsetof(vtx_sprite, color) }
+	};
+};
@@ -10,18 +10,6 @@
 #include "../hw/vfs.hpp"
 #include "../video/material.hpp"
 
-namespace {
-	constexpr char MATERIAL_ENTRY[] = "Material";
-	constexpr char ANIMATIONS_ENTRY[] = "Animations";
-	constexpr char STARTS_ENTRY[] = "starts";
-	constexpr char VKSIZE_ENTRY[] = "vksize";
-	constexpr char TDELAY_ENTRY[] = "tdelay";
-	constexpr char REPEAT_ENTRY[] = "repeat";
-	constexpr char REFLECT_ENTRY[] = "reflect";
-	constexpr char ACTION_ENTRY[] = "action";
-	constexpr char FRAMES_ENTRY[] = "frames";
-}
-
 animation_raster::animation_raster(const glm::vec2& position, const glm::vec2& dimensions) noexcept {
 	bounds = { position, dimensions };
 	points = {
@@ -78,19 +66,9 @@ animation_raster::animation_raster(const rect& quad, r32 angle, const glm::vec2&
 	};
 }
 
-void animation_sequence::append(const glm::vec2& action_point) {
-	action_points_.push_back(action_point);
-}
-
-void animation_sequence::append(const glm::vec2& start, const glm::vec4& points) {
-	const glm::vec2 position = start + (glm::vec2{ points[0], points[1] } * dimensions_);
-	const glm::vec2 origin { points[2], points[3] };
-	frames_.emplace_back(position, origin);
-}
-
 const animation_frame& animation_sequence::frame_with(udx frame, udx variation) const {
 	const auto idx = frame + (variation * count_);
-	if (idx < frames_.size()) {
+	if (idx < length_) {
 		return frames_[idx];
 	}
 	static const animation_frame NULL_FRAME {};
@@ -99,7 +77,7 @@ const animation_frame& animation_sequence::frame_with(udx frame, udx variation)
 
 rect animation_sequence::quad_with(udx frame, udx variation) const {
 	const auto idx = frame + (variation * count_);
-	if (idx < frames_.size()) {
+	if (idx < length_) {
 		return this->unsafe_quad_with(idx);
 	}
 	return {
@@ -123,7 +101,7 @@ animation_raster animation_sequence::raster_with(
 	const glm::vec2& position
 ) const {
 	const auto idx = frame + (variation * count_);
-	if (idx < frames_.size()) {
+	if (idx < length_) {
 		const glm::vec2 hotspot = position - this->unsafe_origin_with(idx, mirror) * scale;
 		return {
 			hotspot,
@@ -146,7 +124,7 @@ animation_raster animation_sequence::raster_with(
 	const glm::vec2& position
 ) const {
 	const auto idx = frame + (variation * count_);
-	if (idx < frames_.size()) {
+	if (idx < length_) {
 		const glm::vec2 hotspot = position - this->unsafe_origin_with(idx, mirror) * scale;
 		return {
 			{ hotspot, dimensions_ * scale },
@@ -162,7 +140,7 @@ animation_raster animation_sequence::raster_with(
 
 glm::vec2 animation_sequence::origin_with(udx frame, udx variation, const mirror_type& mirror) const {
 	const auto idx = frame + (variation * count_);
-	if (idx < frames_.size()) {
+	if (idx < length_) {
 		return this->unsafe_origin_with(idx, mirror);
 	}
 	return {};
@@ -182,7 +160,7 @@ glm::vec2 animation_sequence::unsafe_origin_with(udx idx, const mirror_type& mir
 }
 
 glm::vec2 animation_sequence::action_point_with(udx variation, const mirror_type& mirror) const {
-	if (variation < action_points_.size()) {
+	if (variation < actions_) {
 		glm::vec2 action_point = action_points_[variation];
 		if (mirror.horizontally) {
 			const auto center = dimensions_.x / 2.0f;
@@ -418,141 +396,32 @@ void animation_group::render(
 	}
 }
 
-void animation_group::load(const std::string& path) {
+void animation_group::load(animation_file file) {
 	if (!sequences_.empty()) {
 		spdlog::warn("Tried to overwrite animation!");
 		return;
 	}
-
-	const auto file = vfs::buffer_json(path);
-	if (file.empty()) {
-		spdlog::error("Failed to load animation from {}!", path);
+	if (!file.valid()) {
 		return;
 	}
-
-	glm::vec2 dimensions {};
-	if (file.contains(MATERIAL_ENTRY) and file[MATERIAL_ENTRY].is_string()) {
-		texture_ = vfs::find_material(file[MATERIAL_ENTRY].get<std::string>());
-		dimensions = texture_->dimensions();
+	if (!file.material().empty()) {
+		texture_ = vfs::find_material(file.material_id(), file.material());
 	}
-
-	for (auto&& anim : file[ANIMATIONS_ENTRY]) {
-		glm::vec2 starts {};
-		if (
-			anim.contains(STARTS_ENTRY) and
-			anim[STARTS_ENTRY].is_array() and
-			anim[STARTS_ENTRY].size() >= 2 and
-			anim[STARTS_ENTRY][0].is_number() and
-			anim[STARTS_ENTRY][1].is_number()
-		) {
-			starts = {
-				anim[STARTS_ENTRY][0].get<r32>(),
-				anim[STARTS_ENTRY][1].get<r32>()
-			};
-		}
-
-		glm::vec2 vksize {};
-		if (
-			anim.contains(VKSIZE_ENTRY) and
-			anim[VKSIZE_ENTRY].is_array() and
-			anim[VKSIZE_ENTRY].size() >= 2 and
-			anim[VKSIZE_ENTRY][0].is_number() and
-			anim[VKSIZE_ENTRY][1].is_number()
-		) {
-			vksize = {
-				anim[VKSIZE_ENTRY][0].get<r32>(),
-				anim[VKSIZE_ENTRY][1].get<r32>()
-			};
-			vksize = glm::abs(vksize);
-		}
-
-		r64 tdelay = 0.0;
-		if (
-			anim.contains(TDELAY_ENTRY) and
-			anim[TDELAY_ENTRY].is_number_float()
-		) {
-			tdelay = anim[TDELAY_ENTRY].get<r64>();
-			tdelay = glm::abs(tdelay);
-		}
-
-		bool repeat = true;
-		if (
-			anim.contains(REPEAT_ENTRY) and
-			anim[REPEAT_ENTRY].is_boolean()
-		) {
-			repeat = anim[REPEAT_ENTRY].get<bool>();
-		}
-
-		bool reflect = false;
-		if (
-			anim.contains(REFLECT_ENTRY) and
-			anim[REFLECT_ENTRY].is_boolean()
-		) {
-			reflect = anim[REFLECT_ENTRY].get<bool>();
-		}
-
-		udx predict = 0;
-		if (
-			anim.contains(FRAMES_ENTRY) and
-			anim[FRAMES_ENTRY].is_array() and
-			anim[FRAMES_ENTRY].size() > 0 and
-			anim[FRAMES_ENTRY][0].is_array()
-		) {
-			predict = anim[FRAMES_ENTRY][0].size();
-		}
-
-		if (predict == 0) {
-			spdlog::error("Failed to load animation frames from {}!", path);
-			return;
-		}
-
-		auto& sequence = sequences_.emplace_back(
-			vksize,
-			konst::SECONDS_TO_NANOSECONDS(tdelay),
-			predict,
-			repeat,
-			reflect
+	// sequences point into the frames, which stay put from here on
+	frames_ = file.release_frames();
+	action_points_ = file.release_action_points();
+	auto& headers = file.headers();
+	sequences_.reserve(headers.size());
+	udx frame = 0;
+	udx action = 0;
+	for (auto&& header : headers) {
+		sequences_.emplace_back(
+			header,
+			frames_.data() + frame,
+			action_points_.data() + action
 		);
-
-		if (
-			anim.contains(ACTION_ENTRY) and
-			anim[ACTION_ENTRY].is_array() and
-			anim[ACTION_ENTRY].size() > 0
-		) {
-			for (auto&& action : anim[ACTION_ENTRY]) {
-				glm::vec2 point {};
-				if (
-					action.is_array() and
-					action.size() >= 2 and
-					action[0].is_number() and
-					action[1].is_number()
-				) {
-					point = {
-						action[0].get<r32>(),
-						action[1].get<r32>()
-					};
-				}
-				sequence.append(point);
-			}
-		}
-
-		for (auto&& frames : anim[FRAMES_ENTRY]) {
-			for (auto&& rule : frames) {
-				glm::vec4 points {};
-				if (rule.is_array()) {
-					const glm::length_t total = glm::min(
-						points.length(),
-						as<glm::length_t>(rule.size())
-					);
-					for (glm::length_t idx = 0; idx < total; ++idx) {
-						if (rule[as<udx>(idx)].is_number()) {
-							points[idx] = rule[as<udx>(idx)].get<r32>();
-						}
-					}
-				}
-				sequence.append(starts, points);
-			}
-		}
+		frame += header.frames;
+		action += header.actions;
 	}
 }
 
@@ -7,21 +7,12 @@
 #include <apostellein/rect.hpp>
 #include <apostellein/struct.hpp>
 
+#include "../util/animation-file.hpp"
+
 struct mirror_type;
 struct material;
 struct renderer;
 
-struct animation_frame {
-	constexpr animation_frame() noexcept = default;
-	constexpr animation_frame(
-		const glm::vec2& _position,
-		const glm::vec2& _origin
-	) noexcept : position{ _position }, origin{ _origin } {}
-
-	glm::vec2 position {};
-	glm::vec2 origin {};
-};
-
 struct animation_raster {
 	animation_raster() noexcept = default;
 	animation_raster(
@@ -40,21 +31,33 @@ struct animation_raster {
 
 struct animation_sequence : public not_copyable {
 	animation_sequence() noexcept = default;
-	animation_sequence(const glm::vec2& dimensions, i64 delay, udx count, bool repeating, bool reflecting) noexcept :
-		dimensions_{ dimensions },
-		delay_{ delay },
-		count_{ count },
-		repeating_{ repeating },
-		reflecting_{ reflecting } {}
+	animation_sequence(
+		const animation_header& header,
+		const animation_frame* frames,
+		const glm::vec2* action_points
+	) noexcept :
+		frames_{ frames },
+		length_{ header.frames },
+		action_points_{ action_points },
+		actions_{ header.actions },
+		dimensions_{ header.dimensions },
+		delay_{ header.delay },
+		count_{ header.count },
+		repeating_{ (header.flags & animation_file::REPEATING) != 0 },
+		reflecting_{ (header.flags & animation_file::REFLECTING) != 0 } {}
 	animation_sequence(animation_sequence&& that) noexcept {
 		*this = std::move(that);
 	}
 	animation_sequence& operator=(animation_sequence&& that) noexcept {
 		if (this != &that) {
-			frames_ = std::move(that.frames_);
-			that.frames_.clear();
-			action_points_ = std::move(that.action_points_);
-			that.action_points_.clear();
+			frames_ = that.frames_;
+			that.frames_ = nullptr;
+			length_ = that.length_;
+			that.length_ = 0;
+			action_points_ = that.action_points_;
+			that.action_points_ = nullptr;
+			actions_ = that.actions_;
+			that.actions_ = 0;
 			dimensions_ = that.dimensions_;
 			that.dimensions_ = {};
 			delay_ = that.delay_;
@@ -70,8 +73,6 @@ struct animation_sequence : public not_copyable {
 	}
 	~animation_sequence() = default;
 public:
-	void append(const glm::vec2& action_point);
-	void append(const glm::vec2& start, const glm::vec4& points);
 	void update(i64 delta, i64& timer, udx& frame) const;
 	void update(i64 delta, bool& invalidated, i64& timer, udx& frame) const;
 	const animation_frame& frame_with(udx frame, udx variation) const;
@@ -99,8 +100,11 @@ public:
 	glm::vec2 action_point_with(udx variation, const mirror_type& mirror) const;
 	bool finished(udx frame, i64 timer) const;
 private:
-	std::vector<animation_frame> frames_ {};
-	std::vector<glm::vec2> action_points_ {};
+	// owned by the group
+	const animation_frame* frames_ {};
+	udx length_ {};
+	const glm::vec2* action_points_ {};
+	udx actions_ {};
 	glm::vec2 dimensions_ {};
 	i64 delay_ {};
 	udx count_ {};
@@ -117,6 +121,10 @@ struct animation_group : public not_copyable {
 		if (this != &that) {
 			sequences_ = std::move(that.sequences_);
 			that.sequences_.clear();
+			frames_ = std::move(that.frames_);
+			that.frames_.clear();
+			action_points_ = std::move(that.action_points_);
+			that.action_points_.clear();
 			texture_ = that.texture_;
 			that.texture_ = nullptr;
 		}
@@ -178,12 +186,14 @@ public:
 		const glm::vec2& position,
 		renderer& rdr
 	) const;
-	void load(const std::string& path);
+	void load(animation_file file);
 	bool finished(udx state, udx frame, i64 timer) const;
 	bool ready() const { return !sequences_.empty(); }
 	glm::vec2 origin(udx state, udx frame, udx variation, const mirror_type& mirror) const;
 	glm::vec2 action_point(udx state, udx variation, const mirror_type& mirror) const;
 private:
-	std::vector<animation_sequence> sequences_ {};
+	tracked_vector<animation_sequence, memory_tag::animations> sequences_ {};
+	animation_file::frame_vector frames_ {};
+	animation_file::point_vector action_points_ {};
 	const material* texture_ {};
 };
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cstring>
 #include <spdlog/spdlog.h>
 #include <glm/common.hpp>
@@ -34,6 +35,10 @@ namespace {
 	constexpr char SECOND_ENTRY[] = "-second";
 	constexpr char AMOUNT_ENTRY[] = "-amount";
 	constexpr char FILE_ENTRY[] = "-file";
+
+	constexpr u64 kerning_key_(char32_t first, char32_t second) noexcept {
+		return (static_cast<u64>(first) << 32) | static_cast<u64>(second);
+	}
 }
 
 void bitmap_font::load(const std::string& route, const std::string& path) {
@@ -78,7 +83,7 @@ void bitmap_font::load(const std::string& route, const std::string& path) {
 		return 0;
 	};
 
-	if (!glyphs_.empty()) {
+	if (!dense_.empty()) {
 		spdlog::warn("Tried to overwrite font!");
 		return;
 	}
@@ -115,6 +120,7 @@ void bitmap_font::load(const std::string& route, const std::string& path) {
 		font[CHARS_ENTRY][CHAR_ENTRY].is_array() and
 		font[CHARS_ENTRY][CHAR_ENTRY].size() > 0
 	) {
+		dense_.resize(DENSE_GLYPHS);
 		for (auto&& entry : font[CHARS_ENTRY][CHAR_ENTRY]) {
 			const char32_t code = parse_code(entry, ID_ENTRY);
 			const bitmap_glyph glyph {
@@ -127,7 +133,11 @@ void bitmap_font::load(const std::string& route, const std::string& path) {
 				parse_float(entry, X_ADVANCE_ENTRY),
 				parse_channel(entry, CHANNEL_ENTRY)
 			};
-			glyphs_[code] = glyph;
+			if (code < DENSE_GLYPHS) {
+				dense_[code] = glyph;
+			} else {
+				sparse_[code] = glyph;
+			}
 		}
 	} else {
 		spdlog::error("Glyph data missing in font from file \"{}\"!", path);
@@ -139,13 +149,26 @@ void bitmap_font::load(const std::string& route, const std::string& path) {
 		font[KERNINGS_ENTRY][KERNING_ENTRY].is_array() and
 		font[KERNINGS_ENTRY][KERNING_ENTRY].size() > 0
 	) {
+		kernings_.reserve(font[KERNINGS_ENTRY][KERNING_ENTRY].size());
 		for (auto&& entry : font[KERNINGS_ENTRY][KERNING_ENTRY]) {
-			const auto key = std::make_pair(
+			const u64 key = kerning_key_(
 				parse_code(entry, FIRST_ENTRY),
 				parse_code(entry, SECOND_ENTRY)
 			);
-			kernings_[key] = parse_float(entry, AMOUNT_ENTRY);
+			kernings_.emplace_back(key, parse_float(entry, AMOUNT_ENTRY));
+		}
+		std::stable_sort(kernings_.begin(), kernings_.end(), [](const auto& lhv, const auto& rhv) {
+			return lhv.first < rhv.first;
+		});
+		// later duplicates win, same as they used to
+		udx length = 0;
+		for (udx idx = 0; idx < kernings_.size(); ++idx) {
+			if (idx + 1 < kernings_.size() and kernings_[idx + 1].first == kernings_[idx].first) {
+				continue;
+			}
+			kernings_[length++] = kernings_[idx];
 		}
+		kernings_.resize(length);
 	}
 
 	if (
@@ -162,7 +185,8 @@ void bitmap_font::load(const std::string& route, const std::string& path) {
 }
 
 void bitmap_font::destroy() {
-	glyphs_.clear();
+	dense_.clear();
+	sparse_.clear();
 	kernings_.clear();
 	dimensions_ = {};
 	if (texture_) {
@@ -179,8 +203,15 @@ bool bitmap_font::valid() const {
 }
 
 const bitmap_glyph& bitmap_font::glyph(char32_t code_point) const {
-	auto iter = glyphs_.find(code_point);
-	if (iter == glyphs_.end()) {
+	if (code_point < DENSE_GLYPHS) {
+		// missing glyphs are zeroed, just like the null glyph
+		if (dense_.empty()) {
+			return NULL_GLYPH;
+		}
+		return dense_[code_point];
+	}
+	auto iter = sparse_.find(code_point);
+	if (iter == sparse_.end()) {
 		return NULL_GLYPH;
 	}
 	return iter->second;
@@ -190,8 +221,12 @@ r32 bitmap_font::kerning(char32_t first, char32_t second) const {
 	if (first == U'\0' or second == U'\0') {
 		return 0.0f;
 	}
-	auto iter = kernings_.find(std::make_pair(first, second));
-	if (iter == kernings_.end()) {
+	const u64 key = kerning_key_(first, second);
+	auto iter = std::lower_bound(
+		kernings_.begin(), kernings_.end(), key,
+		[](const auto& lhv, u64 rhv) { return lhv.first < rhv; }
+	);
+	if (iter == kernings_.end() or iter->first != key) {
 		return 0.0f;
 	}
 	return iter->second;
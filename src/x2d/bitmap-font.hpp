@@ -1,10 +1,11 @@
 #pragma once
 
 #include <string>
-#include <map>
 #include <glm/vec2.hpp>
 #include <apostellein/struct.hpp>
 
+#include "../util/memory-tracker.hpp"
+
 struct material;
 
 struct bitmap_glyph {
@@ -34,8 +35,10 @@ struct bitmap_font : public not_copyable {
 	}
 	bitmap_font& operator=(bitmap_font&& that) noexcept {
 		if (this != &that) {
-			glyphs_ = std::move(that.glyphs_);
-			that.glyphs_.clear();
+			dense_ = std::move(that.dense_);
+			that.dense_.clear();
+			sparse_ = std::move(that.sparse_);
+			that.sparse_.clear();
 			kernings_ = std::move(that.kernings_);
 			that.kernings_.clear();
 			dimensions_ = that.dimensions_;
@@ -47,6 +50,8 @@ struct bitmap_font : public not_copyable {
 	}
 	~bitmap_font() { this->destroy(); }
 public:
+	// code points below this are looked up directly
+	static constexpr char32_t DENSE_GLYPHS = 0x100;
 	void load(const std::string& route, const std::string& path);
 	void destroy();
 	bool valid() const;
@@ -57,8 +62,10 @@ public:
 	glm::vec2 texture_offset() const;
 	r32 atlas() const;
 private:
-	std::map<char32_t, bitmap_glyph> glyphs_ {};
-	std::map<std::pair<char32_t, char32_t>, r32> kernings_ {};
+	tracked_vector<bitmap_glyph, memory_tag::fonts> dense_ {};
+	tracked_unordered_map<char32_t, bitmap_glyph, memory_tag::fonts> sparse_ {};
+	// sorted by both code points packed into one key
+	tracked_vector<std::pair<u64, r32>, memory_tag::fonts> kernings_ {};
 	glm::vec2 dimensions_ {};
 	const material* texture_ {};
 };
@@ -22,7 +22,7 @@ void display_list::batch_blank(const rect& raster, const chroma& color) {
 
 	const auto index = priority_ == priority_type::deferred ? 0 : 1;
 
-	auto vtx = quads_->at<vtx_blank>(length_);
+	auto vtx = quads_->typed<vtx_blank>().at(length_);
 	vtx[0].position = raster.left_top();
 	vtx[0].index = index;
 	vtx[0].color = color;
@@ -51,7 +51,7 @@ void display_list::batch_sprite(
 	const glm::vec2 off = texture.offset();
 	const auto atlas = texture.atlas();
 
-	auto vtx = quads_->at<vtx_sprite>(length_);
+	auto vtx = quads_->typed<vtx_sprite>().at(length_);
 	vtx[0].position = position;
 	vtx[0].index = index;
 	vtx[0].uvs = (uvs.left_top() + off) / material::MAXIMUM_DIMENSIONS;
@@ -89,7 +89,7 @@ void display_list::batch_sprite(
 	const glm::vec2 off = texture.offset();
 	const auto atlas = texture.atlas();
 
-	auto vtx = quads_->at<vtx_sprite>(length_);
+	auto vtx = quads_->typed<vtx_sprite>().at(length_);
 	vtx[0].position = raster[0];
 	vtx[0].index = index;
 	vtx[0].uvs = (quad.left_top() + off) / material::MAXIMUM_DIMENSIONS;
@@ -134,11 +134,12 @@ void display_list::batch_parallax(
 	const glm::vec2 dim = raster / material::MAXIMUM_DIMENSIONS;
 	const glm::vec2 off = texture.offset() / material::MAXIMUM_DIMENSIONS;
 	const auto atlas = texture.atlas();
+	const auto quads = quads_->typed<vtx_sprite>();
 
 	udx idx = 0;
 	for (r32 y = view.y + shift.y - raster.y; y < view.bottom(); y += raster.y) {
 		for (r32 x = view.x + shift.x - raster.x; x < view.right(); x += raster.x) {
-			auto vtx = quads_->at<vtx_sprite>(length_ + idx);
+			auto vtx = quads.at(length_ + idx);
 			vtx[0].position = { x, y };
 			vtx[0].index = 1;
 			vtx[0].uvs = off;
@@ -170,11 +171,21 @@ void display_list::skip(udx count) {
 	stored_ = 0;
 }
 
-void display_list::flush(const shader_program& program) {
+void display_list::flush(const shader_program& program, bool timing) {
 	visible_ = length_ > 0;
+	stats_.quads = length_ / display_list::QUAD;
+	stats_.bytes = 0;
 	if (visible_) {
-		quads_->draw(program, length_);
+		if (timing) {
+			timer_.begin();
+			quads_->draw(program, length_);
+			timer_.end();
+		} else {
+			quads_->draw(program, length_);
+		}
+		stats_.bytes = quads_->uploaded();
 	}
+	stats_.elapsed = timing ? timer_.elapsed() : 0;
 	length_ = 0;
 }
 
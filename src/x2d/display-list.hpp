@@ -7,6 +7,7 @@
 #include "./priority-type.hpp"
 #include "../video/quad-buffer.hpp"
 #include "../video/blending-type.hpp"
+#include "../video/timer-query.hpp"
 
 struct material;
 struct mirror_type;
@@ -47,11 +48,19 @@ struct display_list : public not_copyable {
 			that.blending_ = blending_type::alpha;
 			pipeline_ = that.pipeline_;
 			that.pipeline_ = pipeline_type::sprite;
+			stats_ = that.stats_;
+			that.stats_ = {};
+			timer_ = std::move(that.timer_);
 		}
 		return *this;
 	}
 	~display_list() = default;
 public:
+	struct stats_type {
+		udx quads {};
+		udx bytes {};
+		i64 elapsed {};
+	};
 	static constexpr udx QUAD = 4;
 	void batch_blank(const rect& raster,const chroma& color);
 	void batch_sprite(
@@ -85,21 +94,21 @@ public:
 		const glm::vec2& raster,
 		const material& texture
 	);
-	template<typename V>
-	void upload(const std::vector<V>& vertices, udx count) {
+	template<typename V, typename A>
+	void upload(const std::vector<V, A>& vertices, udx count) {
 		static_assert(std::is_base_of<vtx_type, V>::value);
 		this->batch_begin_(count);
 		if (stored_ > 0) {
-			quads_->copy<V>(vertices, length_, count);
+			quads_->typed<V>().copy(vertices, length_, count);
 		}
 		this->batch_end_();
 	}
-	template<typename V>
-	void upload(const std::vector<V>& vertices) {
-		this->upload<V>(vertices, vertices.size());
+	template<typename V, typename A>
+	void upload(const std::vector<V, A>& vertices) {
+		this->upload(vertices, vertices.size());
 	}
 	void skip(udx count);
-	void flush(const shader_program& program);
+	void flush(const shader_program& program, bool timing);
 	bool visible() const {
 		if (length_ > 0) {
 			return true;
@@ -125,6 +134,7 @@ public:
 	const priority_type& priority() const { return priority_; }
 	const blending_type& blending() const { return blending_; }
 	const pipeline_type& pipeline() const { return pipeline_; }
+	const stats_type& stats() const { return stats_; }
 private:
 	void batch_begin_(udx count);
 	void batch_end_();
@@ -135,4 +145,6 @@ private:
 	priority_type priority_ { priority_type::automatic };
 	blending_type blending_ { blending_type::alpha };
 	pipeline_type pipeline_ { pipeline_type::sprite };
+	stats_type stats_ {};
+	timer_query timer_ {};
 };
@@ -10,6 +10,7 @@
 #include "../video/opengl.hpp"
 #include "../video/material.hpp"
 #include "../video/swap-chain.hpp"
+#include "../util/profiler.hpp"
 
 namespace {
 	constexpr udx MAXIMUM_QUADS = quad_buffer::QUADS_TO_INDICES(1024);
@@ -158,13 +159,16 @@ bool renderer::build() {
 }
 
 void renderer::flush(const glm::mat4& viewport) {
+	APOSTELLEIN_ZONE("renderer::flush");
 	swap_chain::clear(chroma::TRANSLUCENT());
+	stats_ = {};
 
 	matrices_.viewport(viewport);
 
 	for (auto&& list : lists_) {
 		if (list.visible()) {
 			if (blending_ != list.blending()) {
+				++stats_.blends;
 				switch (blending_ = list.blending(); blending_) {
 				case blending_type::alpha: {
 					glCheck(glBlendFuncSeparate(
@@ -198,11 +202,22 @@ void renderer::flush(const glm::mat4& viewport) {
 				}
 			}
 			const auto index = as<udx>(list.pipeline());
-			list.flush(programs_[index]);
+			list.flush(programs_[index], timing_);
+			if (list.visible()) {
+				auto& stats = list.stats();
+				++stats_.draws;
+				stats_.quads += stats.quads;
+				stats_.bytes += stats.bytes;
+				stats_.elapsed += stats.elapsed;
+			}
 		}
 	}
 }
 
+void renderer::measure(bool value) {
+	timing_ = value and ogl::timer_query_available();
+}
+
 display_list& renderer::query(priority_type priority, blending_type blending, pipeline_type pipeline) {
 	for (auto&& list : lists_) {
 		if (list.matches(priority, blending, pipeline)) {
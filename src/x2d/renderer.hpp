@@ -7,20 +7,35 @@
 #include "../video/light-buffer.hpp"
 #include "../video/index-buffer.hpp"
 #include "../video/shader.hpp"
+#include "../util/memory-tracker.hpp"
 
 struct renderer {
 public:
+	using list_vector = tracked_vector<display_list, memory_tag::renderer>;
+	struct stats_type {
+		udx draws {};
+		udx quads {};
+		udx blends {};
+		udx bytes {};
+		i64 elapsed {};
+	};
 	bool build();
 	void clear() { lists_.clear(); }
 	void flush(const glm::mat4& viewport);
 	display_list& query(priority_type priority, blending_type blending, pipeline_type pipeline);
 	udx all_lists() const { return lists_.size(); }
 	udx visible_lists() const;
+	const list_vector& lists() const { return lists_; }
+	const stats_type& stats() const { return stats_; }
+	void measure(bool value);
+	bool measuring() const { return timing_; }
 private:
 	matrix_buffer matrices_ {};
 	// light_buffer lights_ {};
 	blending_type blending_ { blending_type::alpha };
 	std::vector<shader_program> programs_ {};
-	std::vector<display_list> lists_ {};
+	list_vector lists_ {};
 	index_buffer indices_ {};
+	stats_type stats_ {};
+	bool timing_ {};
 };
@@ -1,20 +1,13 @@
-#include <spdlog/spdlog.h>
-#include <tmxlite/Map.hpp>
-#include <tmxlite/TileLayer.hpp>
-#include <tmxlite/ImageLayer.hpp>
 #include <apostellein/konst.hpp>
 #include <apostellein/cast.hpp>
 
 #include "./tile-map.hpp"
 #include "./renderer.hpp"
 #include "../hw/vfs.hpp"
+#include "../util/field-file.hpp"
 #include "../video/material.hpp"
 
 namespace {
-	constexpr char COLLIDABLE_PROPERTY[] = "collide";
-	constexpr char PRIORITY_PROPERTY[] = "priority";
-	constexpr char SCROLL_X_PROPERTY[] = "scroll.x";
-	constexpr char SCROLL_Y_PROPERTY[] = "scroll.y";
 	constexpr i32 SCREEN_WIDTH = (konst::WINDOW_WIDTH<i32>() / konst::TILE<i32>()) + 1;
 	constexpr i32 SCREEN_HEIGHT = (konst::WINDOW_HEIGHT<i32>() / konst::TILE<i32>()) + 1;
 	constexpr glm::ivec2 INVALID_TILE { ~0 };
@@ -35,31 +28,17 @@ tile_layer::tile_layer(const glm::ivec2& dimensions) {
 	);
 }
 
-void tile_layer::build(const tmx::TileLayer& data, std::vector<u32>& attributes, const std::vector<u32>& key) {
-	for (auto&& prop : data.getProperties()) {
-		auto& name = prop.getName();
-		if (name == COLLIDABLE_PROPERTY) {
-			if (tmx_convert::prop_to_bool(prop)) {
-				collidable_ = true;
-				foreground_ = true;
-			}
-		} else if (name == PRIORITY_PROPERTY) {
-			foreground_ = tmx_convert::prop_to_bool(prop);
-		}
-	}
+void tile_layer::build(const field_tiles& data) {
+	collidable_ = data.collidable;
+	foreground_ = data.foreground;
 
-	auto& array = data.getTiles();
-	attributes.resize(array.size());
-
-	for (udx idx = 0; idx < array.size(); ++idx) {
-		if (const auto type = as<i32>(array[idx].ID) - 1; type >= 0) {
+	const udx length = glm::min(data.indices.size(), tiles_.size());
+	for (udx idx = 0; idx < length; ++idx) {
+		if (const auto type = data.indices[idx]; type >= 0) {
 			tiles_[idx] = {
 				type % konst::TILE<i32>(),
 				type / konst::TILE<i32>()
 			};
-			if (collidable_) {
-				attributes[idx]  = key[as<udx>(type)];
-			}
 		} else {
 			tiles_[idx] = INVALID_TILE;
 		}
@@ -139,15 +118,8 @@ void tile_layer::render(renderer& rdr) const {
 	list.upload(vertices_, indices_ * display_list::QUAD);
 }
 
-void tile_parallax::build(const tmx::ImageLayer& data, const material* background) {
-	for (auto&& prop : data.getProperties()) {
-		auto& name = prop.getName();
-		if (name == SCROLL_X_PROPERTY) {
-			scrolling_.x = tmx_convert::prop_to_real(prop);
-		} else if (name == SCROLL_Y_PROPERTY) {
-			scrolling_.y = tmx_convert::prop_to_real(prop);
-		}
-	}
+void tile_parallax::build(const field_parallax& data, const material* background) {
+	scrolling_ = data.scrolling;
 	if (background) {
 		background_ = background;
 		raster_ = background->dimensions();
@@ -155,17 +127,15 @@ void tile_parallax::build(const tmx::ImageLayer& data, const material* backgroun
 }
 
 void tile_parallax::prepare() {
-	previous_ = current_;
+	history_.prepare();
 }
 
 void tile_parallax::handle(const rect& view) {
-	const glm::vec2 next = glm::mod(
+	// wrapping around the raster moves further than a tile, so it never gets smeared
+	history_.push(glm::mod(
 		view.position() * -scrolling_,
 		raster_
-	);
-	if (current_ != next) {
-		current_ = next;
-	}
+	));
 }
 
 void tile_parallax::render(r32 ratio, const rect& view, renderer& rdr) const {
@@ -175,11 +145,7 @@ void tile_parallax::render(r32 ratio, const rect& view, renderer& rdr) const {
 			blending_type::alpha,
 			pipeline_type::sprite
 		);
-		const glm::vec2 position = konst::INTERPOLATE(
-			previous_,
-			current_,
-			ratio
-		);
+		const glm::vec2 position = history_.at(ratio);
 		list.batch_parallax(view, position, raster_, *background_);
 	}
 }
@@ -188,15 +154,15 @@ void tile_map::clear() {
 	invalidated_ = true;
 	dimensions_ = {};
 	attributes_.clear();
-	key_.clear();
 	previous_ = {};
 	texture_ = nullptr;
 	parallaxes_.clear();
 	layers_.clear();
 }
 
-void tile_map::load_properties(const tmx::Map& data, const rect& bounds) {
+void tile_map::load(const field_file& data) {
 	invalidated_ = true;
+	const rect& bounds = data.bounds();
 	dimensions_ = {
 		glm::max(
 			as<i32>(bounds.w) / konst::TILE<i32>(),
@@ -207,35 +173,18 @@ void tile_map::load_properties(const tmx::Map& data, const rect& bounds) {
 			SCREEN_HEIGHT
 		)
 	};
-	auto& tilesets = data.getTilesets();
-	if (!tilesets.empty()) {
-		const std::string name = tmx_convert::path_to_name(tilesets[0].getImagePath());
-		texture_ = vfs::find_material(name);
-
-		const std::string path = vfs::key_path(name);
-		key_ = vfs::buffer_uints(path);
+	if (!data.texture().empty()) {
+		texture_ = vfs::find_material(data.texture());
 	}
-}
-
-void tile_map::load_tiles(const tmx::TileLayer& data) {
-	invalidated_ = true;
-
-	if (!key_.empty()) {
+	attributes_.assign(data.attributes().begin(), data.attributes().end());
+	for (auto&& tiles : data.layers()) {
 		auto& recent = layers_.emplace_back(dimensions_);
-		recent.build(data, attributes_, key_);
-	} else {
-		spdlog::warn("Can't load any tiles without loading tile attribute key!");
+		recent.build(tiles);
+	}
+	for (auto&& pllx : data.parallaxes()) {
+		auto& recent = parallaxes_.emplace_back();
+		recent.build(pllx, vfs::find_material(pllx.image));
 	}
-}
-
-void tile_map::load_parallax(const tmx::ImageLayer& data) {
-	invalidated_ = true;
-
-	const std::string name = tmx_convert::path_to_name(data.getImagePath());
-	auto background_ = vfs::find_material(name);
-
-	auto& recent = parallaxes_.emplace_back();
-	recent.build(data, background_);
 }
 
 void tile_map::prepare() {
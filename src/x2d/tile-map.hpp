@@ -1,15 +1,20 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 #include <apostellein/rect.hpp>
 
 #include "./priority-type.hpp"
 #include "./tile-type.hpp"
-#include "../util/tmx-convert.hpp"
+#include "./transform-history.hpp"
 #include "../video/vertex.hpp"
+#include "../util/memory-tracker.hpp"
 
 struct material;
 struct renderer;
+struct field_file;
+struct field_tiles;
+struct field_parallax;
 
 struct tile_layer : public not_copyable {
 	tile_layer() noexcept = default;
@@ -33,7 +38,7 @@ struct tile_layer : public not_copyable {
 		return *this;
 	}
 public:
-	void build(const tmx::TileLayer& data, std::vector<u32>& attributes, const std::vector<u32>& key);
+	void build(const field_tiles& data);
 	void handle(const glm::ivec2& first, const glm::ivec2& last, const glm::ivec2& dimensions, const material* texture);
 	void render(renderer& rdr) const;
 	bool foreground() const { return foreground_; }
@@ -41,8 +46,8 @@ private:
 	bool collidable_ {};
 	bool foreground_ {};
 	udx indices_ {};
-	std::vector<glm::ivec2> tiles_ {};
-	std::vector<vtx_sprite> vertices_ {};
+	tracked_vector<glm::ivec2, memory_tag::tiles> tiles_ {};
+	tracked_vector<vtx_sprite, memory_tag::tiles> vertices_ {};
 };
 
 struct tile_parallax : public not_copyable {
@@ -52,10 +57,8 @@ struct tile_parallax : public not_copyable {
 	}
 	tile_parallax& operator=(tile_parallax&& that) noexcept {
 		if (this != &that) {
-			previous_ = that.previous_;
-			that.previous_ = {};
-			current_ = that.current_;
-			that.current_ = {};
+			history_ = that.history_;
+			that.history_ = {};
 			scrolling_ = that.scrolling_;
 			that.scrolling_ = {};
 			raster_ = that.raster_;
@@ -66,13 +69,12 @@ struct tile_parallax : public not_copyable {
 		return *this;
 	}
 public:
-	void build(const tmx::ImageLayer& data, const material* background);
+	void build(const field_parallax& data, const material* background);
 	void prepare();
 	void handle(const rect& view);
 	void render(r32 ratio, const rect& view, renderer& rdr) const;
 private:
-	glm::vec2 previous_ {};
-	glm::vec2 current_ {};
+	transform_history history_ {};
 	glm::vec2 scrolling_ {};
 	glm::vec2 raster_ {};
 	const material* background_ {};
@@ -80,9 +82,7 @@ private:
 
 struct tile_map {
 public:
-	void load_properties(const tmx::Map& data, const rect& bounds);
-	void load_tiles(const tmx::TileLayer& data);
-	void load_parallax(const tmx::ImageLayer& data);
+	void load(const field_file& data);
 	void clear();
 	void fix() { this->handle(previous_, true); }
 	void prepare();
@@ -97,8 +97,7 @@ public:
 private:
 	bool invalidated_ {};
 	glm::ivec2 dimensions_ {};
-	std::vector<u32> attributes_ {};
-	std::vector<u32> key_ {};
+	tracked_vector<u32, memory_tag::tiles> attributes_ {};
 	rect previous_ {};
 	const material* texture_ {};
 	std::vector<tile_parallax> parallaxes_ {};
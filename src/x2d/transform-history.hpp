@@ -0,0 +1,50 @@
+#pragma once
+
+#include <glm/vec2.hpp>
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <apostellein/konst.hpp>
+#include <apostellein/cast.hpp>
+
+// Filled once per tick and read once per frame. Kept trivially copyable so that
+// owners can snapshot it alongside the rest of their state.
+struct transform_history {
+public:
+	constexpr transform_history() noexcept = default;
+	constexpr transform_history(const glm::vec2& position) noexcept :
+		previous_{ position },
+		current_{ position } {}
+public:
+	void prepare() {
+		previous_ = current_;
+		ticks_ = 0;
+	}
+	void push(const glm::vec2& position) {
+		current_ = position;
+		++ticks_;
+	}
+	void reset(const glm::vec2& position) {
+		previous_ = position;
+		current_ = position;
+		ticks_ = 0;
+	}
+	glm::vec2 at(r32 ratio) const {
+		if (previous_ == current_) {
+			return current_;
+		}
+		// several ticks can run in one frame, so only treat motion faster than
+		// a tile per tick as a teleport
+		const r32 span = konst::TILE<r32>() * as<r32>(ticks_ > 1 ? ticks_ : 1);
+		if (glm::distance(previous_, current_) >= span) {
+			return current_;
+		}
+		// ratios above one extrapolate along the last frame's motion
+		return glm::mix(previous_, current_, ratio);
+	}
+	const glm::vec2& previous() const { return previous_; }
+	const glm::vec2& current() const { return current_; }
+private:
+	glm::vec2 previous_ {};
+	glm::vec2 current_ {};
+	u32 ticks_ {};
+};